@@ -0,0 +1,90 @@
+#pragma once
+
+//std
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <limits>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Minimal benchmark harness: suites register themselves with BENCH_SUITE,
+ *        main() runs all of them or the ones named on the command line
+ */
+namespace bench
+{
+    using Suite = void(*)();
+
+    inline std::vector<std::pair<const char*, Suite>>& suites()
+    {
+        static std::vector<std::pair<const char*, Suite>> registered{};
+        return registered;
+    }
+
+    struct Register
+    {
+        Register(const char *name, Suite suite) { suites().emplace_back(name, suite); }
+    };
+
+    /**
+     * @brief Best wall time of repeats runs, after one warm up run
+     *
+     * @return milliseconds
+     */
+    template<typename F>
+    double measure(int repeats, F &&fn)
+    {
+        fn();
+        double best = std::numeric_limits<double>::max();
+        for(int i = 0; i < repeats; i++){
+            auto start = std::chrono::steady_clock::now();
+            fn();
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            best = std::min(best, elapsed.count());
+        }
+        return best;
+    }
+
+    // keep the optimizer from removing a computed value
+    template<typename T>
+    void doNotOptimize(T const &value)
+    {
+    #if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+    #else
+        static volatile const T *sink = nullptr;
+        sink = &value;
+    #endif
+    }
+
+    inline void header(const char *suite)
+    {
+        std::printf("\n%s\n", suite);
+        std::printf("%-28s %-14s %12s %10s %14s\n", "workload", "method", "ms", "speedup", "items/s");
+    }
+
+    /**
+     * @brief Print one row, speedup is relative to baselineMs
+     *
+     * @param items elements processed by one run, 0 to leave the throughput out
+     */
+    inline void report(const char *workload, const char *method, double ms, double baselineMs, size_t items = 0)
+    {
+        std::printf("%-28s %-14s %12.3f %9.2fx", workload, method, ms, baselineMs / ms);
+        if(items){
+            std::printf(" %14.3e", static_cast<double>(items) * 1000.0 / ms);
+        }
+        std::printf("\n");
+    }
+
+} // namespace bench
+
+#define BENCH_CONCAT_(a, b) a##b
+#define BENCH_CONCAT(a, b) BENCH_CONCAT_(a, b)
+
+#define BENCH_SUITE(name)                                                       \
+    static void name();                                                         \
+    static bench::Register BENCH_CONCAT(name, _register){#name, name};          \
+    static void name()
@@ -0,0 +1,98 @@
+#include "bench.hpp"
+// common lib
+#include <archetype.hpp>
+#include <bounds.hpp>
+#include <simd_transform.hpp>
+//lib
+#include <glm/glm.hpp>
+//std
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // stand-in of the gpu buffers held by a renderable
+    struct GpuHandles
+    {
+        std::array<uint64_t, 8> handles{};
+    };
+
+    // renderable with every field in one heap object, as before the component columns
+    struct Object
+    {
+        GpuHandles gpu{};
+        std::string shader{};
+        std::string name{};
+        uint32_t meshNode{0};
+        ngn::Sphere localSphere{};
+        ngn::Sphere worldSphere{};
+    };
+
+    struct MeshNode
+    {
+        uint32_t index{0};
+    };
+
+    struct LocalSphere
+    {
+        ngn::Sphere sphere{};
+    };
+
+    using Table = ngn::Archetype<GpuHandles, std::string, MeshNode, LocalSphere, ngn::Sphere>;
+}
+
+BENCH_SUITE(archetype)
+{
+    const size_t OBJECTS = 100000;
+    const int REPEATS = 20;
+
+    bench::header("archetype");
+
+    std::mt19937 rng{42};
+    std::uniform_real_distribution<float> dist{-10.f, 10.f};
+
+    std::vector<glm::mat4> worlds(OBJECTS);
+    for(auto &world : worlds){
+        world = glm::mat4(1.0f);
+        world[3] = glm::vec4(dist(rng), dist(rng), dist(rng), 1.0f);
+    }
+
+    std::vector<std::unique_ptr<Object>> objects{};
+    Table table{};
+    table.reserve(OBJECTS);
+    for(size_t i = 0; i < OBJECTS; i++){
+        auto object = std::make_unique<Object>();
+        object->shader = "phong";
+        object->name = "object number " + std::to_string(i);
+        object->meshNode = static_cast<uint32_t>(i);
+        object->localSphere = {{dist(rng), dist(rng), dist(rng)}, 1.0f};
+        table.create({}, object->name, {object->meshNode}, {object->localSphere}, object->localSphere);
+        objects.push_back(std::move(object));
+    }
+    // spawn and destroy leave the heap objects scattered
+    std::shuffle(objects.begin(), objects.end(), rng);
+
+    // world bounds of every object, as done by Engine::updateBounds
+    double heap = bench::measure(REPEATS, [&]{
+        for(auto &object : objects){
+            ngn::simd::transformSpheres(&worlds[object->meshNode], &object->localSphere, &object->worldSphere, 1);
+        }
+    });
+    double columns = bench::measure(REPEATS, [&]{
+        const auto nodes = table.column<MeshNode>();
+        const auto local = table.column<LocalSphere>();
+        const auto world = table.column<ngn::Sphere>();
+        for(size_t i = 0; i < nodes.size(); i++){
+            ngn::simd::transformSpheres(&worlds[nodes[i].index], &local[i].sphere, &world[i], 1);
+        }
+    });
+
+    bench::report("bounds 100k", "heap objects", heap, heap, OBJECTS);
+    bench::report("bounds 100k", "columns", columns, heap, OBJECTS);
+    bench::doNotOptimize(objects[OBJECTS / 2]->worldSphere);
+    bench::doNotOptimize(table.column<ngn::Sphere>()[OBJECTS / 2]);
+}
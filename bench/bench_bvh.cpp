@@ -0,0 +1,130 @@
+#include "bench.hpp"
+// common lib
+#include <bvh.hpp>
+//lib
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+//std
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+    // unit boxes at constant density: the scene grows with the object count
+    std::vector<ngn::Aabb> makeScene(size_t count, float &halfSize)
+    {
+        halfSize = 2.0f * std::cbrt(static_cast<float>(count));
+        std::mt19937 rng{42};
+        std::uniform_real_distribution<float> position{-halfSize, halfSize};
+        std::uniform_real_distribution<float> size{0.2f, 1.0f};
+
+        std::vector<ngn::Aabb> boxes(count);
+        for(auto &box : boxes){
+            const glm::vec3 p{position(rng), position(rng), position(rng)};
+            box = ngn::Aabb{p, p + glm::vec3(size(rng))};
+        }
+        return boxes;
+    }
+
+    void run(size_t count, const char *label)
+    {
+        const int REPEATS = count >= 1000000 ? 3 : 10;
+        char workload[64];
+
+        float halfSize = 0.0f;
+        std::vector<ngn::Aabb> boxes = makeScene(count, halfSize);
+        ngn::Bvh bvh{};
+
+        double buildMs = bench::measure(REPEATS, [&]{ bvh.build(boxes.data(), boxes.size()); });
+        std::snprintf(workload, sizeof(workload), "build %s", label);
+        bench::report(workload, "binned sah", buildMs, buildMs, count);
+
+        // one percent of the objects moves every frame
+        std::vector<uint32_t> moved{};
+        for(uint32_t i = 0; i < count; i += 100){
+            moved.push_back(i);
+        }
+        float offset = 0.01f;
+        double refitMs = bench::measure(REPEATS, [&]{
+            offset = -offset;
+            for(uint32_t item : moved){
+                boxes[item].min.x += offset;
+                boxes[item].max.x += offset;
+            }
+            bvh.refit(boxes.data(), moved.data(), moved.size());
+        });
+        double fullRefitMs = bench::measure(REPEATS, [&]{ bvh.refit(boxes.data()); });
+        std::snprintf(workload, sizeof(workload), "refit 1%% %s", label);
+        bench::report(workload, "rebuild", buildMs, buildMs, moved.size());
+        bench::report(workload, "full refit", fullRefitMs, buildMs, moved.size());
+        bench::report(workload, "incremental", refitMs, buildMs, moved.size());
+
+        // camera on the edge of the scene looking at its center, about a third is visible
+        const glm::vec3 eye{0.0f, 0.0f, halfSize * 1.5f};
+        glm::mat4 view = glm::lookAt(eye, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        glm::mat4 proj = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 1.0f, halfSize * 2.0f);
+        const ngn::Frustum frustum = ngn::Frustum::fromMatrix(proj * view);
+
+        std::vector<uint32_t> visible{};
+        visible.reserve(count);
+        double linearMs = bench::measure(REPEATS, [&]{
+            visible.clear();
+            for(uint32_t i = 0; i < count; i++){
+                if(frustum.intersects(boxes[i])){
+                    visible.push_back(i);
+                }
+            }
+        });
+        size_t linearVisible = visible.size();
+        double treeMs = bench::measure(REPEATS, [&]{ bvh.query(frustum, boxes.data(), visible); });
+        std::snprintf(workload, sizeof(workload), "frustum %s", label);
+        bench::report(workload, "linear", linearMs, linearMs, count);
+        bench::report(workload, "bvh", treeMs, linearMs, count);
+        std::printf("%-28s %zu / %zu visible\n", "", linearVisible, visible.size());
+
+        // picking rays through the screen
+        const int RAYS = 64;
+        std::vector<ngn::Ray> rays{};
+        for(int r = 0; r < RAYS; r++){
+            const float x = (r % 8) / 8.0f * 1280.0f + 40.0f;
+            const float y = (r / 8) / 8.0f * 720.0f + 22.0f;
+            rays.push_back(ngn::Ray::fromScreen({x, y}, {1280.0f, 720.0f}, view, proj));
+        }
+        uint32_t hits = 0;
+        double linearRayMs = bench::measure(REPEATS, [&]{
+            for(const auto &ray : rays){
+                float nearest = std::numeric_limits<float>::max();
+                for(uint32_t i = 0; i < count; i++){
+                    float t = 0.0f;
+                    if(ngn::intersect(ray, boxes[i], nearest, t)){
+                        nearest = t;
+                    }
+                }
+                bench::doNotOptimize(nearest);
+            }
+        });
+        double treeRayMs = bench::measure(REPEATS, [&]{
+            hits = 0;
+            for(const auto &ray : rays){
+                ngn::Bvh::Hit hit = bvh.raycast(ray, std::numeric_limits<float>::max(), [&](uint32_t item, float tMax){
+                    float t = 0.0f;
+                    return ngn::intersect(ray, boxes[item], tMax, t) ? t : tMax;
+                });
+                hits += hit.item != ngn::Bvh::NO_ITEM;
+            }
+        });
+        std::snprintf(workload, sizeof(workload), "%d rays %s", RAYS, label);
+        bench::report(workload, "linear", linearRayMs, linearRayMs, RAYS);
+        bench::report(workload, "bvh", treeRayMs, linearRayMs, RAYS);
+        bench::doNotOptimize(hits);
+    }
+}
+
+BENCH_SUITE(bvh)
+{
+    bench::header("bvh");
+    run(10000, "10k");
+    run(100000, "100k");
+    run(1000000, "1M");
+}
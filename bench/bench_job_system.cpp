@@ -0,0 +1,129 @@
+#include "bench.hpp"
+// common lib
+#include <job_system.hpp>
+#include <scene_graph.hpp>
+//lib
+#include <glm/glm.hpp>
+//std
+#include <atomic>
+#include <cmath>
+#include <future>
+#include <random>
+#include <vector>
+
+namespace
+{
+    // sphere against six planes, as a frustum test does
+    bool visible(const glm::vec4 &sphere, const glm::vec4 *planes)
+    {
+        for(int p = 0; p < 6; p++){
+            if(glm::dot(glm::vec3(planes[p]), glm::vec3(sphere)) + planes[p].w < -sphere.w){
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief One std::async task per chunk of grain indices, the baseline of JobSystem::parallel_for
+     */
+    template<typename F>
+    void async_for(size_t count, size_t grain, F &&fn)
+    {
+        std::vector<std::future<void>> tasks{};
+        tasks.reserve(count / grain + 1);
+        for(size_t begin = 0; begin < count; begin += grain){
+            size_t end = std::min(begin + grain, count);
+            tasks.push_back(std::async(std::launch::async, [&fn, begin, end]{ fn(begin, end); }));
+        }
+        for(auto &task : tasks){
+            task.get();
+        }
+    }
+
+    /**
+     * @brief Run a data parallel workload serially, with std::async and with the job system
+     */
+    template<typename F>
+    void compare(ngn::JobSystem &jobs, const char *workload, size_t count, size_t grain, int repeats, F &&fn)
+    {
+        double serial = bench::measure(repeats, [&]{ fn(size_t{0}, count); });
+        double async  = bench::measure(repeats, [&]{ async_for(count, grain, fn); });
+        double pooled = bench::measure(repeats, [&]{ jobs.parallel_for(count, grain, fn); });
+
+        bench::report(workload, "serial", serial, serial);
+        bench::report(workload, "std::async", async, serial);
+        bench::report(workload, "JobSystem", pooled, serial);
+    }
+
+} // namespace
+
+BENCH_SUITE(job_system)
+{
+    ngn::JobSystem jobs{};
+    const int REPEATS = 10;
+
+    bench::header("job_system");
+    std::printf("workers %u + calling thread\n", jobs.workerCount());
+
+    std::mt19937 rng{42};
+    std::uniform_real_distribution<float> dist{-10.f, 10.f};
+
+    // transform update: local matrices of every node
+    {
+        const size_t NODES = 200000;
+        std::vector<Transformations> nodes(NODES);
+        std::vector<glm::mat4> matrices(NODES);
+        for(auto &t : nodes){
+            t.T = {dist(rng), dist(rng), dist(rng)};
+            t.R = {dist(rng) * 18.f, dist(rng) * 18.f, dist(rng) * 18.f};
+        }
+
+        auto update = [&](size_t begin, size_t end){
+            for(size_t i = begin; i < end; i++){
+                matrices[i] = ngn::SceneGraph::compose(nodes[i]);
+            }
+        };
+        compare(jobs, "transforms 200k", NODES, 4096, REPEATS, update);
+        bench::doNotOptimize(matrices[NODES / 2]);
+    }
+
+    // culling: bounding spheres against the frustum planes
+    {
+        const size_t SPHERES = 1000000;
+        std::vector<glm::vec4> spheres(SPHERES);
+        std::vector<uint8_t> visibility(SPHERES);
+        for(auto &s : spheres){
+            s = {dist(rng), dist(rng), dist(rng), std::abs(dist(rng)) * 0.1f};
+        }
+        const glm::vec4 planes[6] = {
+            { 1, 0, 0, 5}, {-1, 0, 0, 5},
+            { 0, 1, 0, 5}, { 0,-1, 0, 5},
+            { 0, 0, 1, 5}, { 0, 0,-1, 5},
+        };
+
+        auto cull = [&](size_t begin, size_t end){
+            for(size_t i = begin; i < end; i++){
+                visibility[i] = visible(spheres[i], planes);
+            }
+        };
+        compare(jobs, "culling 1M spheres", SPHERES, 16384, REPEATS, cull);
+        bench::doNotOptimize(visibility[SPHERES / 2]);
+    }
+
+    // scheduling overhead: many small independent jobs
+    {
+        const size_t TASKS = 10000;
+        std::atomic<uint64_t> sum{0};
+
+        auto tiny = [&](size_t begin, size_t end){
+            uint64_t local = 0;
+            for(size_t i = begin; i < end; i++){
+                local += i * i;
+            }
+            sum.fetch_add(local, std::memory_order_relaxed);
+        };
+        compare(jobs, "10k tiny jobs", TASKS * 64, 64, REPEATS, tiny);
+        bench::doNotOptimize(sum.load());
+    }
+}
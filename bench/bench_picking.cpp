@@ -0,0 +1,83 @@
+#include "bench.hpp"
+// common lib
+#include <mesh_bvh.hpp>
+#include <model.hpp>
+//lib
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+//std
+#include <exception>
+#include <memory>
+#include <vector>
+
+namespace
+{
+    void run(const char *path, const char *label)
+    {
+        const int REPEATS = 10;
+        // grid of rays through the screen, the model fills about the middle of it
+        const int GRID = 32;
+        char workload[64];
+
+        std::unique_ptr<Model> model{};
+        try{
+            model = std::make_unique<Model>(path);
+        }catch(const std::exception &e){
+            std::printf("%-28s skipped, %s\n", label, e.what());
+            return;
+        }
+
+        std::unique_ptr<ngn::MeshBvh> mesh{};
+        double buildMs = bench::measure(1, [&]{ mesh = std::make_unique<ngn::MeshBvh>(*model); });
+        std::snprintf(workload, sizeof(workload), "build %s", label);
+        bench::report(workload, "binned sah", buildMs, buildMs, mesh->triangleCount());
+
+        const ngn::Sphere sphere = model->boundingSphere();
+        const glm::vec3 eye = sphere.center + glm::vec3(0.0f, 0.0f, sphere.radius * 3.0f);
+        glm::mat4 view = glm::lookAt(eye, sphere.center, glm::vec3(0.0f, 1.0f, 0.0f));
+        glm::mat4 proj = glm::perspective(glm::radians(45.0f), 1.0f, 0.1f, sphere.radius * 10.0f);
+
+        std::vector<ngn::Ray> rays{};
+        for(int y = 0; y < GRID; y++){
+            for(int x = 0; x < GRID; x++){
+                const std::pair<float, float> cursor{(x + 0.5f) * 800.0f / GRID, (y + 0.5f) * 800.0f / GRID};
+                rays.push_back(ngn::Ray::fromScreen(cursor, {800.0f, 800.0f}, view, proj));
+            }
+        }
+
+        const Vertex *vertices = model->verticesData();
+        const uint32_t *indices = model->indicesData();
+        const size_t indexCount = model->indicesSize();
+        double linearMs = bench::measure(1, [&]{
+            for(const auto &ray : rays){
+                float nearest = std::numeric_limits<float>::max();
+                for(size_t i = 0; i + 2 < indexCount; i += 3){
+                    ngn::intersect(ray, vertices[indices[i]].pos, vertices[indices[i + 1]].pos, vertices[indices[i + 2]].pos, nearest, nearest);
+                }
+                bench::doNotOptimize(nearest);
+            }
+        });
+
+        size_t hits = 0;
+        double treeMs = bench::measure(REPEATS, [&]{
+            hits = 0;
+            for(const auto &ray : rays){
+                hits += mesh->raycast(ray, std::numeric_limits<float>::max()).triangle != ngn::Bvh::NO_ITEM;
+            }
+        });
+
+        std::snprintf(workload, sizeof(workload), "%d rays %s", GRID * GRID, label);
+        bench::report(workload, "linear", linearMs, linearMs, rays.size());
+        bench::report(workload, "mesh bvh", treeMs, linearMs, rays.size());
+        std::printf("%-28s %zu hits, %.4f ms per pick\n", "", hits, treeMs / rays.size());
+    }
+}
+
+// run from the project root, models are loaded from data/models
+BENCH_SUITE(picking)
+{
+    bench::header("picking");
+    run("data/models/sphere/sphere-cylcoords-16k.obj", "sphere 16k");
+    run("data/models/backpack/backpack.obj", "backpack");
+    run("data/models/viking_room.obj", "viking room");
+}
@@ -0,0 +1,113 @@
+#include "bench.hpp"
+// common lib
+#include <scene_graph.hpp>
+#include <simd_transform.hpp>
+//lib
+#include <glm/glm.hpp>
+//std
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+BENCH_SUITE(simd_transform)
+{
+    const size_t NODES = 1000000;
+    const int REPEATS = 10;
+
+    bench::header("simd_transform");
+    std::printf("isa %s, %zu lanes\n", ngn::simd::isa(), ngn::simd::lanes());
+
+    std::mt19937 rng{42};
+    std::uniform_real_distribution<float> dist{-10.f, 10.f};
+
+    std::vector<Transformations> nodes(NODES);
+    std::vector<float> channels[9];
+    for(auto &c : channels){
+        c.resize(NODES);
+    }
+    for(size_t i = 0; i < NODES; i++){
+        Transformations &t = nodes[i];
+        t.T = {dist(rng), dist(rng), dist(rng)};
+        t.R = {dist(rng) * 36.f, dist(rng) * 36.f, dist(rng) * 36.f};
+        t.S = {1.0f + dist(rng) * 0.05f, 1.0f, 1.0f};
+        const float values[9] = {t.T.x, t.T.y, t.T.z, t.R.x, t.R.y, t.R.z, t.S.x, t.S.y, t.S.z};
+        for(int c = 0; c < 9; c++){
+            channels[c][i] = values[c];
+        }
+    }
+    const ngn::simd::TrsArrays trs{
+        channels[0].data(), channels[1].data(), channels[2].data(),
+        channels[3].data(), channels[4].data(), channels[5].data(),
+        channels[6].data(), channels[7].data(), channels[8].data(),
+    };
+
+    std::vector<glm::mat4> locals(NODES);
+    std::vector<glm::mat4> worlds(NODES);
+
+    // TRS to mat4
+    {
+        double scalar = bench::measure(REPEATS, [&]{
+            for(size_t i = 0; i < NODES; i++){
+                locals[i] = ngn::SceneGraph::compose(nodes[i]);
+            }
+        });
+        double simd = bench::measure(REPEATS, [&]{ ngn::simd::composeTRS(trs, locals.data(), NODES); });
+
+        bench::report("compose 1M", "glm", scalar, scalar, NODES);
+        bench::report("compose 1M", ngn::simd::isa(), simd, scalar, NODES);
+        bench::doNotOptimize(locals[NODES / 2]);
+    }
+
+    // parent * local, every node child of the previous one in groups of 8
+    {
+        std::vector<uint32_t> parents(NODES);
+        for(size_t i = 0; i < NODES; i++){
+            parents[i] = i % 8 ? static_cast<uint32_t>(i - 1) : ngn::NO_PARENT;
+        }
+
+        double scalar = bench::measure(REPEATS, [&]{
+            for(size_t i = 0; i < NODES; i++){
+                worlds[i] = parents[i] == ngn::NO_PARENT ? locals[i] : worlds[parents[i]] * locals[i];
+            }
+        });
+        double simd = bench::measure(REPEATS, [&]{
+            ngn::simd::multiplyParents(parents.data(), locals.data(), worlds.data(), NODES);
+        });
+
+        bench::report("parent x local 1M", "glm", scalar, scalar, NODES);
+        bench::report("parent x local 1M", ngn::simd::isa(), simd, scalar, NODES);
+        bench::doNotOptimize(worlds[NODES / 2]);
+    }
+
+    // bounds to world space
+    {
+        std::vector<ngn::Sphere> spheres(NODES, ngn::Sphere{glm::vec3(0.1f), 1.0f});
+        std::vector<ngn::Sphere> worldSpheres(NODES);
+        std::vector<ngn::Aabb> boxes(NODES, ngn::Aabb{glm::vec3(-1.0f), glm::vec3(1.0f)});
+        std::vector<ngn::Aabb> worldBoxes(NODES);
+
+        double scalar = bench::measure(REPEATS, [&]{
+            for(size_t i = 0; i < NODES; i++){
+                const glm::mat4 &m = worlds[i];
+                worldSpheres[i].center = glm::vec3(m * glm::vec4(spheres[i].center, 1.0f));
+                const float scale = std::max({glm::dot(glm::vec3(m[0]), glm::vec3(m[0])),
+                                              glm::dot(glm::vec3(m[1]), glm::vec3(m[1])),
+                                              glm::dot(glm::vec3(m[2]), glm::vec3(m[2]))});
+                worldSpheres[i].radius = spheres[i].radius * std::sqrt(scale);
+            }
+        });
+        double simd = bench::measure(REPEATS, [&]{
+            ngn::simd::transformSpheres(worlds.data(), spheres.data(), worldSpheres.data(), NODES);
+        });
+        bench::report("spheres 1M", "glm", scalar, scalar, NODES);
+        bench::report("spheres 1M", ngn::simd::isa(), simd, scalar, NODES);
+        bench::doNotOptimize(worldSpheres[NODES / 2]);
+
+        double boxesMs = bench::measure(REPEATS, [&]{
+            ngn::simd::transformAabbs(worlds.data(), boxes.data(), worldBoxes.data(), NODES);
+        });
+        bench::report("aabbs 1M", ngn::simd::isa(), boxesMs, boxesMs, NODES);
+        bench::doNotOptimize(worldBoxes[NODES / 2]);
+    }
+}
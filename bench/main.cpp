@@ -0,0 +1,17 @@
+#include "bench.hpp"
+//std
+#include <cstring>
+
+int main(int argc, char const **argv)
+{
+    for(auto &[name, suite] : bench::suites()){
+        bool selected = argc < 2;
+        for(int i = 1; i < argc; i++){
+            selected |= std::strcmp(argv[i], name) == 0;
+        }
+        if(selected){
+            suite();
+        }
+    }
+    return 0;
+}
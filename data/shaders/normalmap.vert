@@ -15,13 +15,22 @@ layout(binding = 0) uniform UniformBufferObject {
     vec3 drawLines;
 } ubo;
 
+#ifdef MULTI_DRAW
+// opengl multi draw: one model matrix per draw command, gl_DrawID restarts at every call
+layout (std430, binding = 3) readonly buffer DrawData {
+	mat4 models[];
+} drawData;
+#define MODEL drawData.models[gl_DrawIDARB]
+#else
 layout (binding = 2) uniform UboInstance {
 	mat4 model; 
 } uboInstance;
+#define MODEL uboInstance.model
+#endif
 
 
 void main() {
-    mat4 modelView = ubo.view * uboInstance.model;
+    mat4 modelView = ubo.view * MODEL;
     mat4 normalMatrix = transpose(inverse(modelView));
     vec3 Normal = normalize(vec3(normalMatrix * vec4(inNormal, 1.0)));
         
@@ -23,9 +23,18 @@ layout(binding = 0) uniform UniformBufferObject {
     vec3 drawLines;
 } ubo;
 
+#ifdef MULTI_DRAW
+// opengl multi draw: one model matrix per draw command, gl_DrawID restarts at every call
+layout (std430, binding = 3) readonly buffer DrawData {
+	mat4 models[];
+} drawData;
+#define MODEL drawData.models[gl_DrawIDARB]
+#else
 layout (binding = 2) uniform UboInstance {
 	mat4 model; 
 } uboInstance;
+#define MODEL uboInstance.model
+#endif
 
 void main() {
     vs_out.fragTexCoord = inTexCoord;
@@ -33,8 +42,8 @@ void main() {
     vs_out.viewPos = ubo.viewPos;
     vs_out.drawLines = ubo.drawLines;
 
-    vs_out.FragPos = vec3(uboInstance.model * vec4(inPosition, 1.0));
-    vs_out.Normal = mat3(transpose(inverse(uboInstance.model))) * inNormal; 
+    vs_out.FragPos = vec3(MODEL * vec4(inPosition, 1.0));
+    vs_out.Normal = mat3(transpose(inverse(MODEL))) * inNormal; 
 
     gl_Position = ubo.proj * ubo.view * vec4(vs_out.FragPos, 1.0);
 }
\ No newline at end of file
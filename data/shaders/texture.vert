@@ -14,13 +14,22 @@ layout(binding = 0) uniform UniformBufferObject {
     mat4 proj;
 } ubo;
 
+#ifdef MULTI_DRAW
+// opengl multi draw: one model matrix per draw command, gl_DrawID restarts at every call
+layout (std430, binding = 3) readonly buffer DrawData {
+	mat4 models[];
+} drawData;
+#define MODEL drawData.models[gl_DrawIDARB]
+#else
 layout (binding = 2) uniform UboInstance {
 	mat4 model; 
 } uboInstance;
+#define MODEL uboInstance.model
+#endif
 
 
 void main() {
-    gl_Position = ubo.proj * ubo.view * uboInstance.model * vec4(inPosition, 1.0);
+    gl_Position = ubo.proj * ubo.view * MODEL * vec4(inPosition, 1.0);
     fragColor = inColor;
     fragTexCoord = inTexCoord;
 }
\ No newline at end of file
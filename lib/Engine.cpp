@@ -4,12 +4,24 @@
 #include <Window.hpp>
 #include <service_locator.hpp>
 #include <model.hpp>
+#include <profiler.hpp>
+#include <simd_transform.hpp>
+#include <frustum.hpp>
 //lib
-// #include <imgui.h>
+#include <imgui.h>
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtx/euler_angles.hpp>
 // std
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
 #include <memory>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
 
 Engine::Engine(EngineType type) : engine_type_{type}
 {
@@ -58,26 +70,73 @@ void Engine::run()
         if(ngn::Time::time())
         {
             std::stringstream msg;
-            msg << " [ " <<  ngn::Time::getFrameTime() << " ns/frame ]";
+            msg << " [ " <<  ngn::Time::getFrameTime() << " ms/frame ]";
             msg << " [ " <<  ngn::Time::geFps()  << " FPS ]" ;
+            msg << " [ jitter " <<  ngn::Time::getJitter()  << " ms ]" ;
             msg << " Focal = " << ourCamera.GetFocal() ;
             msg << " " << ngn::Mouse::getDirection_str();
             setWindowMessage(msg.str());        
         } };
 
-    spdlog::info("*******           START           ************");  
-    while(!window_->shouldClose() ) {
-
-
-        ngn::Time::start();
-            draw();
-        ngn::Time::end();
+    // simulated time not yet consumed by a fixed step
+    float accumulator = 0.f;
+    uint64_t frameNumber = 0;
+    previousCamera_ = ourCamera.getState();
 
-        updateEvents();
-        timestamp();
+    if(useRenderThread_){
+        startRenderThread();
+    }
 
-    }    
+    spdlog::info("*******           START           ************");  
+    try{
+        while(!window_->shouldClose() ) {
+
+            ngn::Time::start();
+
+                updateEvents();
+
+                accumulator += std::min(ngn::Time::getFrameTime(), ngn::Time::MAX_FRAME_STEP);
+                while(accumulator >= ngn::Time::FIXED_STEP){
+                    fixedUpdate();
+                    accumulator -= ngn::Time::FIXED_STEP;
+                }
+                interpolateCamera(accumulator / ngn::Time::FIXED_STEP);
+
+                FrameSnapshot &frame = snapshots_.writeBuffer();
+                buildSnapshot(frame, ++frameNumber);
+
+                if(useRenderThread_){
+                    snapshots_.publish();
+                    published_.store(frameNumber);
+                    wake_.fetch_add(1);
+                    wake_.notify_one();
+                    // stay at most one frame ahead: the next snapshot is built while this one is drawn
+                    waitConsumed(frameNumber);
+                    if(renderError_){
+                        break;
+                    }
+                }else{
+                    renderFrame(frame);
+                }
+
+            ngn::Time::end();
+            ngn::Profiler::endFrame(ngn::Time::getCpuFrameTime());
+
+            timestamp();
+            ngn::Time::limitFrame();
+        }
+    }catch(...){
+        if(useRenderThread_){
+            stopRenderThread();
+        }
+        throw;
+    }
+    if(useRenderThread_){
+        stopRenderThread();
+    }
     spdlog::info("*******           END             ************");  
+
+    ngn::Profiler::writeBenchmark();
 }
 
 void Engine::updateEvents() 
@@ -86,15 +145,287 @@ void Engine::updateEvents()
         ngn::ServiceLocator::GetInputManager()->processInput();
     }
 
-    for(auto const& command : commands_){
-        command.second->Execute();
+    // mouse movements are applied as they come, no interpolation
+    if(!cursor_commands_.empty()){
+        for(auto const& command : cursor_commands_){
+            command.second->Execute();
+        }
+        previousCamera_ = ourCamera.getState();
     }
 
     window_->update();
     if (window_->is_Resized()){
-        resizeFrame(); 
+        resizePending_ = true; 
+    }
+
+}
+
+void Engine::buildSnapshot(FrameSnapshot &frame, uint64_t frameNumber)
+{
+    frame.frame = frameNumber;
+    frame.mvp = getMVP();
+
+    auto [width, height] = window_->extents();
+    frame.width = static_cast<uint32_t>(width);
+    frame.height = static_cast<uint32_t>(height);
+    frame.resized = resizePending_;
+    resizePending_ = false;
+
+    // against the bounds of the frame on screen, before the ui shows the selection
+    if(pickPending_){
+        pickPending_ = false;
+        pickObject(frame.mvp, input_.GetMousePosition());
+    }
+
+    // the ui is built here and only its draw lists travel to the renderer
+    if(ui_Overlay_){
+        newUiFrame();
+        draw_UiOverlay();
+        frame.ui.copy(ImGui::GetDrawData());
+    }
+
+    // after the ui, edits are visible in the same frame
+    scene_.update();
+    updateBounds();
+    const auto transforms = renderables_.column<TransformComponent>();
+    frame.transforms.resize(transforms.size());
+    for(size_t i = 0; i < transforms.size(); i++){
+        frame.transforms[i] = scene_.world(transforms[i].meshNode);
+    }
+    cullRenderables(frame);
+}
+
+void Engine::updateBounds()
+{
+    // only objects moved by the last scene update
+    const auto transforms = renderables_.column<TransformComponent>();
+    const auto local = renderables_.column<LocalBoundsComponent>();
+    const auto worldBounds = renderables_.column<ngn::Aabb>();
+    const auto worldSpheres = renderables_.column<ngn::Sphere>();
+    moved_.clear();
+    for(size_t i = 0; i < transforms.size(); i++){
+        if(!scene_.changed(transforms[i].meshNode)){
+            continue;
+        }
+        const glm::mat4 &world = scene_.world(transforms[i].meshNode);
+        ngn::simd::transformAabbs(&world, &local[i].box, &worldBounds[i], 1);
+        ngn::simd::transformSpheres(&world, &local[i].sphere, &worldSpheres[i], 1);
+        moved_.push_back(static_cast<uint32_t>(i));
+    }
+
+    if(rebuildBvh_){
+        rebuildBvh_ = false;
+        bvh_.build(worldBounds.data(), worldBounds.size());
+        SPDLOG_DEBUG("bvh rebuilt, {} objects depth {}", bvh_.size(), bvh_.depth());
+    }else if(bvh_.update(worldBounds.data(), worldBounds.size(), moved_.data(), moved_.size()) == ngn::Bvh::Update::REBUILD){
+        SPDLOG_DEBUG("bvh rebuilt, {} objects depth {}", bvh_.size(), bvh_.depth());
+    }
+}
+
+void Engine::cullRenderables(FrameSnapshot &frame)
+{
+    // below this many objects the jobs cost more than the test
+    const size_t PARALLEL_CULL_MIN = 4096;
+    const size_t CULL_GRAIN = 1024;
+    // past this many objects the bvh skips whole groups outside or inside the frustum
+    const size_t BVH_CULL_MIN = 16384;
+
+    const ngn::Frustum frustum = ngn::Frustum::fromMatrix(frame.mvp.proj * frame.mvp.view);
+    const auto worldBounds = renderables_.column<ngn::Aabb>();
+    const auto worldSpheres = renderables_.column<ngn::Sphere>();
+    const auto visibility = renderables_.column<VisibilityComponent>();
+    const size_t count = worldSpheres.size();
+
+    if(count >= BVH_CULL_MIN){
+        bvh_.query(frustum, worldBounds.data(), frame.visible);
+        std::sort(frame.visible.begin(), frame.visible.end());
+        ngn::Profiler::setCulling(static_cast<uint32_t>(frame.visible.size()), static_cast<uint32_t>(count));
+        return;
+    }
+
+    if(count >= PARALLEL_CULL_MIN){
+        jobs_.parallel_for(count, CULL_GRAIN, [&](size_t begin, size_t end){
+            ngn::simd::cullSpheres(frustum.planes.data(), &worldSpheres[begin], &visibility[begin], end - begin);
+        });
+    }else{
+        ngn::simd::cullSpheres(frustum.planes.data(), worldSpheres.data(), visibility.data(), count);
+    }
+
+    // the boxes reject what the spheres let through
+    frame.visible.clear();
+    for(size_t i = 0; i < count; i++){
+        if(visibility[i] && frustum.intersects(worldBounds[i])){
+            frame.visible.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    ngn::Profiler::setCulling(static_cast<uint32_t>(frame.visible.size()), static_cast<uint32_t>(count));
+}
+
+void Engine::pickObject(const UniformBufferObject &mvp, std::pair<float, float> cursor)
+{
+    auto tStart = std::chrono::high_resolution_clock::now();
+
+    auto [width, height] = window_->extents();
+    if(width == 0 || height == 0){
+        return;
+    }
+    const ngn::Ray ray = ngn::Ray::fromScreen(cursor, {static_cast<float>(width), static_cast<float>(height)}, mvp.view, mvp.proj);
+
+    const auto meshes = renderables_.column<MeshComponent>();
+    const auto transforms = renderables_.column<TransformComponent>();
+    const auto worldBounds = renderables_.column<ngn::Aabb>();
+    // objects whose box is hit, nearest first, then their triangles
+    ngn::Bvh::Hit hit = bvh_.raycast(ray, std::numeric_limits<float>::max(), [&](uint32_t item, float tMax){
+        const RenderObject &object = *meshes[item];
+        if(!object.pickMesh){
+            float t = tMax;
+            return ngn::intersect(ray, worldBounds[item], tMax, t) ? t : tMax;
+        }
+        // model space ray, not normalized: distances are the same as in world space
+        const glm::mat4 toModel = glm::inverse(scene_.world(transforms[item].meshNode));
+        const ngn::Ray local{glm::vec3(toModel * glm::vec4(ray.origin, 1.0f)), glm::vec3(toModel * glm::vec4(ray.direction, 0.0f))};
+        return object.pickMesh->raycast(local, tMax).t;
+    });
+
+    float ms = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - tStart).count();
+    if(hit.item != ngn::Bvh::NO_ITEM){
+        selected_ = hit.item;
+        SPDLOG_DEBUG("picked {} at {:.3f} in {:.3f} ms", meshes[hit.item]->objName, hit.t, ms);
+    }else{
+        SPDLOG_DEBUG("nothing picked in {:.3f} ms", ms);
+    }
+}
+
+void Engine::renderFrame(const FrameSnapshot &frame)
+{
+    frame_ = &frame;
+
+    if(frame.resized){
+        resizeFrame();
+    }
+    draw();
+    ngn::Profiler::endDrawFrame();
+
+    frame_ = nullptr;
+}
+
+void Engine::renderLoop()
+{
+    window_->makeContextCurrent();
+
+    try{
+        uint64_t seen = 0;
+        uint64_t drawn = 0;
+        while(true){
+            wake_.wait(seen);
+            seen = wake_.load();
+            if(!rendering_){
+                break;
+            }
+
+            // posted while the previous frame was drawn, the main thread waits for it
+            if(const auto *task = std::exchange(renderTask_, nullptr)){
+                (*task)();
+                tasksDone_.fetch_add(1);
+                tasksDone_.notify_one();
+            }
+            if(published_.load() == drawn){
+                continue;
+            }
+            drawn = published_.load();
+
+            snapshots_.acquire();
+            const FrameSnapshot &frame = snapshots_.readBuffer();
+            // the main thread can reuse the other buffers from now on
+            consumed_.store(frame.frame);
+            consumed_.notify_one();
+
+            renderFrame(frame);
+        }
+    }catch(...){
+        spdlog::error("render thread failed");
+        renderError_ = std::current_exception();
+        consumed_.store(UINT64_MAX);
+        consumed_.notify_one();
+        tasksDone_.store(UINT64_MAX);
+        tasksDone_.notify_one();
+    }
+
+    window_->releaseContext();
+}
+
+void Engine::startRenderThread()
+{
+    spdlog::info("render thread enabled");
+
+    // the opengl context can be current on one thread at a time
+    window_->releaseContext();
+
+    rendering_ = true;
+    renderer_ = std::thread(&Engine::renderLoop, this);
+}
+
+void Engine::stopRenderThread()
+{
+    if(!renderer_.joinable()){
+        return;
+    }
+
+    rendering_ = false;
+    wake_.fetch_add(1);
+    wake_.notify_one();
+    renderer_.join();
+
+    window_->makeContextCurrent();
+
+    if(renderError_){
+        std::rethrow_exception(std::exchange(renderError_, nullptr));
+    }
+}
+
+void Engine::waitConsumed(uint64_t frameNumber)
+{
+    uint64_t consumed = consumed_.load();
+    while(consumed < frameNumber){
+        consumed_.wait(consumed);
+        consumed = consumed_.load();
+    }
+}
+
+void Engine::runOnRenderer(const std::function<void()> &task)
+{
+    if(!renderer_.joinable()){
+        task();
+        return;
+    }
+
+    renderTask_ = &task;
+    const uint64_t posted = ++tasksPosted_;
+    wake_.fetch_add(1);
+    wake_.notify_one();
+
+    uint64_t done = tasksDone_.load();
+    while(done < posted){
+        tasksDone_.wait(done);
+        done = tasksDone_.load();
+    }
+    if(renderError_){
+        throw std::runtime_error("render thread failed");
+    }
+}
+
+void Engine::fixedUpdate()
+{
+    previousCamera_ = ourCamera.getState();
+
+    for(auto const& command : commands_){
+        command.second->Execute();
     }
+}
 
+void Engine::interpolateCamera(float alpha)
+{
+    renderCamera_.setState(CameraState::mix(previousCamera_, ourCamera.getState(), alpha));
 }
 
 UniformBufferObject Engine::getMVP()
@@ -103,10 +434,10 @@ UniformBufferObject Engine::getMVP()
     const float NEAR = 1.0;
     const float FAR = 11.0;
 
-    mvp.view = ourCamera.GetViewMatrix();
-    mvp.proj = glm::perspective(glm::radians(ourCamera.GetFov()), window_->getWindowAspect(), NEAR, FAR);
+    mvp.view = renderCamera_.GetViewMatrix();
+    mvp.proj = glm::perspective(glm::radians(renderCamera_.GetFov()), window_->getWindowAspect(), NEAR, FAR);
 
-    mvp.viewPos = ourCamera.GetPosition();
+    mvp.viewPos = renderCamera_.GetPosition();
 
     return mvp;
 } 
@@ -114,42 +445,54 @@ UniformBufferObject Engine::getMVP()
 
 void Engine::draw_UiOverlay()
 {
-    static size_t selected = 0;
- 
     std::vector<std::string> items{};
-    for( auto & obj : renderables_){
+    for( auto & obj : renderables_.column<MeshComponent>()){
         items.push_back(obj->objName);
     }
     
-    Transformations t = renderables_.at(selected)->objNode.get();
- 
-    if(GUI::ObjectNode(t, items, selected)){
-        renderables_.at(selected)->objNode.set(t);
-    }  
+    GUI::NewFrame();
+
+        GUI::ObjectAction action = GUI::ObjectAction::NONE;
+        // every object can be destroyed through the api
+        if(!renderables_.empty()){
+            const ngn::NodeId node = renderables_.column<TransformComponent>()[selected_].node;
+            Transformations t = scene_.getTransform(node);
+            if(GUI::ObjectNode(t, items, selected_)){
+                scene_.setTransform(node, t);
+            }  
+            action = GUI::ObjectActions(renderables_.size() > 1);
+        }
+        GUI::GpuTimings(ngn::Time::getCpuFrameTime());
+        GUI::PerformanceHud();
+
+    GUI::Render();
+
+    // the draw data is complete, the scene can change from here
+    if(action == GUI::ObjectAction::DUPLICATE){
+        const RenderObject &source = *renderables_.column<MeshComponent>()[selected_];
+        Transformations copy = scene_.getTransform(renderables_.column<TransformComponent>()[selected_].node);
+        copy.T.x += 0.5f;
+        const ObjectHandle handle = spawn(source.modelPath, source.shader, copy, source.modelUp);
+        selected_ = renderables_.row(handle);
+    }else if(action == GUI::ObjectAction::REMOVE){
+        destroy(handleOf(selected_));
+    }
 }
 
 void Engine::init_shaders()
 {
     SPDLOG_TRACE("Engine::init_shaders");
 
-    {
-        auto shader = Shader::make().type(GLSL::TEXTURE)
-                                    .addTexture("data/textures/viking_room.png", 1)
-                                    .build(); 
-
-        shaders_.emplace("texture", std::move(shader));                                 
-    }
-    {
-        auto shader = Shader::make().type(GLSL::NORMALMAP)
-                                    .build();
-
-        shaders_.emplace("normalmap", std::move(shader));
-    }
-    {
-        auto shader = Shader::make().type(GLSL::PHONG)
-                                    .build();
+    sceneFile_ = ngn::SceneFile::open(scenePath_);
+    spdlog::info("scene {}: {} materials {} nodes", scenePath_, sceneFile_.materials().size(), sceneFile_.nodes().size());
 
-        shaders_.emplace("phong", std::move(shader));
+    for(const ngn::SceneMaterial &material : sceneFile_.materials()){
+        ShaderBuilder &builder = Shader::make().type(static_cast<GLSL::ShaderType>(material.shader))
+                                               .setPolygonMode(static_cast<GLSL::PolygonMode>(material.polygonMode));
+        for(const ngn::SceneTexture &texture : sceneFile_.textures(material)){
+            builder.addTexture(std::string(sceneFile_.string(texture.path)), texture.binding);
+        }
+        shaders_.emplace(sceneFile_.string(material.name), builder.build());
     }
 }
 
@@ -178,48 +521,175 @@ void Engine::init_renderables()
 {
    SPDLOG_TRACE("Engine init_renderables"); 
 
-   {
-        Model model("data/models/sphere/sphere_scaled.obj", Model::UP::ZUP);
-        // Transformations tra{};
-        // tra.S ={1.0f, 1.0f, 1.0f};
-        // //rotate toward camera
-        // tra.R ={0.0f, 270.0f, 0.0f};
-        // // move right
-        // tra.T = {1.0f, 0.0f, 0.0f};
-        // model.node.set(tra);
-
-        auto object = RenderObject::make().build(model, "phong");
-        object->objName = "sphere";
-        renderables_.push_back(std::move(object));
+    auto tStart = std::chrono::high_resolution_clock::now();
+    const auto nodes = sceneFile_.nodes();
+
+    // every model file once, parsed in parallel with its picking triangles
+    struct Asset
+    {
+        std::string path;
+        Model::UP up{};
+        std::unique_ptr<Model> model{};
+        std::shared_ptr<const ngn::MeshBvh> pickMesh{};
+        std::exception_ptr error{};
+    };
+    std::vector<Asset> assets{};
+    std::unordered_map<std::string, uint32_t> assetIndex{};
+    std::vector<uint32_t> nodeAsset(nodes.size(), ngn::SCENE_NONE);
+    for(size_t n = 0; n < nodes.size(); n++){
+        if(nodes[n].material == ngn::SCENE_NONE){
+            continue;
+        }
+        const std::string path{sceneFile_.string(nodes[n].model)};
+        const auto up = static_cast<Model::UP>(nodes[n].up);
+        auto [found, inserted] = assetIndex.try_emplace(path + (up == Model::UP::ZUP ? "|z" : "|y"), static_cast<uint32_t>(assets.size()));
+        if(inserted){
+            assets.push_back(Asset{path, up});
+        }
+        nodeAsset[n] = found->second;
     }
-   {
-        Model model("data/models/viking_room.obj", Model::UP::ZUP);
-        // rotate toward camera
-        Transformations tra{};
-        tra.R ={0.0f, 270.0f, 0.0f};
-        // move right
-        tra.T = {1.0f, 0.0f, 0.0f};
-        model.node.set(tra);
 
-        auto object = RenderObject::make().build(model, "texture");
-        object->objName = "viking_room";
-        renderables_.push_back(std::move(object));
+    jobs_.parallel_for(assets.size(), 1, [&](size_t begin, size_t end){
+        for(size_t a = begin; a < end; a++){
+            // jobs can't throw, the first error is raised after the wait
+            try{
+                assets[a].model = std::make_unique<Model>(assets[a].path.c_str(), assets[a].up);
+                assets[a].pickMesh = std::make_shared<ngn::MeshBvh>(*assets[a].model);
+            }catch(...){
+                assets[a].error = std::current_exception();
+            }
+        }
+    });
+    for(const auto &asset : assets){
+        if(asset.error){
+            std::rethrow_exception(asset.error);
+        }
+        // addRenderable() finds them by path while the assets hold them
+        pickMeshes_[asset.path] = asset.pickMesh;
     }
 
-    {
-        Model model("data/models/suzanne.obj", Model::UP::YUP);
-        Transformations tra{};
-        // move left
-        tra.T = {-1.0f, 0.0f, 0.0f};
-        model.node.set(tra);
+    // gpu objects and nodes in file order, parents come first
+    std::vector<ngn::NodeId> nodeIds(nodes.size(), ngn::NO_PARENT);
+    for(size_t n = 0; n < nodes.size(); n++){
+        const ngn::SceneNode &node = nodes[n];
+        const ngn::NodeId parent = node.parent == ngn::SCENE_NONE ? ngn::NO_PARENT : nodeIds[node.parent];
+        if(nodeAsset[n] == ngn::SCENE_NONE){
+            nodeIds[n] = scene_.create(parent, ngn::SceneFile::transform(node));
+            continue;
+        }
+
+        Asset &asset = assets[nodeAsset[n]];
+        asset.model->transform = ngn::SceneFile::transform(node);
+        const std::string shader{sceneFile_.string(sceneFile_.materials()[node.material].name)};
+        auto object = RenderObject::make().build(*asset.model, shader);
+        object->objName = sceneFile_.string(node.name);
+        object->modelPath = asset.path;
+        object->modelUp = asset.up;
+        const ObjectHandle handle = addRenderable(std::move(object), *asset.model, parent);
+        nodeIds[n] = renderables_.column<TransformComponent>()[renderables_.row(handle)].node;
+    }
 
-        auto object = RenderObject::make().build(model, "normalmap");
-        object->objName = "suzanne";
-        renderables_.push_back(std::move(object));
+    float ms = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - tStart).count();
+    spdlog::info("scene loaded in {:.1f} ms, {} models for {} objects", ms, assets.size(), renderables_.size());
+}
 
-    } 
+ObjectHandle Engine::addRenderable(std::unique_ptr<RenderObject> object, const Model &model, ngn::NodeId parent)
+{
+    Shader *material = &getShader(shaders_, object->shader);
+    object->pickMesh = pickMesh(model);
+    const ngn::NodeId node = scene_.create(parent, model.transform);
+    const TransformComponent transform{node, scene_.createFixed(node, model.upMatrix())};
+    const LocalBoundsComponent local{model.bounds(), model.boundingSphere()};
+    rebuildBvh_ = true;
+    // world bounds filled by the next updateBounds(), new nodes are always dirty
+    return renderables_.create(std::move(object), material, transform, local, local.box, local.sphere, VisibilityComponent{0});
+}
+
+std::shared_ptr<const ngn::MeshBvh> Engine::pickMesh(const Model &model)
+{
+    // generated models have no file to share
+    if(model.path().empty()){
+        return std::make_shared<ngn::MeshBvh>(model);
+    }
+    std::weak_ptr<const ngn::MeshBvh> &cached = pickMeshes_[model.path()];
+    std::shared_ptr<const ngn::MeshBvh> mesh = cached.lock();
+    if(!mesh){
+        mesh = std::make_shared<ngn::MeshBvh>(model);
+        cached = mesh;
+    }
+    return mesh;
 }
 
+std::unique_ptr<RenderObject> Engine::removeRenderable(ObjectHandle handle)
+{
+    const uint32_t row = renderables_.row(handle);
+    const TransformComponent transform = renderables_.column<TransformComponent>()[row];
+    scene_.release(transform.meshNode);
+    scene_.release(transform.node);
+    std::unique_ptr<RenderObject> object = std::move(renderables_.column<MeshComponent>()[row]);
+
+    // the last object takes the place of the removed one
+    const size_t last = renderables_.size() - 1;
+    renderables_.destroy(handle);
+    rebuildBvh_ = true;
+
+    if(selected_ == last){
+        selected_ = row;
+    }
+    if(selected_ >= renderables_.size()){
+        selected_ = 0;
+    }
+    return object;
+}
+
+ObjectHandle Engine::spawn(const std::string &path, const std::string &shader, const Transformations &tra, Model::UP up)
+{
+    if(shaders_.find(shader) == shaders_.end()){
+        throw std::runtime_error("unknown shader " + shader);
+    }
+
+    // the file is read here, only the upload waits for the renderer
+    Model model(path.c_str(), up);
+    model.transform = tra;
+
+    ObjectHandle handle{};
+    // the renderer does not read the renderables while the task runs
+    runOnRenderer([&]{
+        auto object = RenderObject::make().build(model, shader);
+        object->objName = std::filesystem::path(path).stem().string();
+        object->modelPath = path;
+        object->modelUp = up;
+        handle = addRenderable(std::move(object), model);
+    });
+    SPDLOG_DEBUG("spawned {} slot {}", path, handle.slot);
+    return handle;
+}
+
+bool Engine::destroy(ObjectHandle handle)
+{
+    if(!alive(handle)){
+        return false;
+    }
+    const uint32_t row = renderables_.row(handle);
+    // released nodes can't have children
+    if(scene_.hasChildren(renderables_.column<TransformComponent>()[row].node)){
+        spdlog::warn("{} has child nodes, not destroyed", renderables_.column<MeshComponent>()[row]->objName);
+        return false;
+    }
+
+    runOnRenderer([&]{ retire(removeRenderable(handle)); });
+    return true;
+}
+
+bool Engine::alive(ObjectHandle handle) const
+{
+    return renderables_.alive(handle);
+}
+
+ObjectHandle Engine::handleOf(size_t index) const
+{
+    return renderables_.entity(index);
+}
 
 void Engine::MapActions() 
 {
@@ -305,7 +775,7 @@ void Engine::MapActions()
         .Func = [this](InputSource source, int sourceIndex, float value) {
 
             if (value){
-                float step = MULT * ngn::Time::getFrameTime();
+                float step = MULT * ngn::Time::FIXED_STEP;
                 value *= step;
                 commands_.emplace("orbit left/right", std::make_unique<CmdOrbit>(ourCamera, glm::vec2(value, 0.f)) );  
                 shouldupdate = true;
@@ -323,7 +793,7 @@ void Engine::MapActions()
         .Func = [this](InputSource source, int sourceIndex, float value) {
 
             if (value){
-                float step = MULT * ngn::Time::getFrameTime();
+                float step = MULT * ngn::Time::FIXED_STEP;
                 value *= step;
                 commands_.emplace("orbit up/down", std::make_unique<CmdOrbit>(ourCamera, glm::vec2(0.f, value)) );  
                 shouldupdate = true;
@@ -340,7 +810,7 @@ void Engine::MapActions()
         .Func = [this](InputSource source, int sourceIndex, float value) {
 
             if (value){
-                float step = MULT * 10 * Time::getFrameTime();
+                float step = MULT * 10 * Time::FIXED_STEP;
                 value *= step;
                 commands_.emplace("cam fov", std::make_unique<CmdFov>(ourCamera, glm::vec2(value)) ); 
                 shouldupdate = true;
@@ -357,7 +827,7 @@ void Engine::MapActions()
         .Func = [this](InputSource source, int sourceIndex, float value) {
 
             if (value){               
-                float step = MULT * Time::getFrameTime();
+                float step = MULT * Time::FIXED_STEP;
                 value *= step;
                 commands_.emplace("dolly in/out", std::make_unique<CmdDolly>(ourCamera, glm::vec2(value)) ); 
                 shouldupdate = true;
@@ -372,16 +842,22 @@ void Engine::MapActions()
     inputManager_->RegisterActionCallback("leftclick", InputManager::ActionCallback {
         .Ref = "YoutubeGame",
         .Func = [this](InputSource source, int sourceIndex, float value) {
+            // a click without drag picks, the ui keeps its own clicks
+            const float CLICK_DISTANCE = 3.0f;
             if(value) // btn down
             {
                 Mouse::Start();
-                commands_.emplace("click orbit", std::make_unique<CmdOrbit>(ourCamera, glm::vec2(0.f)) );  
+                cursor_commands_.emplace("click orbit", std::make_unique<CmdOrbit>(ourCamera, glm::vec2(0.f)) );  
                 shouldupdate = true;
+                pressCursor_ = input_.GetMousePosition();
             }else // btn up
             {
                 Mouse::Stop();
-                commands_.erase("click orbit");
+                cursor_commands_.erase("click orbit");
                 shouldupdate = false;
+                auto [x, y] = input_.GetMousePosition();
+                const bool still = std::abs(x - pressCursor_.first) < CLICK_DISTANCE && std::abs(y - pressCursor_.second) < CLICK_DISTANCE;
+                pickPending_ = still && !(ui_Overlay_ && ImGui::GetIO().WantCaptureMouse);
             }
             return true;
         }
@@ -392,12 +868,12 @@ void Engine::MapActions()
             if(value) // btn down
             {
                 Mouse::Start();
-                commands_.emplace("click pan", std::make_unique<CmdPan>(ourCamera, glm::vec2(0.f)) ); 
+                cursor_commands_.emplace("click pan", std::make_unique<CmdPan>(ourCamera, glm::vec2(0.f)) ); 
                 shouldupdate = true;
             }else // btn up
             {
                 Mouse::Stop();
-                commands_.erase("click pan");
+                cursor_commands_.erase("click pan");
                 shouldupdate = false;
             }
             return true;
@@ -409,12 +885,12 @@ void Engine::MapActions()
             if(value) // btn down
             {
                 Mouse::Start();
-                commands_.emplace("click roll", std::make_unique<CmdRoll>(ourCamera, glm::vec2(0.f)) ); 
+                cursor_commands_.emplace("click roll", std::make_unique<CmdRoll>(ourCamera, glm::vec2(0.f)) ); 
                 shouldupdate = true;
             }else // btn up
             {
                 Mouse::Stop();
-                    commands_.erase("click roll");
+                    cursor_commands_.erase("click roll");
                 shouldupdate = false;
             }
             return true;
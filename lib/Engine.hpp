@@ -1,19 +1,63 @@
 #pragma once
 
 #include "ngn_command.hpp"
+#include "frame_snapshot.hpp"
 //common lib
 #include <baseclass.hpp>
 #include <mytypes.hpp>
 #include <camera.hpp>
 #include <vertex.h>
 #include <multiplatform_input.hpp>
+#include <triple_buffer.hpp>
+#include <job_system.hpp>
+#include <scene_graph.hpp>
+#include <bvh.hpp>
+#include <scene_file.hpp>
+#include <archetype.hpp>
+#include <resolution_scaler.hpp>
 //std
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 #include <memory>
 
 
 class Window;
 
+// stable reference to a renderable, unaffected by spawn and destroy of other objects
+using ObjectHandle = ngn::Entity;
+
+// renderable components, one packed column each in Engine::renderables_
+// gpu buffers, with the names and triangles read only by the ui and picking
+using MeshComponent = std::unique_ptr<RenderObject>;
+// shader of the object, resolved once when the object is added
+using MaterialComponent = Shader*;
+// sphere test result, scratch of the culling
+using VisibilityComponent = uint8_t;
+
+// scene graph nodes of a renderable
+struct TransformComponent
+{
+    // edited by the ui
+    ngn::NodeId node{ngn::NO_PARENT};
+    // child of node holding the model up matrix, its world matrix is the model matrix
+    ngn::NodeId meshNode{ngn::NO_PARENT};
+};
+
+// model space bounds, moved to the world space ngn::Aabb and ngn::Sphere columns when meshNode changes
+struct LocalBoundsComponent
+{
+    ngn::Aabb box{};
+    ngn::Sphere sphere{};
+};
+
+using Renderables = ngn::Archetype<MeshComponent, MaterialComponent, TransformComponent, LocalBoundsComponent,
+                                   ngn::Aabb, ngn::Sphere, VisibilityComponent>;
+
 class Engine
 {    
 public:
@@ -23,12 +67,51 @@ public:
     static std::unique_ptr<Engine> create(EngineType type);
     void run();
 
+    /**
+     * @brief Record and submit the frames on a dedicated render thread, to be set before run()
+     *        The main thread simulates frame N+1 while the renderer draws frame N
+     */
+    static void setRenderThread(bool enable) { useRenderThread_ = enable; }
+
+    /**
+     * @brief Scene loaded at startup, json or compiled binary, to be set before create()
+     */
+    static void setScenePath(std::string path) { scenePath_ = std::move(path); }
+
+    /**
+     * @brief Load a model and add it to the scene, from the main thread between frames
+     *        The gpu side is built on the render side, the object is drawn from the next snapshot
+     *
+     * @param path obj file
+     * @param shader one of the loaded shaders, e.g. "phong"
+     * @return handle valid until destroy()
+     */
+    ObjectHandle spawn(const std::string &path, const std::string &shader, const Transformations &tra = {}, Model::UP up = Model::UP::YUP);
+
+    /**
+     * @brief Remove an object from the scene, its gpu resources are released once no frame in flight uses them
+     *
+     * @return false if the handle was already destroyed or other nodes are attached to the object
+     */
+    bool destroy(ObjectHandle handle);
+    bool alive(ObjectHandle handle) const;
+    ObjectHandle handleOf(size_t index) const;
+
 protected:
 
     void init_shaders();
     void init_fixed_shaders();
     void init_fixed();
     void init_renderables();
+    /**
+     * @brief Take ownership of a built object and add its nodes, bounds and handle
+     *
+     * @param parent node of the object node
+     */
+    ObjectHandle addRenderable(std::unique_ptr<RenderObject> object, const Model &model,
+                               ngn::NodeId parent = ngn::NO_PARENT);
+    // picking triangles of the model, built once per model file
+    std::shared_ptr<const ngn::MeshBvh> pickMesh(const Model &model);
     void draw_UiOverlay();
  
     /**
@@ -48,20 +131,42 @@ protected:
 
     UniformBufferObject getMVP();
 
+    // snapshot being drawn, only valid inside draw() and resizeFrame()
+    const FrameSnapshot *frame_ = nullptr;
+
     ngn::MultiplatformInput input_{};
     EngineType engine_type_{};
+    // worker pool shared by the engine systems, destroyed after the members declared below it
+    ngn::JobSystem jobs_{};
 
     std::unordered_map< std::string, std::unique_ptr<Shader> > shaders_;
     std::unordered_map< std::string, std::unique_ptr<Shader> > fixed_shaders_;
     std::unordered_map< std::string, std::unique_ptr<RenderObject> > fixed_objects_;
-    std::vector< std::unique_ptr<RenderObject> > renderables_;
+    // changed only on the render side, rows are the indices used by the snapshots
+    Renderables renderables_{};
+    ngn::SceneGraph scene_{};
+    // rows whose bounds changed in the last updateBounds()
+    std::vector<uint32_t> moved_{};
+    // over the world bounds column, refitted with moved_ every frame
+    ngn::Bvh bvh_{};
+    // by model path, alive as long as an object uses them
+    std::unordered_map<std::string, std::weak_ptr<const ngn::MeshBvh>> pickMeshes_{};
+    // renderables were added or removed: items no longer match the tree
+    bool rebuildBvh_ = false;
     
     glm::vec4 background{0.2f, 0.3f, 0.3f, 1.0f};
+    // simulated camera, updated by the fixed steps
     Camera ourCamera{};
+    // camera used for rendering, interpolated between the last two fixed steps
+    Camera renderCamera_{};
     std::unique_ptr<Window> window_;
 
     size_t model_index_{0};
+    // object shown by the transform editor, set by the ui combo or by picking
+    size_t selected_{0};
     const bool ui_Overlay_ = true;
+    // scene resolution, updated by the backends from the gpu frame time of each drawn frame
+    ngn::ResolutionScaler resolution_{};
 
     UniformBufferObject uniformBuffer_;
     
@@ -73,13 +178,61 @@ private:
 
     virtual void draw() = 0;
     virtual void resizeFrame() = 0;
+    // platform side of the ui frame, called by the main thread before the ui is built
+    virtual void newUiFrame() = 0;
+    /**
+     * @brief Release the gpu resources of a destroyed object, called on the render side between frames
+     *        Opengl names can go at once: the driver keeps them alive for the queued commands
+     */
+    virtual void retire(std::unique_ptr<RenderObject> object) { object.reset(); }
+
+    void buildSnapshot(FrameSnapshot &frame, uint64_t frameNumber);
+    void updateBounds();
+    void cullRenderables(FrameSnapshot &frame);
+    void pickObject(const UniformBufferObject &mvp, std::pair<float, float> cursor);
+    void renderFrame(const FrameSnapshot &frame);
+    void renderLoop();
+    void startRenderThread();
+    void stopRenderThread();
+    void waitConsumed(uint64_t frameNumber);
+    // run on the thread owning the graphics context while no frame is recorded, blocks the main thread
+    void runOnRenderer(const std::function<void()> &task);
+    std::unique_ptr<RenderObject> removeRenderable(ObjectHandle handle);
 
     void updateEvents();
+    void fixedUpdate();
+    void interpolateCamera(float alpha);
     void MapActions();
     void setWindowMessage(std::string msg);
 
+    // keyboard commands, executed once per fixed step
     std::unordered_map<std::string, std::unique_ptr<ngn::Command>> commands_{};
+    // mouse drag commands, executed once per frame with the cursor movement
+    std::unordered_map<std::string, std::unique_ptr<ngn::Command>> cursor_commands_{};
+    CameraState previousCamera_{};
     bool shouldupdate = false;
+    // resize seen by the main thread, forwarded with the next snapshot
+    bool resizePending_ = false;
+    // left button press position, a release close to it is a click that picks an object
+    std::pair<float, float> pressCursor_{};
+    bool pickPending_ = false;
+
+    inline static bool useRenderThread_ = false;
+    inline static std::string scenePath_ = "data/scenes/default.json";
+    // materials read by init_shaders(), nodes by init_renderables()
+    ngn::SceneFile sceneFile_{};
+    ngn::TripleBuffer<FrameSnapshot> snapshots_{};
+    std::thread renderer_{};
+    std::atomic<bool> rendering_{false};
+    // last snapshot published by the main thread and last one acquired by the renderer
+    std::atomic<uint64_t> published_{0};
+    std::atomic<uint64_t> consumed_{0};
+    // bumped to wake the renderer, by a new snapshot or by a task
+    std::atomic<uint64_t> wake_{0};
+    const std::function<void()> *renderTask_ = nullptr;
+    uint64_t tasksPosted_ = 0;
+    std::atomic<uint64_t> tasksDone_{0};
+    std::exception_ptr renderError_{};
 
     static std::unique_ptr<Engine> makeVulkan(EngineType type);
     static std::unique_ptr<Engine> makeOpengl(EngineType type);
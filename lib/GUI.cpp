@@ -1,8 +1,18 @@
 #include "GUI.h"
+// common lib
+#include <profiler.hpp>
+#include <resolution_scaler.hpp>
+#include <display_settings.hpp>
+#include <utils.hpp>
 //lib
 #include <imgui.h>
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtx/euler_angles.hpp>
+//std
+#include <cfloat>
+#include <cstdio>
+#include <cstring>
+#include <chrono>
 
 namespace GUI
 {
@@ -11,15 +21,71 @@ const float TRA_min = -1.0f; const float TRA_max = 1.0f;  const float TRA_step =
 const float ROT_min = 0.0f;  const float ROT_max = 360.0f;const float ROT_step = 1.0f;
 const float SCA_min = 0.0f;  const float SCA_max = 10.0f; const float SCA_step = 0.1f;
 
+const float MiB = 1024.0f * 1024.0f;
+
+template<typename T>
+static void CopyVector(ImVector<T> &dst, const ImVector<T> &src)
+{
+    // resize keeps the capacity, ImVector::operator= would free and reallocate
+    dst.resize(src.Size);
+    if(src.Size){
+        memcpy(dst.Data, src.Data, src.size_in_bytes());
+    }
+}
+
+void DrawDataCopy::copy(const ImDrawData *src)
+{
+    if(!src || !src->Valid){
+        data_.Clear();
+        return;
+    }
+
+    while(lists_.size() < static_cast<size_t>(src->CmdListsCount)){
+        lists_.push_back(std::make_unique<ImDrawList>(ImGui::GetDrawListSharedData()));
+        listPtrs_.push_back(lists_.back().get());
+    }
+
+    for(int i = 0; i < src->CmdListsCount; i++){
+        const ImDrawList *srcList = src->CmdLists[i];
+        ImDrawList *dstList = lists_[i].get();
+
+        CopyVector(dstList->CmdBuffer, srcList->CmdBuffer);
+        CopyVector(dstList->IdxBuffer, srcList->IdxBuffer);
+        CopyVector(dstList->VtxBuffer, srcList->VtxBuffer);
+        dstList->Flags = srcList->Flags;
+    }
+
+    data_ = *src;
+    data_.CmdLists = listPtrs_.data();
+}
+
+static void PlotHistory(const char *label, const ngn::FrameHistory &history)
+{
+    if(history.empty()){
+        return;
+    }
+    char overlay[32];
+    snprintf(overlay, sizeof(overlay), "%.3f ms", history.latest());
+    ImGui::PlotLines(label, history.data(), static_cast<int>(history.size()), static_cast<int>(history.offset()),
+                     overlay, 0.0f, FLT_MAX, ImVec2(0, 60.0f));
+}
+
+
+void NewFrame()
+{
+    ImGui::NewFrame();
+}
+
+void Render()
+{
+    ImGui::Render();
+}
 
 bool ObjectNode(Transformations &transf, std::vector<std::string> &items, size_t &item_current_idx)
 {
     assert(item_current_idx <= items.size() && " current_item out of range");
     bool retval = false;
     
-    // render your GUI
-    ImGui::NewFrame();
-
     ImGui::Begin("Model trasfromations");         
         
         {
@@ -63,13 +129,146 @@ bool ObjectNode(Transformations &transf, std::vector<std::string> &items, size_t
             
         }
     ImGui::End();
-  
-    ImGui::Render();
 
     return retval;
 }
+
+ObjectAction ObjectActions(bool canRemove)
+{
+    ObjectAction action = ObjectAction::NONE;
+
+    // same window of ObjectNode
+    ImGui::Begin("Model trasfromations");
+
+        ImGui::Separator();
+        if(ImGui::Button("duplicate")){
+            action = ObjectAction::DUPLICATE;
+        }
+        ImGui::SameLine();
+        ImGui::BeginDisabled(!canRemove);
+        if(ImGui::Button("remove")){
+            action = ObjectAction::REMOVE;
+        }
+        ImGui::EndDisabled();
+
+    ImGui::End();
+
+    return action;
+}
+
+void GpuTimings(float cpuFrameTime)
+{
+    ImGui::Begin("Gpu timings");
+
+        ImGui::Text("cpu frame  %.3f ms", cpuFrameTime);
+        ImGui::Text("gpu frame  %.3f ms", ngn::Profiler::getGpuFrameTime());
+        ImGui::Separator();
+
+        if (ImGui::BeginTable("passes", 5))
+        {
+            ImGui::TableSetupColumn("pass");
+            ImGui::TableSetupColumn("ms");
+            ImGui::TableSetupColumn("primitives");
+            ImGui::TableSetupColumn("vs invocations");
+            ImGui::TableSetupColumn("fs invocations");
+            ImGui::TableHeadersRow();
+
+            for (uint32_t i = 0; i < ngn::GPU_PASS_COUNT; i++)
+            {
+                auto pass = static_cast<ngn::GpuPass>(i);
+                const ngn::GpuPassStats stats = ngn::Profiler::getGpuPass(pass);
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn(); ImGui::TextUnformatted(ngn::Profiler::getPassName(pass));
+                ImGui::TableNextColumn(); ImGui::Text("%.3f", stats.timeMs);
+                ImGui::TableNextColumn(); ImGui::Text("%llu", static_cast<unsigned long long>(stats.primitives));
+                ImGui::TableNextColumn(); ImGui::Text("%llu", static_cast<unsigned long long>(stats.vertexInvocations));
+                ImGui::TableNextColumn(); ImGui::Text("%llu", static_cast<unsigned long long>(stats.fragmentInvocations));
+            }
+            ImGui::EndTable();
+        }
+
+    ImGui::End();
+}
     
-} // namespace name
+void PerformanceHud()
+{
+    // cost of the hud itself, measured on the previous frame
+    static float hudTime = 0.f;
+    auto tStart = std::chrono::high_resolution_clock::now();
+
+    ImGui::Begin("Performance");
+
+        PlotHistory("cpu", ngn::Profiler::getCpuHistory());
+        PlotHistory("gpu", ngn::Profiler::getGpuHistory());
+
+        ImGui::Text("jitter     %.3f ms", ngn::Time::getJitter());
+        int frameLimit = static_cast<int>(ngn::Time::getFrameLimit());
+        if(ImGui::SliderInt("fps cap", &frameLimit, 0, 240, frameLimit ? "%d" : "off")){
+            ngn::Time::setFrameLimit(static_cast<uint32_t>(frameLimit));
+        }
+        float targetMs = ngn::ResolutionScaler::getTargetFrameTime();
+        if(ImGui::SliderFloat("gpu target", &targetMs, 0.f, 33.f, targetMs > 0.f ? "%.1f ms" : "off")){
+            ngn::ResolutionScaler::setTargetFrameTime(targetMs);
+        }
+        ImGui::Text("scale      %.0f %%", ngn::Profiler::getRenderScale() * 100.f);
 
+        // applied by the renderer at the start of its next frame
+        const ngn::DisplayState display = ngn::Display::get();
+        static const char* sampleNames[] = {"1", "2", "4", "8"};
+        int sampleIndex = display.samples >= 8 ? 3 : display.samples >= 4 ? 2 : display.samples >= 2 ? 1 : 0;
+        if(ImGui::Combo("msaa", &sampleIndex, sampleNames, IM_ARRAYSIZE(sampleNames))){
+            ngn::Display::setSamples(1u << sampleIndex);
+        }
+        bool vsync = display.vsync;
+        if(ImGui::Checkbox("vsync", &vsync)){
+            ngn::Display::setVsync(vsync);
+        }
+        if(ImGui::BeginCombo("present", ngn::Display::getPresentModeName(display.presentMode))){
+            for(uint32_t i = 0; i < static_cast<uint32_t>(ngn::PresentMode::COUNT); i++){
+                auto mode = static_cast<ngn::PresentMode>(i);
+                if(ImGui::Selectable(ngn::Display::getPresentModeName(mode), mode == display.presentMode)){
+                    ngn::Display::setPresentMode(mode);
+                }
+            }
+            ImGui::EndCombo();
+        }
+
+        const ngn::FrameCounters counters = ngn::Profiler::getCounters();
+        ImGui::Separator();
+        ImGui::Text("draws      %u", counters.draws);
+        ImGui::Text("binds      %u", counters.binds);
+        if(counters.stateIssued || counters.stateFiltered){
+            ImGui::Text("state      %u set %u skipped", counters.stateIssued, counters.stateFiltered);
+        }
+        ImGui::Text("triangles  %llu", static_cast<unsigned long long>(counters.triangles));
+        const ngn::CullingCounters culling = ngn::Profiler::getCulling();
+        ImGui::Text("visible    %u / %u", culling.visible, culling.total);
+
+        ImGui::Separator();
+        ImGui::Text("textures   %.2f MiB", ngn::Profiler::getTextureBytes() / MiB);
+        ImGui::Text("meshes     %.2f MiB", ngn::Profiler::getMeshBytes() / MiB);
+
+        ImGui::Separator();
+        if(ngn::Profiler::getHeapCount() == 0){
+            ImGui::TextUnformatted("heap budgets not available");
+        }
+        for(uint32_t i = 0; i < ngn::Profiler::getHeapCount(); i++){
+            const ngn::HeapBudget heap = ngn::Profiler::getHeapBudget(i);
+            float fraction = heap.budget ? static_cast<float>(heap.usage) / heap.budget : 0.f;
+
+            char overlay[64];
+            snprintf(overlay, sizeof(overlay), "%.1f / %.1f MiB", heap.usage / MiB, heap.budget / MiB);
+            ImGui::Text("heap %u %s", i, heap.deviceLocal ? "device" : "host");
+            ImGui::ProgressBar(fraction, ImVec2(-1.0f, 0.0f), overlay);
+        }
 
- 
\ No newline at end of file
+        ImGui::Separator();
+        ImGui::Text("hud        %.3f ms", hudTime);
+
+    ImGui::End();
+
+    hudTime = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - tStart).count();
+}
+    
+} // namespace name
@@ -1,12 +1,62 @@
 #pragma once
 #include <model.hpp>
+//lib
+#include <imgui.h>
+//std
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace GUI
 {
+    /**
+     * @brief Deep copy of the ImGui draw data, owned by a frame snapshot
+     *        so the render thread can draw it while the main thread builds the next ui.
+     *        Draw lists and their buffers are reused, no allocation once capacity is reached
+     */
+    class DrawDataCopy
+    {
+    public:
+        DrawDataCopy() = default;
+        DrawDataCopy(const DrawDataCopy &) = delete;
+        DrawDataCopy &operator=(const DrawDataCopy &) = delete;
+
+        void copy(const ImDrawData *src);
+        // the imgui backends take a non const pointer but only read the draw data
+        ImDrawData* get() const { return data_.Valid ? &data_ : nullptr; }
+
+    private:
+        mutable ImDrawData data_{};
+        std::vector<std::unique_ptr<ImDrawList>> lists_{};
+        std::vector<ImDrawList*> listPtrs_{};
+    };
+
+    void NewFrame();
+    void Render();
 
     bool ObjectNode(Transformations &transf, std::vector<std::string> &items, size_t &item_current_idx);
+
+    enum class ObjectAction { NONE, DUPLICATE, REMOVE };
+
+    /**
+     * @brief Buttons under the transform editor acting on the selected object
+     * 
+     * @param canRemove false to disable the remove button
+     */
+    ObjectAction ObjectActions(bool canRemove);
+
+    /**
+     * @brief Show the latest cpu frame time and gpu pass timings of ngn::Profiler
+     * 
+     * @param cpuFrameTime milliseconds
+     */
+    void GpuTimings(float cpuFrameTime);
+
+    /**
+     * @brief Frame time graphs, draw counters and memory usage of ngn::Profiler
+     * 
+     */
+    void PerformanceHud();
     
     
 } // namespace name
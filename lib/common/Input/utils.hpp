@@ -1,10 +1,14 @@
 #pragma once
 
+//common lib
+#include <ring_buffer.hpp>
 //lib
 #include <glm/glm.hpp>
 //std
 #include <string>
 #include <chrono>
+#include <cmath>
+#include <thread>
 
 namespace ngn
 {
@@ -30,36 +34,88 @@ struct Feed{
 
 struct Time{
 private:
-    // Time between current frame and last frame
+    using Clock = std::chrono::high_resolution_clock;
+
+    // Time between the start of the current frame and the start of the previous one
     inline static float     frameTime    = 1.0f;
+    // Time spent in the last frame
+    inline static float     cpuFrameTime = 0.f;
     inline static float     fpsTimer     = 0.f; 
     inline static uint32_t  lastFPS      = 0;
-    inline static uint32_t  frameCounter = 0;;
-    inline static std::chrono::time_point<std::chrono::high_resolution_clock>  tStart;
-    inline static std::chrono::time_point<std::chrono::high_resolution_clock>  lastTimestamp;
+    inline static uint32_t  frameCounter = 0;
+    inline static bool      firstFrame   = true;
+    inline static std::chrono::time_point<Clock>  tStart;
+    inline static std::chrono::time_point<Clock>  lastTimestamp;
+
+    // frame pacing
+    inline static float     frameLimit   = 0.f;
+    inline static float     jitter       = 0.f;
+    inline static RingBuffer<float, 120> frameTimes{};
+
+    // sleep granularity, the rest of the wait is a busy loop
+    static constexpr auto   SPIN_MARGIN  = std::chrono::milliseconds(2);
 
 public:
+    // simulation step in milliseconds (120 Hz)
+    static constexpr float  FIXED_STEP     = 1000.0f / 120.0f;
+    // max simulated time per frame, avoid the spiral of death after a stall
+    static constexpr float  MAX_FRAME_STEP = 250.0f;
+
     /**
-     * @brief Get the Frame Time object
+     * @brief Get the Frame Time object, updated on every start()
      * 
-     * @return float 
+     * @return float milliseconds between the last two frames
      */
     static float getFrameTime(){ return frameTime; }
 
+    /**
+     * @brief Get the duration of the last frame, updated on every end()
+     * 
+     * @return float milliseconds
+     */
+    static float getCpuFrameTime(){ return cpuFrameTime; }
+
+    /**
+     * @brief Frame pacing jitter, standard deviation of the last frame times
+     * 
+     * @return float milliseconds
+     */
+    static float getJitter(){ return jitter; }
+
     static bool time(){ return (fpsTimer >=1000.0); }
 
     static uint32_t geFps(){ return lastFPS; }
 
-    static void start() { tStart = std::chrono::high_resolution_clock::now(); }
+    /**
+     * @brief Cap the frame rate, waiting in limitFrame()
+     * 
+     * @param fps 0 means unlimited
+     */
+    static void setFrameLimit(uint32_t fps){ frameLimit = fps ? 1000.0f / fps : 0.f; }
+    static uint32_t getFrameLimit(){ return frameLimit > 0.f ? static_cast<uint32_t>(1000.0f / frameLimit + 0.5f) : 0; }
+
+    static void start() 
+    { 
+        auto now = Clock::now();
+        if(firstFrame){
+            firstFrame = false;
+            lastTimestamp = now;
+        }else{
+            frameTime = std::chrono::duration<float, std::milli>(now - tStart).count();
+            frameTimes.push(frameTime);
+            updateJitter();
+        }
+        tStart = now;
+    }
 
     static void end() 
     {   
         frameCounter++;
-        auto tEnd = std::chrono::high_resolution_clock::now();
+        auto tEnd = Clock::now();
+        cpuFrameTime = std::chrono::duration<float, std::milli>(tEnd - tStart).count();
 	    fpsTimer = std::chrono::duration<float, std::milli>(tEnd - lastTimestamp).count();
         if (fpsTimer >= 1000.0 ) // If more than 1 sec ago
         { 
-	        frameTime = std::chrono::duration<float, std::milli>(tEnd - tStart).count();
             lastFPS = static_cast<uint32_t>((float)frameCounter * (1000.0f / fpsTimer));
 
             frameCounter = 0;
@@ -67,7 +123,46 @@ public:
         }
     }
 
+    /**
+     * @brief Wait until the frame limit since the last start(): 
+     *        sleep for most of the time then spin for precision
+     * 
+     */
+    static void limitFrame()
+    {
+        if(frameLimit <= 0.f){
+            return;
+        }
+        auto target = tStart + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float, std::milli>(frameLimit));
+
+        auto remaining = target - Clock::now();
+        if(remaining > SPIN_MARGIN){
+            std::this_thread::sleep_for(remaining - SPIN_MARGIN);
+        }
+        while(Clock::now() < target){
+            std::this_thread::yield();
+        }
+    }
 
+private:
+
+    static void updateJitter()
+    {
+        float mean = 0.f;
+        for(size_t i = 0; i < frameTimes.size(); i++){
+            mean += frameTimes[i];
+        }
+        mean /= frameTimes.size();
+
+        float variance = 0.f;
+        for(size_t i = 0; i < frameTimes.size(); i++){
+            float d = frameTimes[i] - mean;
+            variance += d * d;
+        }
+        jitter = std::sqrt(variance / frameTimes.size());
+    }
+
+public:
 
    /**
      * @brief Update timeframe calculation
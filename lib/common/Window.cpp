@@ -65,7 +65,8 @@ void Window::initWindow()
         glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4); // We want OpenGL 4.5
         glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 5);
         glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE); // We don't want the old OpenGL
-        glfwWindowHint(GLFW_SAMPLES, 2); // try to get max MSAA
+        // multisampling is done by the scene target, the upscale blit needs a single sampled window
+        glfwWindowHint(GLFW_SAMPLES, 0);
 
         #ifdef _DEBUG
         glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, true); // require debug context  
@@ -221,17 +222,51 @@ void Window::swapBuffers()
     glfwSwapBuffers(window_); 
 }
 
+void Window::makeContextCurrent()
+{
+    if(engineType == EngineType::Opengl){
+        glfwMakeContextCurrent(window_);
+    }
+}
+
+void Window::releaseContext()
+{
+    if(engineType == EngineType::Opengl){
+        glfwMakeContextCurrent(nullptr);
+    }
+}
+
+GLFWwindow* Window::createSharedContext()
+{
+    if(engineType != EngineType::Opengl){
+        return nullptr;
+    }
+    // same context hints as the main window, glfw keeps the current context
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    GLFWwindow *context = glfwCreateWindow(1, 1, "loader", nullptr, window_);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+    return context;
+}
+
+void Window::destroySharedContext(GLFWwindow *context)
+{
+    if(context){
+        glfwDestroyWindow(context);
+    }
+}
+
 void Window::update()
 {
     glfwPollEvents();
 
-    if((is_resized = Input->winstat_.resized))
+    is_resized = Input->winstat_.resized;
+    if(is_resized)
     {
         width_      = Input->winstat_.w;
         height_     = Input->winstat_.h;       
         Input->winstat_.resized = false;
         assert(width_ && height_);
-        spdlog::info("cb window resized {} {}",width_, height_ );    
+        spdlog::info("cb window resized {} {}",width_.load(), height_.load() );    
     }
 
     // loop to skip iconized state
@@ -2,6 +2,7 @@
 #include "mytypes.hpp"
 // lib
 //std
+#include <atomic>
 #include <string>
 
 const int WIDTH = 800;
@@ -28,12 +29,24 @@ public:
     void init(EngineType type);
     void update();
     void swapBuffers();
+    /**
+     * @brief Opengl only: bind or release the context on the calling thread,
+     *        a context can be current on one thread at a time
+     */
+    void makeContextCurrent();
+    void releaseContext();
+    /**
+     * @brief Opengl only: hidden window whose context shares the objects of this one,
+     *        to be made current on a loader thread. Created and destroyed by the main thread
+     */
+    GLFWwindow* createSharedContext();
+    void destroySharedContext(GLFWwindow *context);
     void registerCallbacks(ngn::MultiplatformInput &input);
     inline void setWindowMessage(std::string msg) { SetWindowTitle(msg); }
 
     GLFWwindow* getWindowPtr();
-    inline float getWindowAspect() { return (float) width_ / (float) height_; }
-    inline std::pair<uint32_t, uint32_t> extents() { return {width_ ,height_}; }
+    inline float getWindowAspect() { return (float) width_.load() / (float) height_.load(); }
+    inline std::pair<uint32_t, uint32_t> extents() { return {width_.load() ,height_.load()}; }
 
 
 
@@ -44,13 +57,14 @@ private:
     void SetWindowTitle(std::string msg = "");
 
 
-    int width_{WIDTH};
-    int height_{HEIGTH};
+    // written by the main thread in update(), read by the render thread
+    std::atomic<int> width_{WIDTH};
+    std::atomic<int> height_{HEIGTH};
     std::string windowName_ = {};
     EngineType  engineType;
     ngn::MultiplatformInput *Input;
 
-    bool is_resized = false;
+    std::atomic<bool> is_resized = false;
 
     GLFWwindow* window_ = nullptr;
 };
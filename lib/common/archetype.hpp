@@ -0,0 +1,144 @@
+#pragma once
+
+//std
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace ngn
+{
+
+/**
+ * @brief Stable reference to an entity of an Archetype, unaffected by create and destroy of other entities.
+ *        The generation tells a destroyed entity from a later one reusing its slot
+ */
+struct Entity
+{
+    uint32_t slot{UINT32_MAX};
+    uint32_t generation{0};
+};
+
+/**
+ * @brief Entities with the same set of components, one packed array per component type.
+ *        Row i of every column belongs to the same entity; a sparse array of slots maps entities to rows.
+ *        destroy() moves the last row into the hole, so columns never have gaps and a system
+ *        walks only the arrays of the components it reads
+ *
+ * @tparam Components distinct types, one column each
+ */
+template<typename... Components>
+class Archetype
+{
+public:
+    static constexpr uint32_t NO_ROW = UINT32_MAX;
+
+    Archetype() = default;
+
+    Archetype(const Archetype &) = delete;
+    Archetype &operator=(const Archetype &) = delete;
+
+    /**
+     * @brief Append a row, O(1)
+     *
+     * @return entity valid until destroy()
+     */
+    Entity create(Components... components)
+    {
+        uint32_t slot = 0;
+        if(freeSlots_.empty()){
+            slot = static_cast<uint32_t>(slots_.size());
+            slots_.push_back({});
+        }else{
+            slot = freeSlots_.back();
+            freeSlots_.pop_back();
+        }
+        (std::get<std::vector<Components>>(columns_).push_back(std::move(components)), ...);
+        slots_[slot].row = static_cast<uint32_t>(entities_.size());
+        entities_.push_back(slot);
+        return {slot, slots_[slot].generation};
+    }
+
+    /**
+     * @brief Remove the row of entity, the last row takes its place, O(1)
+     *
+     * @return false if entity was already destroyed
+     */
+    bool destroy(Entity entity)
+    {
+        if(!alive(entity)){
+            return false;
+        }
+        const uint32_t row = slots_[entity.slot].row;
+        const uint32_t last = static_cast<uint32_t>(entities_.size() - 1);
+        if(row != last){
+            ((std::get<std::vector<Components>>(columns_)[row] = std::move(std::get<std::vector<Components>>(columns_)[last])), ...);
+            entities_[row] = entities_[last];
+            slots_[entities_[row]].row = row;
+        }
+        (std::get<std::vector<Components>>(columns_).pop_back(), ...);
+        entities_.pop_back();
+
+        slots_[entity.slot].row = NO_ROW;
+        slots_[entity.slot].generation++;
+        freeSlots_.push_back(entity.slot);
+        return true;
+    }
+
+    bool alive(Entity entity) const
+    {
+        return entity.slot < slots_.size() && slots_[entity.slot].generation == entity.generation &&
+               slots_[entity.slot].row != NO_ROW;
+    }
+
+    // current row of entity, NO_ROW once destroyed
+    uint32_t row(Entity entity) const { return alive(entity) ? slots_[entity.slot].row : NO_ROW; }
+    Entity entity(size_t row) const
+    {
+        const uint32_t slot = entities_.at(row);
+        return {slot, slots_[slot].generation};
+    }
+
+    size_t size() const { return entities_.size(); }
+    bool empty() const { return entities_.empty(); }
+
+    void reserve(size_t count)
+    {
+        (std::get<std::vector<Components>>(columns_).reserve(count), ...);
+        entities_.reserve(count);
+    }
+
+    // destroy every entity, handles given so far stay dead
+    void clear()
+    {
+        while(!entities_.empty()){
+            destroy(entity(entities_.size() - 1));
+        }
+    }
+
+    /**
+     * @brief Packed components of every row, invalidated by create() and destroy()
+     */
+    template<typename C>
+    std::span<C> column() { return std::get<std::vector<C>>(columns_); }
+
+    template<typename C>
+    std::span<const C> column() const { return std::get<std::vector<C>>(columns_); }
+
+private:
+    struct Slot
+    {
+        uint32_t row{NO_ROW};
+        uint32_t generation{0};
+    };
+
+    std::tuple<std::vector<Components>...> columns_{};
+    // slot of every row
+    std::vector<uint32_t> entities_{};
+    std::vector<Slot> slots_{};
+    std::vector<uint32_t> freeSlots_{};
+};
+
+} // namespace ngn
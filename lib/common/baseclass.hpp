@@ -2,6 +2,7 @@
 //common
 #include "glsl_constants.h"
 #include "model.hpp"
+#include "mesh_bvh.hpp"
 //libs
 #include <glm/glm.hpp>
 //std
@@ -53,5 +54,9 @@ public:
     std::string shader;
 
     std::string objName;
-    Node objNode{};
+    // source of the object, to spawn copies of it
+    std::string modelPath;
+    Model::UP modelUp{Model::UP::YUP};
+    // model triangles for picking, shared by the objects of the same model
+    std::shared_ptr<const ngn::MeshBvh> pickMesh{};
 };
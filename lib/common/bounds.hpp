@@ -0,0 +1,52 @@
+#pragma once
+
+//lib
+#include <glm/glm.hpp>
+//std
+#include <limits>
+
+namespace ngn
+{
+
+/**
+ * @brief Axis aligned bounding box, empty until the first expand()
+ *
+ */
+struct Aabb
+{
+    glm::vec3 min{ std::numeric_limits<float>::max()};
+    glm::vec3 max{-std::numeric_limits<float>::max()};
+
+    bool valid() const { return min.x <= max.x && min.y <= max.y && min.z <= max.z; }
+
+    void expand(const glm::vec3 &point){
+        min = glm::min(min, point);
+        max = glm::max(max, point);
+    }
+
+    void expand(const Aabb &other){
+        min = glm::min(min, other.min);
+        max = glm::max(max, other.max);
+    }
+
+    glm::vec3 center() const { return (min + max) * 0.5f; }
+    glm::vec3 extent() const { return (max - min) * 0.5f; }
+    // surface area, the SAH weight of a box
+    float area() const {
+        const glm::vec3 d = max - min;
+        return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+};
+
+/**
+ * @brief Bounding sphere, 16 bytes: loaded as one simd register by the batch kernels
+ *
+ */
+struct Sphere
+{
+    glm::vec3 center{0.0f};
+    float radius{0.0f};
+};
+static_assert(sizeof(Sphere) == 4 * sizeof(float), "Sphere must be tightly packed");
+
+} // namespace ngn
@@ -0,0 +1,319 @@
+#include "bvh.hpp"
+//std
+#include <algorithm>
+
+namespace ngn
+{
+
+namespace
+{
+    // SAH weights of one node visit and one item test
+    constexpr float TRAVERSAL_COST = 1.0f;
+    constexpr float INTERSECTION_COST = 1.0f;
+    // marks a stack entry whose node is fully inside the frustum
+    constexpr uint32_t INSIDE_BIT = 0x80000000u;
+
+    bool sameBounds(const Aabb &a, const Aabb &b)
+    {
+        return a.min == b.min && a.max == b.max;
+    }
+
+    uint32_t binOf(float centroid, float min, float scale)
+    {
+        const auto bin = static_cast<uint32_t>((centroid - min) * scale);
+        return std::min(bin, Bvh::SAH_BINS - 1);
+    }
+}
+
+void Bvh::build(const Aabb *boxes, size_t count)
+{
+    nodes_.clear();
+    parents_.clear();
+    items_.resize(count);
+    itemLeaf_.assign(count, 0);
+    cost_ = 0.0f;
+    buildCost_ = 0.0f;
+    depth_ = 0;
+
+    if(count == 0){
+        return;
+    }
+
+    scratch_.resize(count);
+    for(size_t i = 0; i < count; i++){
+        scratch_[i] = {boxes[i], boxes[i].center(), static_cast<uint32_t>(i)};
+    }
+
+    nodes_.reserve(2 * count / MAX_LEAF_ITEMS + 1);
+    parents_.reserve(nodes_.capacity());
+    nodes_.push_back({Aabb{}, 0, static_cast<uint32_t>(count)});
+    parents_.push_back(NO_ITEM);
+
+    // iterative, unbalanced splits can go deeper than the call stack
+    struct Pending { uint32_t node; uint32_t depth; };
+    std::vector<Pending> pending{{0, 1}};
+    while(!pending.empty()){
+        const Pending next = pending.back();
+        pending.pop_back();
+        depth_ = std::max(depth_, next.depth);
+
+        if(split(next.node, next.depth)){
+            const uint32_t left = nodes_[next.node].first;
+            pending.push_back({left, next.depth + 1});
+            pending.push_back({left + 1, next.depth + 1});
+        }
+    }
+
+    for(size_t i = 0; i < count; i++){
+        items_[i] = scratch_[i].item;
+    }
+    for(uint32_t n = 0; n < nodes_.size(); n++){
+        const BvhNode &node = nodes_[n];
+        for(uint32_t i = node.first; node.leaf() && i < node.first + node.count; i++){
+            itemLeaf_[items_[i]] = n;
+        }
+    }
+
+    cost_ = totalCost();
+    buildCost_ = cost();
+}
+
+bool Bvh::split(uint32_t index, uint32_t depth)
+{
+    const uint32_t first = nodes_[index].first;
+    const uint32_t count = nodes_[index].count;
+    BuildItem *begin = scratch_.data() + first;
+    BuildItem *end = begin + count;
+
+    Aabb bounds{};
+    Aabb centers{};
+    for(const BuildItem *it = begin; it != end; it++){
+        bounds.expand(it->bounds);
+        centers.expand(it->centroid);
+    }
+    nodes_[index].bounds = bounds;
+
+    if(count <= MAX_LEAF_ITEMS || depth >= MAX_DEPTH){
+        return false;
+    }
+
+    // the three axes are binned in the same pass
+    struct Bin { Aabb bounds; uint32_t count; };
+    Bin bins[3][SAH_BINS]{};
+    const glm::vec3 extent = centers.max - centers.min;
+    float scale[3];
+    for(int axis = 0; axis < 3; axis++){
+        scale[axis] = extent[axis] > 0.0f ? SAH_BINS / extent[axis] : 0.0f;
+    }
+    for(const BuildItem *it = begin; it != end; it++){
+        for(int axis = 0; axis < 3; axis++){
+            Bin &bin = bins[axis][binOf(it->centroid[axis], centers.min[axis], scale[axis])];
+            bin.bounds.expand(it->bounds);
+            bin.count++;
+        }
+    }
+
+    float bestCost = std::numeric_limits<float>::max();
+    int bestAxis = -1;
+    uint32_t bestSplit = 0;
+    for(int axis = 0; axis < 3; axis++){
+        if(extent[axis] <= 0.0f){
+            continue;
+        }
+        const Bin *axisBins = bins[axis];
+
+        // right side of every split plane, then left side while looking for the cheapest
+        float rightArea[SAH_BINS]{};
+        uint32_t rightCount[SAH_BINS]{};
+        Aabb side{};
+        uint32_t sideCount = 0;
+        for(uint32_t b = SAH_BINS - 1; b > 0; b--){
+            if(axisBins[b].count){
+                side.expand(axisBins[b].bounds);
+                sideCount += axisBins[b].count;
+            }
+            rightArea[b] = sideCount ? side.area() : 0.0f;
+            rightCount[b] = sideCount;
+        }
+
+        side = Aabb{};
+        sideCount = 0;
+        for(uint32_t b = 1; b < SAH_BINS; b++){
+            if(axisBins[b - 1].count){
+                side.expand(axisBins[b - 1].bounds);
+                sideCount += axisBins[b - 1].count;
+            }
+            if(sideCount == 0 || rightCount[b] == 0){
+                continue;
+            }
+            const float splitCost = sideCount * side.area() + rightCount[b] * rightArea[b];
+            if(splitCost < bestCost){
+                bestCost = splitCost;
+                bestAxis = axis;
+                bestSplit = b;
+            }
+        }
+    }
+
+    uint32_t leftCount = count / 2;
+    if(bestAxis >= 0){
+        const float min = centers.min[bestAxis];
+        const float axisScale = scale[bestAxis];
+        BuildItem *middle = std::partition(begin, end, [&](const BuildItem &it){
+            return binOf(it.centroid[bestAxis], min, axisScale) < bestSplit;
+        });
+        leftCount = static_cast<uint32_t>(middle - begin);
+    }
+    // else every centroid is the same point: the items are split in two halves
+
+    const auto left = static_cast<uint32_t>(nodes_.size());
+    nodes_.push_back({Aabb{}, first, leftCount});
+    nodes_.push_back({Aabb{}, first + leftCount, count - leftCount});
+    parents_.push_back(index);
+    parents_.push_back(index);
+
+    nodes_[index].first = left;
+    nodes_[index].count = 0;
+    return true;
+}
+
+void Bvh::refit(const Aabb *boxes, const uint32_t *moved, size_t movedCount)
+{
+    for(size_t m = 0; m < movedCount; m++){
+        const uint32_t leaf = itemLeaf_[moved[m]];
+        const BvhNode &node = nodes_[leaf];
+
+        Aabb bounds{};
+        for(uint32_t i = node.first; i < node.first + node.count; i++){
+            bounds.expand(boxes[items_[i]]);
+        }
+        if(sameBounds(bounds, node.bounds)){
+            continue;
+        }
+        setBounds(leaf, bounds);
+
+        // up to the first ancestor that does not change
+        for(uint32_t parent = parents_[leaf]; parent != NO_ITEM; parent = parents_[parent]){
+            const uint32_t left = nodes_[parent].first;
+            Aabb merged = nodes_[left].bounds;
+            merged.expand(nodes_[left + 1].bounds);
+            if(sameBounds(merged, nodes_[parent].bounds)){
+                break;
+            }
+            setBounds(parent, merged);
+        }
+    }
+}
+
+void Bvh::refit(const Aabb *boxes)
+{
+    // children come after their parent
+    for(size_t n = nodes_.size(); n-- > 0; ){
+        BvhNode &node = nodes_[n];
+        Aabb bounds{};
+        if(node.leaf()){
+            for(uint32_t i = node.first; i < node.first + node.count; i++){
+                bounds.expand(boxes[items_[i]]);
+            }
+        }else{
+            bounds = nodes_[node.first].bounds;
+            bounds.expand(nodes_[node.first + 1].bounds);
+        }
+        node.bounds = bounds;
+    }
+    cost_ = totalCost();
+}
+
+Bvh::Update Bvh::update(const Aabb *boxes, size_t count, const uint32_t *moved, size_t movedCount)
+{
+    if(count != items_.size() || nodes_.empty()){
+        build(boxes, count);
+        return Update::REBUILD;
+    }
+    if(movedCount == 0){
+        return Update::REFIT;
+    }
+
+    // past a quarter of the items one linear pass is cheaper than walking up from each leaf
+    if(movedCount * 4 > count){
+        refit(boxes);
+    }else{
+        refit(boxes, moved, movedCount);
+    }
+
+    if(cost() > buildCost_ * REBUILD_RATIO){
+        build(boxes, count);
+        return Update::REBUILD;
+    }
+    return Update::REFIT;
+}
+
+void Bvh::query(const Frustum &frustum, const Aabb *boxes, std::vector<uint32_t> &items) const
+{
+    items.clear();
+    if(nodes_.empty()){
+        return;
+    }
+
+    // depth first, never more entries than levels
+    std::array<uint32_t, MAX_DEPTH> stack;
+    uint32_t size = 0;
+    stack[size++] = 0;
+
+    while(size > 0){
+        const uint32_t entry = stack[--size];
+        const BvhNode &node = nodes_[entry & ~INSIDE_BIT];
+        uint32_t inside = entry & INSIDE_BIT;
+
+        if(!inside){
+            const Frustum::Containment containment = frustum.classify(node.bounds);
+            if(containment == Frustum::Containment::OUTSIDE){
+                continue;
+            }
+            inside = containment == Frustum::Containment::INSIDE ? INSIDE_BIT : 0;
+        }
+
+        if(node.leaf()){
+            for(uint32_t i = node.first; i < node.first + node.count; i++){
+                if(inside || frustum.intersects(boxes[items_[i]])){
+                    items.push_back(items_[i]);
+                }
+            }
+        }else{
+            stack[size++] = (node.first + 1) | inside;
+            stack[size++] = node.first | inside;
+        }
+    }
+}
+
+float Bvh::nodeCost(const BvhNode &node) const
+{
+    return node.leaf() ? node.count * INTERSECTION_COST : TRAVERSAL_COST;
+}
+
+void Bvh::setBounds(uint32_t index, const Aabb &bounds)
+{
+    BvhNode &node = nodes_[index];
+    cost_ += nodeCost(node) * (bounds.area() - node.bounds.area());
+    node.bounds = bounds;
+}
+
+float Bvh::totalCost() const
+{
+    float total = 0.0f;
+    for(const auto &node : nodes_){
+        total += nodeCost(node) * node.bounds.area();
+    }
+    return total;
+}
+
+float Bvh::cost() const
+{
+    if(nodes_.empty()){
+        return 0.0f;
+    }
+    const float rootArea = nodes_.front().bounds.area();
+    return rootArea > 0.0f ? cost_ / rootArea : 0.0f;
+}
+
+} // namespace ngn
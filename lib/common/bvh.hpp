@@ -0,0 +1,174 @@
+#pragma once
+#include "bounds.hpp"
+#include "frustum.hpp"
+#include "ray.hpp"
+//std
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace ngn
+{
+
+struct BvhNode
+{
+    Aabb bounds{};
+    // leaf: items [first, first + count), interior: children first and first + 1, count 0
+    uint32_t first{0};
+    uint32_t count{0};
+
+    bool leaf() const { return count != 0; }
+};
+
+/**
+ * @brief Bounding volume hierarchy over item boxes, items are indices in the caller array
+ *        Built with binned SAH, moved items are refitted up to the root and the tree is
+ *        rebuilt once the refitted SAH cost grows past REBUILD_RATIO times the built one.
+ *        Children are stored after their parent, queries are safe from many threads
+ */
+class Bvh
+{
+public:
+    static constexpr uint32_t NO_ITEM = std::numeric_limits<uint32_t>::max();
+    static constexpr uint32_t MAX_LEAF_ITEMS = 4;
+    static constexpr uint32_t SAH_BINS = 16;
+    // deeper nodes stay leaves, bounds the traversal stacks
+    static constexpr uint32_t MAX_DEPTH = 64;
+    static constexpr float REBUILD_RATIO = 1.5f;
+
+    enum class Update { REFIT, REBUILD };
+
+    struct Hit
+    {
+        uint32_t item{NO_ITEM};
+        float t{std::numeric_limits<float>::max()};
+    };
+
+    void build(const Aabb *boxes, size_t count);
+
+    /**
+     * @brief Refit the leaves of the moved items and their ancestors
+     *
+     * @param boxes every item box, moved ones updated
+     * @param moved indices of the moved items
+     */
+    void refit(const Aabb *boxes, const uint32_t *moved, size_t movedCount);
+    // refit of every node
+    void refit(const Aabb *boxes);
+
+    /**
+     * @brief Keep the tree in sync with the item boxes: rebuild when the item count changed
+     *        or the refitted tree got too slow to query, refit otherwise
+     */
+    Update update(const Aabb *boxes, size_t count, const uint32_t *moved, size_t movedCount);
+
+    /**
+     * @brief Items whose box intersects the frustum, in tree order
+     *
+     * @param boxes item boxes the tree was built or refitted with
+     */
+    void query(const Frustum &frustum, const Aabb *boxes, std::vector<uint32_t> &items) const;
+
+    /**
+     * @brief Nearest hit along the ray, nodes are visited front to back
+     *
+     * @param hitItem float(uint32_t item, float tMax) distance of the hit with the item,
+     *        any value >= tMax if there is none. Only called for items whose box is hit before tMax
+     */
+    template<typename F>
+    Hit raycast(const Ray &ray, float tMax, F &&hitItem) const;
+
+    size_t size() const { return items_.size(); }
+    bool empty() const { return items_.empty(); }
+    size_t nodeCount() const { return nodes_.size(); }
+    uint32_t depth() const { return depth_; }
+    const BvhNode& root() const { return nodes_.front(); }
+
+    // SAH cost relative to the root area, and the same at the last build
+    float cost() const;
+    float buildCost() const { return buildCost_; }
+
+private:
+    // binned SAH split of a node, false if it stays a leaf
+    bool split(uint32_t node, uint32_t depth);
+    void setBounds(uint32_t node, const Aabb &bounds);
+    float nodeCost(const BvhNode &node) const;
+    float totalCost() const;
+
+    std::vector<BvhNode> nodes_{};
+    std::vector<uint32_t> parents_{};
+    // item indices grouped by leaf
+    std::vector<uint32_t> items_{};
+    // leaf of every item
+    std::vector<uint32_t> itemLeaf_{};
+    // build scratch: items are partitioned with their box, no indirection while binning
+    struct BuildItem
+    {
+        Aabb bounds;
+        glm::vec3 centroid;
+        uint32_t item;
+    };
+    std::vector<BuildItem> scratch_{};
+
+    // sum of the node areas weighted by the traversal or intersection cost
+    float cost_{0.0f};
+    float buildCost_{0.0f};
+    uint32_t depth_{0};
+};
+
+template<typename F>
+Bvh::Hit Bvh::raycast(const Ray &ray, float tMax, F &&hitItem) const
+{
+    Hit hit{NO_ITEM, tMax};
+    float tNear = 0.0f;
+    if(nodes_.empty() || !intersect(ray, nodes_[0].bounds, hit.t, tNear)){
+        return hit;
+    }
+
+    struct Entry { uint32_t node; float tNear; };
+    // depth first, never more entries than levels
+    std::array<Entry, MAX_DEPTH> stack;
+    uint32_t size = 0;
+    stack[size++] = {0, tNear};
+
+    while(size > 0){
+        const Entry entry = stack[--size];
+        // a closer hit was found after the node was pushed
+        if(entry.tNear > hit.t){
+            continue;
+        }
+
+        const BvhNode &node = nodes_[entry.node];
+        if(node.leaf()){
+            for(uint32_t i = node.first; i < node.first + node.count; i++){
+                const float t = hitItem(items_[i], hit.t);
+                if(t < hit.t){
+                    hit = {items_[i], t};
+                }
+            }
+            continue;
+        }
+
+        float tLeft = 0.0f, tRight = 0.0f;
+        const bool left  = intersect(ray, nodes_[node.first].bounds, hit.t, tLeft);
+        const bool right = intersect(ray, nodes_[node.first + 1].bounds, hit.t, tRight);
+        // the nearest child is popped first
+        if(left && right){
+            if(tLeft <= tRight){
+                stack[size++] = {node.first + 1, tRight};
+                stack[size++] = {node.first, tLeft};
+            }else{
+                stack[size++] = {node.first, tLeft};
+                stack[size++] = {node.first + 1, tRight};
+            }
+        }else if(left){
+            stack[size++] = {node.first, tLeft};
+        }else if(right){
+            stack[size++] = {node.first + 1, tRight};
+        }
+    }
+    return hit;
+}
+
+} // namespace ngn
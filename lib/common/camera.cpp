@@ -14,6 +14,20 @@ Camera::Camera(glm::vec3 position , glm::vec3 target , glm::vec3 up ,float fov )
 }
 
 
+/**
+ * @brief Replace position, target, up and fov then rebuild the view matrix
+ * 
+ * @param state 
+ */
+void Camera::setState(const CameraState &state)
+{
+    Position = state.position;
+    Target = state.target;
+    WorldUp = state.up;
+    Fov.set(state.fov);
+    updateCameraVectors();
+}
+
 /**
  * @brief Update camera position from fontroller
  * 
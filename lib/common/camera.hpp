@@ -21,6 +21,31 @@ struct CameraController{
     ngn::Feed feed{};
 };
 
+// Copyable camera attributes, used to interpolate between simulation steps
+struct CameraState{
+    glm::vec3 position{0.0f};
+    glm::vec3 target{0.0f};
+    glm::vec3 up{0.0f, 1.0f, 0.0f};
+    float     fov{45.0f};
+
+    /**
+     * @brief Linear blend of two states
+     * 
+     * @param a previous state
+     * @param b current state
+     * @param alpha 0 returns a, 1 returns b
+     * @return CameraState 
+     */
+    static CameraState mix(const CameraState &a, const CameraState &b, float alpha){
+        CameraState state{};
+        state.position = glm::mix(a.position, b.position, alpha);
+        state.target   = glm::mix(a.target, b.target, alpha);
+        state.up       = glm::mix(a.up, b.up, alpha);
+        state.fov      = glm::mix(a.fov, b.fov, alpha);
+        return state;
+    }
+};
+
 
 // Camera class that processes input and calculates the corresponding view Matrices for use in OpenGL
 class Camera
@@ -43,7 +68,7 @@ private:
             if (fov_ > max)
                 fov_ = max; 
         }
-        float get() {return fov_; }
+        float get() const {return fov_; }
     }Fov;
 
     // Default camera values
@@ -129,6 +154,9 @@ public:
 
     void Update(CameraController controller);
 
+    CameraState getState() const { return CameraState{Position, Target, WorldUp, Fov.get()}; }
+    void setState(const CameraState &state);
+
     void cameraOrbit(float xoffset, float yoffset);
     void cameraRoll(float xoffset, float yoffset);
     void cameraPan(float xoffset, float yoffset);
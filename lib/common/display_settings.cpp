@@ -0,0 +1,64 @@
+#include "display_settings.hpp"
+
+namespace ngn
+{
+
+void Display::setSamples(uint32_t samples)
+{
+    uint32_t rounded = 1;
+    while(rounded < 8 && rounded * 2 <= samples){
+        rounded *= 2;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    state.samples = rounded;
+}
+
+void Display::setPresentMode(PresentMode mode)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    state.presentMode = mode < PresentMode::COUNT ? mode : PresentMode::AUTO;
+}
+
+void Display::setVsync(bool vsync)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    state.vsync = vsync;
+}
+
+DisplayState Display::get()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return state;
+}
+
+const char* Display::getPresentModeName(PresentMode mode)
+{
+    switch (mode)
+    {
+    case PresentMode::AUTO:
+        return "auto";
+    case PresentMode::IMMEDIATE:
+        return "immediate";
+    case PresentMode::MAILBOX:
+        return "mailbox";
+    case PresentMode::FIFO:
+        return "fifo";
+    case PresentMode::FIFO_RELAXED:
+        return "fifo_relaxed";
+    default:
+        return "unknown";
+    }
+}
+
+std::optional<PresentMode> Display::parsePresentMode(std::string_view name)
+{
+    for(uint32_t i = 0; i < static_cast<uint32_t>(PresentMode::COUNT); i++){
+        auto mode = static_cast<PresentMode>(i);
+        if(name == getPresentModeName(mode)){
+            return mode;
+        }
+    }
+    return std::nullopt;
+}
+
+} // namespace ngn
@@ -0,0 +1,58 @@
+#pragma once
+//std
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string_view>
+
+namespace ngn
+{
+
+/**
+ * @brief Vulkan presentation mode, AUTO follows the vsync setting
+ *
+ */
+enum class PresentMode : uint32_t {
+    AUTO,
+    IMMEDIATE,
+    MAILBOX,
+    FIFO,
+    FIFO_RELAXED,
+    COUNT
+};
+
+struct DisplayState
+{
+    // samples of the scene target
+    uint32_t samples = 2;
+    PresentMode presentMode = PresentMode::AUTO;
+    // Opengl swap interval, picks FIFO for an AUTO Vulkan present mode
+    bool vsync = false;
+
+    bool operator==(const DisplayState &) const = default;
+};
+
+/**
+ * @brief Output settings written by the command line or the ui, any thread.
+ *        The backends compare them with the applied state at the start of a frame and
+ *        rebuild only what changed: scene targets and pipelines for the samples, the swapchain for the present mode
+ */
+class Display
+{
+public:
+    // rounded down to 1, 2, 4 or 8, the backends clamp it to the device limit
+    static void setSamples(uint32_t samples);
+    static void setPresentMode(PresentMode mode);
+    static void setVsync(bool vsync);
+    static DisplayState get();
+
+    // lowercase name used on the command line and in the ui
+    static const char* getPresentModeName(PresentMode mode);
+    static std::optional<PresentMode> parsePresentMode(std::string_view name);
+
+private:
+    inline static std::mutex mutex{};
+    inline static DisplayState state{};
+};
+
+} // namespace ngn
@@ -0,0 +1,102 @@
+#pragma once
+#include "bounds.hpp"
+//lib
+#include <glm/glm.hpp>
+//std
+#include <array>
+#include <cmath>
+
+namespace ngn
+{
+
+/**
+ * @brief View frustum as six normalized planes facing inward:
+ *        left, right, bottom, top, near, far
+ *        A point p is inside when dot(plane.xyz, p) + plane.w >= 0 for every plane
+ */
+struct Frustum
+{
+    std::array<glm::vec4, 6> planes{};
+
+    /**
+     * @brief Planes of a clip matrix (Gribb-Hartmann), opengl depth range -w <= z <= w
+     *
+     * @param viewProj proj * view gives world space planes, proj alone view space planes
+     */
+    static Frustum fromMatrix(const glm::mat4 &viewProj)
+    {
+        // rows of the matrix, glm is column major
+        glm::vec4 row[4];
+        for(int r = 0; r < 4; r++){
+            row[r] = glm::vec4(viewProj[0][r], viewProj[1][r], viewProj[2][r], viewProj[3][r]);
+        }
+
+        Frustum frustum{};
+        frustum.planes[0] = row[3] + row[0];
+        frustum.planes[1] = row[3] - row[0];
+        frustum.planes[2] = row[3] + row[1];
+        frustum.planes[3] = row[3] - row[1];
+        frustum.planes[4] = row[3] + row[2];
+        frustum.planes[5] = row[3] - row[2];
+
+        for(auto &plane : frustum.planes){
+            const glm::vec3 normal{plane.x, plane.y, plane.z};
+            plane /= std::sqrt(glm::dot(normal, normal));
+        }
+        return frustum;
+    }
+
+    bool intersects(const Sphere &sphere) const
+    {
+        for(const auto &plane : planes){
+            if(glm::dot(glm::vec3(plane), sphere.center) + plane.w < -sphere.radius){
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // conservative: boxes near a frustum corner can pass while outside
+    bool intersects(const Aabb &box) const
+    {
+        for(const auto &plane : planes){
+            // corner farthest along the plane normal
+            const glm::vec3 positive{
+                plane.x >= 0.0f ? box.max.x : box.min.x,
+                plane.y >= 0.0f ? box.max.y : box.min.y,
+                plane.z >= 0.0f ? box.max.z : box.min.z,
+            };
+            if(glm::dot(glm::vec3(plane), positive) + plane.w < 0.0f){
+                return false;
+            }
+        }
+        return true;
+    }
+
+    enum class Containment { OUTSIDE, INTERSECTS, INSIDE };
+
+    // INSIDE if the whole box is in the frustum, used to skip the tests of a subtree
+    Containment classify(const Aabb &box) const
+    {
+        Containment result = Containment::INSIDE;
+        for(const auto &plane : planes){
+            const glm::vec3 normal{plane};
+            const glm::vec3 positive{
+                plane.x >= 0.0f ? box.max.x : box.min.x,
+                plane.y >= 0.0f ? box.max.y : box.min.y,
+                plane.z >= 0.0f ? box.max.z : box.min.z,
+            };
+            if(glm::dot(normal, positive) + plane.w < 0.0f){
+                return Containment::OUTSIDE;
+            }
+            // the nearest corner is behind the plane
+            const glm::vec3 negative = box.min + box.max - positive;
+            if(glm::dot(normal, negative) + plane.w < 0.0f){
+                result = Containment::INTERSECTS;
+            }
+        }
+        return result;
+    }
+};
+
+} // namespace ngn
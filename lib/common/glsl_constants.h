@@ -20,7 +20,9 @@ enum PolygonMode{
 enum ShaderBinding{
     UNIFORM_BUFFER = 0,
     IMAGE_SAMPLER,
-    UNIFORM_BUFFER_DYNAMIC
+    UNIFORM_BUFFER_DYNAMIC,
+    // opengl multi draw per-draw data
+    STORAGE_BUFFER
 };
 
 constexpr const char * prefixpath = "data/shaders/";
@@ -0,0 +1,107 @@
+#pragma once
+//std
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace ngn
+{
+
+template<typename Signature, size_t Capacity = 48>
+class InplaceFunction;
+
+/**
+ * @brief Move only std::function replacement that never allocates.
+ *        The callable is stored in the object itself, a capture too large for Capacity
+ *        does not compile. Move only captures (e.g. std::unique_ptr) are allowed
+ */
+template<typename R, typename... Args, size_t Capacity>
+class InplaceFunction<R(Args...), Capacity>
+{
+public:
+    InplaceFunction() = default;
+
+    template<typename F>
+        requires (!std::is_same_v<std::decay_t<F>, InplaceFunction> && std::is_invocable_r_v<R, std::decay_t<F>&, Args...>)
+    InplaceFunction(F &&function)
+    {
+        using Functor = std::decay_t<F>;
+        static_assert(sizeof(Functor) <= Capacity, "capture too large for the inplace storage");
+        static_assert(alignof(Functor) <= alignof(std::max_align_t), "capture over aligned");
+        static_assert(std::is_nothrow_move_constructible_v<Functor>, "capture must be nothrow movable");
+
+        ::new (static_cast<void*>(storage_)) Functor(std::forward<F>(function));
+        ops_ = &OPS<Functor>;
+    }
+
+    InplaceFunction(InplaceFunction &&other) noexcept
+    {
+        moveFrom(other);
+    }
+
+    InplaceFunction &operator=(InplaceFunction &&other) noexcept
+    {
+        if(this != &other){
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    InplaceFunction(const InplaceFunction &) = delete;
+    InplaceFunction &operator=(const InplaceFunction &) = delete;
+
+    ~InplaceFunction() { reset(); }
+
+    R operator()(Args... args)
+    {
+        return ops_->invoke(storage_, std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const { return ops_ != nullptr; }
+
+    // destroy the callable and its captures
+    void reset()
+    {
+        if(ops_){
+            ops_->destroy(storage_);
+            ops_ = nullptr;
+        }
+    }
+
+private:
+    struct Ops
+    {
+        R (*invoke)(void *storage, Args&&... args);
+        void (*move)(void *dst, void *src);
+        void (*destroy)(void *storage);
+    };
+
+    template<typename Functor>
+    static constexpr Ops OPS{
+        [](void *storage, Args&&... args) -> R {
+            return (*static_cast<Functor*>(storage))(std::forward<Args>(args)...);
+        },
+        [](void *dst, void *src) {
+            ::new (dst) Functor(std::move(*static_cast<Functor*>(src)));
+            static_cast<Functor*>(src)->~Functor();
+        },
+        [](void *storage) {
+            static_cast<Functor*>(storage)->~Functor();
+        },
+    };
+
+    void moveFrom(InplaceFunction &other)
+    {
+        if(other.ops_){
+            other.ops_->move(storage_, other.storage_);
+            ops_ = std::exchange(other.ops_, nullptr);
+        }
+    }
+
+    alignas(std::max_align_t) unsigned char storage_[Capacity];
+    const Ops *ops_ = nullptr;
+};
+
+} // namespace ngn
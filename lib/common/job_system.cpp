@@ -0,0 +1,177 @@
+#include "job_system.hpp"
+#include "mytypes.hpp"
+//std
+#include <stdexcept>
+
+namespace ngn
+{
+
+JobSystem::JobSystem(uint32_t workers) : id_{nextId_.fetch_add(1)}
+{
+    SPDLOG_DEBUG("constructor");
+
+    workers = std::min<uint32_t>(workers, MAX_THREADS - 1);
+    workers_.reserve(workers);
+    for(uint32_t i = 0; i < workers; i++){
+        workers_.emplace_back(&JobSystem::workerLoop, this);
+    }
+    spdlog::info("job system started {} workers", workers);
+}
+
+JobSystem::~JobSystem()
+{
+    SPDLOG_DEBUG("destructor");
+
+    running_.store(false, std::memory_order_seq_cst);
+    wake_.fetch_add(1, std::memory_order_seq_cst);
+    wake_.notify_all();
+
+    for(auto &worker : workers_){
+        worker.join();
+    }
+}
+
+uint32_t JobSystem::defaultWorkers()
+{
+    uint32_t threads = std::thread::hardware_concurrency();
+    return threads > 1 ? threads - 1 : 1;
+}
+
+JobSystem::ThreadQueue &JobSystem::localQueue()
+{
+    if(slot_.system != id_){
+        slot_ = ThreadSlot{id_, registerThread()};
+    }
+    return *queues_[slot_.index].load(std::memory_order_relaxed);
+}
+
+uint32_t JobSystem::registerThread()
+{
+    const std::thread::id self = std::this_thread::get_id();
+    std::lock_guard<std::mutex> lock(ownedMutex_);
+
+    // the thread switched between systems: one queue per thread and system
+    const uint32_t count = registered_.load(std::memory_order_relaxed);
+    for(uint32_t index = 0; index < count; index++){
+        if(owned_[index]->owner == self){
+            return index;
+        }
+    }
+    if(count >= MAX_THREADS){
+        throw std::runtime_error("too many threads using the job system");
+    }
+
+    auto queue = std::make_unique<ThreadQueue>();
+    queue->owner = self;
+    queues_[count].store(queue.get(), std::memory_order_release);
+    owned_.push_back(std::move(queue));
+    registered_.store(count + 1, std::memory_order_release);
+    return count;
+}
+
+JobSystem::Job *JobSystem::allocate(ThreadQueue &local)
+{
+    // slots are reused in order, skip the ones still queued or running
+    for(size_t i = 0; i < JOB_CAPACITY; i++){
+        Job &job = local.jobs[local.next++ & (JOB_CAPACITY - 1)];
+        if(!job.busy.load(std::memory_order_acquire)){
+            job.busy.store(true, std::memory_order_relaxed);
+            return &job;
+        }
+    }
+    return nullptr;
+}
+
+void JobSystem::submit(ThreadQueue &local, Job *job)
+{
+    if(!local.queue.push(job)){
+        execute(job);
+        return;
+    }
+
+    // pairs with the fence of idle(): either the worker sees the job or we see it sleeping
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(sleeping_.load(std::memory_order_relaxed) > 0){
+        wake_.fetch_add(1, std::memory_order_relaxed);
+        wake_.notify_one();
+    }
+}
+
+JobSystem::Job *JobSystem::findJob(ThreadQueue &local)
+{
+    if(Job *job = local.queue.pop()){
+        return job;
+    }
+
+    uint32_t count = registered_.load(std::memory_order_acquire);
+    uint32_t self = slot_.index;
+    for(uint32_t i = 1; i < count; i++){
+        ThreadQueue *victim = queues_[(self + i) % count].load(std::memory_order_acquire);
+        if(!victim){
+            continue;
+        }
+        if(Job *job = victim->queue.steal()){
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+void JobSystem::execute(Job *job)
+{
+    JobCounter *counter = job->counter;
+    job->invoke(*job);
+    job->busy.store(false, std::memory_order_release);
+    counter->pending_.fetch_sub(1, std::memory_order_release);
+}
+
+void JobSystem::wait(JobCounter &counter)
+{
+    ThreadQueue &local = localQueue();
+    while(!counter.done()){
+        if(Job *job = findJob(local)){
+            execute(job);
+        }else{
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::workerLoop()
+{
+    ThreadQueue &local = localQueue();
+    while(running_.load(std::memory_order_acquire)){
+        if(Job *job = findJob(local)){
+            execute(job);
+        }else{
+            idle(local);
+        }
+    }
+}
+
+void JobSystem::idle(ThreadQueue &local)
+{
+    // spin a little before sleeping, jobs often come in bursts
+    const int SPINS = 64;
+    for(int i = 0; i < SPINS; i++){
+        if(Job *job = findJob(local)){
+            execute(job);
+            return;
+        }
+        std::this_thread::yield();
+    }
+
+    sleeping_.fetch_add(1, std::memory_order_seq_cst);
+    uint32_t wake = wake_.load(std::memory_order_seq_cst);
+    if(Job *job = findJob(local)){
+        sleeping_.fetch_sub(1, std::memory_order_relaxed);
+        execute(job);
+        return;
+    }
+    if(running_.load(std::memory_order_acquire)){
+        wake_.wait(wake, std::memory_order_seq_cst);
+    }
+    sleeping_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+} // namespace ngn
@@ -0,0 +1,207 @@
+#pragma once
+#include "work_stealing_queue.hpp"
+//std
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ngn
+{
+
+/**
+ * @brief Number of unfinished jobs of a group
+ *        Must outlive its jobs: JobSystem::wait() on it before it goes out of scope
+ */
+class JobCounter
+{
+public:
+    JobCounter() = default;
+
+    JobCounter(const JobCounter &) = delete;
+    JobCounter &operator=(const JobCounter &) = delete;
+
+    bool done() const { return pending_.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+    std::atomic<uint32_t> pending_{0};
+};
+
+/**
+ * @brief Fixed pool of worker threads with one Chase-Lev deque per thread.
+ *        A thread pushes and pops its own jobs at the bottom of its deque, idle threads steal from the top of the others.
+ *        Any thread can submit jobs, threads that wait() on a counter execute jobs instead of blocking.
+ *        Jobs are fixed size slots recycled per thread, callables are stored inline: no allocation per job
+ */
+class JobSystem
+{
+public:
+    // jobs per thread, queued or running
+    static constexpr size_t JOB_CAPACITY  = 4096;
+    // workers plus the other threads submitting jobs
+    static constexpr size_t MAX_THREADS   = 64;
+    // biggest callable stored in a job
+    static constexpr size_t JOB_DATA_SIZE = 40;
+
+    /**
+     * @brief Start the worker threads
+     *
+     * @param workers 0 runs every job on the thread that waits for it
+     */
+    explicit JobSystem(uint32_t workers = defaultWorkers());
+    ~JobSystem();
+
+    JobSystem(const JobSystem &) = delete;
+    JobSystem &operator=(const JobSystem &) = delete;
+
+    // one less than the hardware threads, the waiting thread works too
+    static uint32_t defaultWorkers();
+    uint32_t workerCount() const { return static_cast<uint32_t>(workers_.size()); }
+
+    /**
+     * @brief Queue a job on the calling thread, counter is incremented now and decremented when fn returns
+     *        Runs fn inline when the queue of the calling thread is full
+     *
+     * @param fn void() callable, captures up to JOB_DATA_SIZE bytes
+     */
+    template<typename F>
+    void run(JobCounter &counter, F &&fn);
+
+    /**
+     * @brief Execute queued jobs until counter reaches zero
+     */
+    void wait(JobCounter &counter);
+
+    /**
+     * @brief Split [0, count) in chunks of grain indices and wait for all of them
+     *
+     * @param grain indices per job, 0 picks about four chunks per thread
+     * @param fn void(size_t begin, size_t end) callable, called concurrently on disjoint ranges
+     */
+    template<typename F>
+    void parallel_for(size_t count, size_t grain, F &&fn);
+
+    /**
+     * @brief Split items in chunks of grain elements and wait for all of them
+     *
+     * @param fn void(std::span<T> chunk) callable, called concurrently on disjoint chunks
+     */
+    template<typename T, typename F>
+    void parallel_for(std::span<T> items, size_t grain, F &&fn);
+
+private:
+    struct alignas(64) Job {
+        void (*invoke)(Job &) = nullptr;
+        JobCounter *counter = nullptr;
+        // set while queued or running, the slot can't be recycled
+        std::atomic<bool> busy{false};
+        alignas(alignof(void*)) std::byte data[JOB_DATA_SIZE];
+    };
+    static_assert(sizeof(Job) == 64, "Job must fill one cache line");
+
+    struct ThreadQueue {
+        WorkStealingQueue<Job, JOB_CAPACITY> queue{};
+        std::array<Job, JOB_CAPACITY> jobs{};
+        size_t next{0};
+        // thread that registered the queue, it gets it back after using another system
+        std::thread::id owner{};
+    };
+
+    // no default member initializers: used by a static member, zero initialized
+    struct ThreadSlot {
+        uint64_t system;
+        uint32_t index;
+    };
+
+    ThreadQueue &localQueue();
+    uint32_t registerThread();
+    Job *allocate(ThreadQueue &local);
+    void submit(ThreadQueue &local, Job *job);
+    Job *findJob(ThreadQueue &local);
+    void execute(Job *job);
+    void workerLoop();
+    void idle(ThreadQueue &local);
+
+    inline static std::atomic<uint64_t> nextId_{1};
+    // last job system used by the calling thread and its queue there
+    inline static thread_local ThreadSlot slot_{};
+
+    const uint64_t id_;
+    std::array<std::atomic<ThreadQueue*>, MAX_THREADS> queues_{};
+    std::atomic<uint32_t> registered_{0};
+    std::vector<std::unique_ptr<ThreadQueue>> owned_{};
+    std::mutex ownedMutex_{};
+
+    std::vector<std::thread> workers_{};
+    std::atomic<bool> running_{true};
+    // workers sleep on wake_ when there is nothing to steal
+    std::atomic<uint32_t> wake_{0};
+    std::atomic<uint32_t> sleeping_{0};
+};
+
+template<typename F>
+void JobSystem::run(JobCounter &counter, F &&fn)
+{
+    using Fn = std::decay_t<F>;
+    static_assert(sizeof(Fn) <= JOB_DATA_SIZE, "job callable too large, capture by reference");
+    static_assert(alignof(Fn) <= alignof(void*), "job callable over aligned");
+
+    ThreadQueue &local = localQueue();
+    Job *job = allocate(local);
+    if(!job){
+        fn();
+        return;
+    }
+
+    new (job->data) Fn(std::forward<F>(fn));
+    job->invoke = [](Job &j){
+        Fn *f = std::launder(reinterpret_cast<Fn*>(j.data));
+        (*f)();
+        f->~Fn();
+    };
+    job->counter = &counter;
+    counter.pending_.fetch_add(1, std::memory_order_relaxed);
+
+    submit(local, job);
+}
+
+template<typename F>
+void JobSystem::parallel_for(size_t count, size_t grain, F &&fn)
+{
+    if(count == 0){
+        return;
+    }
+    if(grain == 0){
+        size_t chunks = 4 * (static_cast<size_t>(workerCount()) + 1);
+        grain = (count + chunks - 1) / chunks;
+    }
+
+    JobCounter counter{};
+    for(size_t begin = grain; begin < count; begin += grain){
+        size_t end = std::min(begin + grain, count);
+        run(counter, [&fn, begin, end]{ fn(begin, end); });
+    }
+    // the calling thread takes the first chunk
+    fn(size_t{0}, std::min(grain, count));
+    wait(counter);
+}
+
+template<typename T, typename F>
+void JobSystem::parallel_for(std::span<T> items, size_t grain, F &&fn)
+{
+    parallel_for(items.size(), grain, [&items, &fn](size_t begin, size_t end){
+        fn(items.subspan(begin, end - begin));
+    });
+}
+
+} // namespace ngn
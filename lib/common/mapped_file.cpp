@@ -0,0 +1,151 @@
+#include "mapped_file.hpp"
+//std
+#include <stdexcept>
+#include <utility>
+
+#if defined(_WIN32)
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace ngn
+{
+
+#if defined(_WIN32)
+
+MappedFile::MappedFile(const std::string &path)
+{
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if(file == INVALID_HANDLE_VALUE){
+        throw std::runtime_error("failed to open " + path);
+    }
+    file_ = file;
+
+    LARGE_INTEGER size{};
+    if(!GetFileSizeEx(file, &size)){
+        close();
+        throw std::runtime_error("failed to read the size of " + path);
+    }
+    size_ = static_cast<size_t>(size.QuadPart);
+    // empty files can't be mapped
+    if(size_ == 0){
+        return;
+    }
+
+    mapping_ = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if(!mapping_){
+        close();
+        throw std::runtime_error("failed to map " + path);
+    }
+    data_ = static_cast<const std::byte*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+    if(!data_){
+        close();
+        throw std::runtime_error("failed to map " + path);
+    }
+}
+
+void MappedFile::close()
+{
+    if(data_){
+        UnmapViewOfFile(data_);
+    }
+    if(mapping_){
+        CloseHandle(mapping_);
+    }
+    if(file_){
+        CloseHandle(file_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+    mapping_ = nullptr;
+    file_ = nullptr;
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : data_{std::exchange(other.data_, nullptr)}, size_{std::exchange(other.size_, 0)},
+      file_{std::exchange(other.file_, nullptr)}, mapping_{std::exchange(other.mapping_, nullptr)}
+{
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+{
+    if(this != &other){
+        close();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        file_ = std::exchange(other.file_, nullptr);
+        mapping_ = std::exchange(other.mapping_, nullptr);
+    }
+    return *this;
+}
+
+#else
+
+MappedFile::MappedFile(const std::string &path)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0){
+        throw std::runtime_error("failed to open " + path);
+    }
+
+    struct stat info{};
+    if(fstat(fd, &info) != 0){
+        ::close(fd);
+        throw std::runtime_error("failed to read the size of " + path);
+    }
+    size_ = static_cast<size_t>(info.st_size);
+    // empty files can't be mapped
+    if(size_ == 0){
+        ::close(fd);
+        return;
+    }
+
+    void *data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping keeps the file alive
+    ::close(fd);
+    if(data == MAP_FAILED){
+        size_ = 0;
+        throw std::runtime_error("failed to map " + path);
+    }
+    data_ = static_cast<const std::byte*>(data);
+}
+
+void MappedFile::close()
+{
+    if(data_){
+        munmap(const_cast<std::byte*>(data_), size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : data_{std::exchange(other.data_, nullptr)}, size_{std::exchange(other.size_, 0)}
+{
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+{
+    if(this != &other){
+        close();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+}
+
+#endif
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+} // namespace ngn
@@ -0,0 +1,42 @@
+#pragma once
+//std
+#include <cstddef>
+#include <string>
+
+namespace ngn
+{
+
+/**
+ * @brief Read only memory mapping of a whole file, pages are loaded on first access
+ */
+class MappedFile
+{
+public:
+    MappedFile() = default;
+
+    /**
+     * @throw std::runtime_error if the file can't be opened or mapped
+     */
+    explicit MappedFile(const std::string &path);
+    ~MappedFile();
+
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const std::byte* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    void close();
+
+    const std::byte *data_ = nullptr;
+    size_t size_ = 0;
+#if defined(_WIN32)
+    void *file_ = nullptr;
+    void *mapping_ = nullptr;
+#endif
+};
+
+} // namespace ngn
@@ -0,0 +1,34 @@
+#include "mesh_bvh.hpp"
+#include "model.hpp"
+
+namespace ngn
+{
+
+MeshBvh::MeshBvh(const Model &model)
+{
+    positions_.resize(model.verticesSize());
+    for(size_t i = 0; i < positions_.size(); i++){
+        positions_[i] = model.verticesData()[i].pos;
+    }
+    indices_.assign(model.indicesData(), model.indicesData() + model.indicesSize());
+
+    std::vector<Aabb> boxes(triangleCount());
+    for(size_t tri = 0; tri < boxes.size(); tri++){
+        for(size_t corner = 0; corner < 3; corner++){
+            boxes[tri].expand(positions_[indices_[3 * tri + corner]]);
+        }
+    }
+    bvh_.build(boxes.data(), boxes.size());
+}
+
+MeshBvh::Hit MeshBvh::raycast(const Ray &ray, float tMax) const
+{
+    Bvh::Hit hit = bvh_.raycast(ray, tMax, [&](uint32_t tri, float nearest){
+        float t = nearest;
+        intersect(ray, positions_[indices_[3 * tri]], positions_[indices_[3 * tri + 1]], positions_[indices_[3 * tri + 2]], nearest, t);
+        return t;
+    });
+    return Hit{hit.item, hit.t};
+}
+
+} // namespace ngn
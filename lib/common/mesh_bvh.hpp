@@ -0,0 +1,46 @@
+#pragma once
+#include "bvh.hpp"
+#include "ray.hpp"
+//std
+#include <cstdint>
+#include <vector>
+
+class Model;
+
+namespace ngn
+{
+
+/**
+ * @brief Triangles of a model in a bvh, for picking
+ *        Positions and indices are copied: the model can be released once the object is built
+ */
+class MeshBvh
+{
+public:
+    explicit MeshBvh(const Model &model);
+
+    struct Hit
+    {
+        uint32_t triangle{Bvh::NO_ITEM};
+        float t{std::numeric_limits<float>::max()};
+    };
+
+    /**
+     * @brief Nearest triangle along a model space ray
+     *        The direction does not need to be normalized, t is in direction units:
+     *        a world ray moved to model space by the inverse matrix keeps its distances
+     *
+     * @return triangle NO_ITEM and t = tMax if nothing is hit before tMax
+     */
+    Hit raycast(const Ray &ray, float tMax) const;
+
+    size_t triangleCount() const { return indices_.size() / 3; }
+    const Bvh& bvh() const { return bvh_; }
+
+private:
+    std::vector<glm::vec3> positions_{};
+    std::vector<uint32_t> indices_{};
+    Bvh bvh_{};
+};
+
+} // namespace ngn
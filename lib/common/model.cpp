@@ -4,7 +4,10 @@
 #include <tiny_obj_loader.h>
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/hash.hpp>
+#include <glm/ext/matrix_transform.hpp>
 // std
+#include <algorithm>
+#include <cmath>
 #include <unordered_map>
 
 constexpr char  defmodel[] = "data/models/viking_room.obj";
@@ -32,7 +35,7 @@ void Model::init_tranform(UP up){
    if(up == UP::ZUP) 
     {   
         // rotate model to y up
-        node.set_upperMatrix(glm::rotate(glm::mat4(1.0f), glm::radians(-90.0f), glm::vec3(1.0f, 0.0f, 0.0f)));
+        upMatrix_ = glm::rotate(glm::mat4(1.0f), glm::radians(-90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
     }    
 }
 
@@ -43,6 +46,7 @@ void Model::load(const char *modelpath)
     }
 
     spdlog::info("loading {} ... ", modelpath);
+    path_ = modelpath;
 
     tinyobj::attrib_t attrib;
     std::vector<tinyobj::shape_t> shapes;
@@ -103,6 +107,8 @@ void Model::load(const char *modelpath)
         throw std::runtime_error("failed to load model, vertices size !");
     }
 
+    computeBounds();
+
     SPDLOG_INFO("size_of Vertices = {}", sizeof(Vertex) * vertices.size());   
     SPDLOG_INFO("Vertices.size() = {}", vertices.size());   
     SPDLOG_INFO("Indices.size()  = {}", indices.size()); 
@@ -126,6 +132,26 @@ Model& Model::axis()
     };
     // Setup indices
     axis.indices = { 0, 1, 2, 3, 4, 5};
+    axis.computeBounds();
 
     return axis;
 }
+
+void Model::computeBounds()
+{
+    bounds_ = ngn::Aabb{};
+    for(const auto &vertex : vertices){
+        bounds_.expand(vertex.pos);
+    }
+
+    // centered on the box, radius to the farthest vertex: tighter than the half diagonal
+    float radius2 = 0.0f;
+    const glm::vec3 center = bounds_.center();
+    for(const auto &vertex : vertices){
+        const glm::vec3 d = vertex.pos - center;
+        radius2 = std::max(radius2, glm::dot(d, d));
+    }
+    sphere_ = ngn::Sphere{center, std::sqrt(radius2)};
+
+    SPDLOG_DEBUG("bounds center = ({}, {}, {}) radius = {}", center.x, center.y, center.z, sphere_.radius);
+}
@@ -1,55 +1,11 @@
 #pragma once
 
 #include "vertex.h"
+#include "bounds.hpp"
+#include "scene_graph.hpp"
 // std
+#include <string>
 #include <vector>
-#include <glm/gtx/euler_angles.hpp>
-#include <glm/ext/matrix_transform.hpp> 
-
-struct Transformations
-{
-    glm::vec3 T{};
-    glm::vec3 R{};
-    glm::vec3 S{1.0f};
-};
-
-struct Node 
-{
-
-    void set(const Transformations &tra){
-        this->Tra = tra;
-    }
-    Transformations get (){
-        return Tra;
-    }
-
-    /**
-     * @brief Get final  matrix  
-     * 
-     * @return glm::mat4 
-     */
-    glm::mat4 getfinal() { return  local() * upMatrix;}
-
-    void set_upperMatrix(glm::mat4 mat) {upMatrix = mat;}
-
-private:
-    /**
-     * @brief Calculate local tranformations
-     * 
-     */
-    glm::mat4 local() {
-        // X = pitch Y = yaw Z = roll          
-        glm::mat4 rot = glm::yawPitchRoll(glm::radians(Tra.R.y), glm::radians(Tra.R.x), glm::radians(Tra.R.z));
-        glm::mat4 trasl = glm::translate(glm::mat4(1.0f), Tra.T);
-        glm::mat4 scale = glm::scale(glm::mat4(1.0f), Tra.S);
-        return  trasl * rot * scale;
-    }
-
-    Transformations Tra{};
-
-    //TODO  represent upper node transformation
-    glm::mat4 upMatrix{glm::mat4(1.0f)};
-};
 
 class Model
 { 
@@ -71,13 +27,31 @@ public:
     const Vertex* verticesData() const {return vertices.data(); }
     const uint32_t* indicesData()  const {return indices.data(); }
 
-    Node node{};
+    // file the model was loaded from, empty for generated models
+    const std::string& path() const { return path_; }
+
+    // initial local transformations of the object node
+    Transformations transform{};
+
+    /**
+     * @brief Model space correction applied before the object transformations ( e.g. z up to y up )
+     */
+    const glm::mat4& upMatrix() const { return upMatrix_; }
+
+    // model space bounds, computed once the vertices are loaded
+    const ngn::Aabb& bounds() const { return bounds_; }
+    const ngn::Sphere& boundingSphere() const { return sphere_; }
     
 private:
 
     void init_tranform(UP up);
+    void computeBounds();
 
+    std::string path_{};
     std::vector<Vertex> vertices{};
     std::vector<Index> indices{};
+    glm::mat4 upMatrix_{1.0f};
+    ngn::Aabb bounds_{};
+    ngn::Sphere sphere_{};
 };
 
@@ -0,0 +1,69 @@
+#include "profiler.hpp"
+#include "mytypes.hpp"
+//std
+#include <fstream>
+
+namespace ngn
+{
+
+const char* Profiler::getPassName(GpuPass pass)
+{
+    switch (pass)
+    {
+    case GpuPass::OBJECTS:
+        return "objects";
+    case GpuPass::FIXED:
+        return "fixed";
+    case GpuPass::UPSCALE:
+        return "upscale";
+    case GpuPass::UIOVERLAY:
+        return "ui_overlay";
+    default:
+        return "unknown";
+    }
+}
+
+void Profiler::writeBenchmark()
+{
+    if(benchmarkPath.empty()){
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::ofstream file(benchmarkPath, std::ios::trunc);
+    if(!file.is_open()){
+        spdlog::error("failed to open benchmark output {}", benchmarkPath);
+        return;
+    }
+
+    file << "{\n";
+    file << "  \"backend\": \"" << backend << "\",\n";
+    file << "  \"frames\": " << cpuBench.count << ",\n";
+    if(programCount > 0){
+        file << "  \"programs_ready\": { \"ms\": " << programsReadyMs
+             << ", \"from_cache\": " << programsCached
+             << ", \"programs\": " << programCount << " },\n";
+    }
+    file << "  \"cpu_frame_ms\": { \"avg\": " << cpuBench.avg()
+         << ", \"min\": " << cpuBench.min
+         << ", \"max\": " << cpuBench.max << " },\n";
+    file << "  \"gpu_passes\": {\n";
+    for(uint32_t i = 0; i < GPU_PASS_COUNT; i++){
+        const auto &acc = gpuBench[i];
+        double avgPrimitives = acc.count ? acc.primitives / acc.count : 0.0;
+        file << "    \"" << getPassName(static_cast<GpuPass>(i)) << "\": {"
+             << " \"samples\": " << acc.count
+             << ", \"avg_ms\": " << acc.avg()
+             << ", \"min_ms\": " << acc.min
+             << ", \"max_ms\": " << acc.max
+             << ", \"avg_primitives\": " << avgPrimitives << " }"
+             << (i + 1 < GPU_PASS_COUNT ? ",\n" : "\n");
+    }
+    file << "  }\n";
+    file << "}\n";
+
+    spdlog::info("benchmark written to {}", benchmarkPath);
+}
+
+} // namespace ngn
@@ -0,0 +1,249 @@
+#pragma once
+#include "ring_buffer.hpp"
+//std
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace ngn
+{
+
+/**
+ * @brief Render passes measured by the gpu timers of both backends
+ *
+ */
+enum class GpuPass : uint32_t {
+    OBJECTS,
+    FIXED,
+    UPSCALE,
+    UIOVERLAY,
+    COUNT
+};
+
+constexpr uint32_t GPU_PASS_COUNT = static_cast<uint32_t>(GpuPass::COUNT);
+
+struct GpuPassStats{
+    float    timeMs{0.f};
+    // Vulkan: input assembly primitives, Opengl: GL_PRIMITIVES_GENERATED
+    uint64_t primitives{0};
+    // Vulkan only, zero if pipeline statistics are not supported
+    uint64_t vertexInvocations{0};
+    uint64_t fragmentInvocations{0};
+};
+
+/**
+ * @brief Draw submission counters of one frame
+ *
+ */
+struct FrameCounters{
+    uint32_t draws{0};
+    // pipelines, programs, descriptor sets, vertex and index buffers
+    uint32_t binds{0};
+    uint64_t triangles{0};
+    // Opengl only, state calls reaching the driver and dropped as redundant
+    uint32_t stateIssued{0};
+    uint32_t stateFiltered{0};
+};
+
+/**
+ * @brief Frustum culling result of the last simulated frame
+ *
+ */
+struct CullingCounters{
+    uint32_t visible{0};
+    uint32_t total{0};
+};
+
+/**
+ * @brief Memory of one device heap, Vulkan only
+ *
+ */
+struct HeapBudget{
+    uint64_t usage{0};
+    uint64_t budget{0};
+    bool     deviceLocal{false};
+};
+
+// frame time history shown by the performance hud
+constexpr size_t   FRAME_HISTORY    = 256;
+// same as VK_MAX_MEMORY_HEAPS
+constexpr uint32_t MAX_MEMORY_HEAPS = 16;
+
+using FrameHistory = RingBuffer<float, FRAME_HISTORY>;
+
+/**
+ * @brief Running min, max and average of a benchmark value
+ *
+ */
+struct Accumulator{
+    double   sum{0.0};
+    float    min{0.f};
+    float    max{0.f};
+    uint64_t count{0};
+    double   primitives{0.0};
+
+    void add(float value, uint64_t prims = 0){
+        if(count == 0 || value < min) min = value;
+        if(count == 0 || value > max) max = value;
+        sum += value;
+        primitives += static_cast<double>(prims);
+        count++;
+    }
+    float avg() const { return count ? static_cast<float>(sum / count) : 0.f; }
+};
+
+/**
+ * @brief Frame statistics shared by the main thread and the render thread
+ *        Draw counters are written by the thread that records the frame only,
+ *        gpu results, last counters and heap budgets are guarded by a mutex
+ */
+struct Profiler{
+private:
+    inline static std::mutex mutex{};
+    inline static std::array<GpuPassStats, GPU_PASS_COUNT> gpuPasses{};
+    inline static std::array<Accumulator, GPU_PASS_COUNT>  gpuBench{};
+    inline static Accumulator cpuBench{};
+    inline static FrameHistory cpuHistory{};
+    inline static FrameHistory gpuHistory{};
+    inline static FrameCounters counters{};
+    inline static FrameCounters lastCounters{};
+    inline static CullingCounters culling{};
+    inline static std::array<HeapBudget, MAX_MEMORY_HEAPS> heaps{};
+    inline static uint32_t heapCount{0};
+    inline static std::atomic<int64_t> textureBytes{0};
+    inline static std::atomic<int64_t> meshBytes{0};
+    inline static std::atomic<float> renderScale{1.f};
+    inline static std::string backend{};
+    inline static std::string benchmarkPath{};
+    // time until every program could draw, 0 until then
+    inline static double programsReadyMs{0.0};
+    inline static uint32_t programsCached{0};
+    inline static uint32_t programCount{0};
+
+public:
+    static const char* getPassName(GpuPass pass);
+
+    /**
+     * @brief Store the latest gpu results of a pass, called by the backends once the queries are available
+     *
+     * @param pass
+     * @param stats
+     */
+    static void setGpuPass(GpuPass pass, const GpuPassStats &stats){
+        auto index = static_cast<uint32_t>(pass);
+        std::lock_guard<std::mutex> lock(mutex);
+        gpuPasses[index] = stats;
+        gpuBench[index].add(stats.timeMs, stats.primitives);
+    }
+    static GpuPassStats getGpuPass(GpuPass pass){ 
+        std::lock_guard<std::mutex> lock(mutex);
+        return gpuPasses[static_cast<uint32_t>(pass)]; 
+    }
+
+    /**
+     * @brief Sum of all measured gpu passes of the last available frame
+     *
+     * @return float milliseconds
+     */
+    static float getGpuFrameTime(){
+        std::lock_guard<std::mutex> lock(mutex);
+        float total = 0.f;
+        for(const auto & pass : gpuPasses){
+            total += pass.timeMs;
+        }
+        return total;
+    }
+
+    /**
+     * @brief Close the main loop frame: store the frame times in the history
+     *
+     * @param cpuMs cpu frame time in milliseconds
+     */
+    static void endFrame(float cpuMs){
+        cpuBench.add(cpuMs);
+        cpuHistory.push(cpuMs);
+        gpuHistory.push(getGpuFrameTime());
+    }
+
+    /**
+     * @brief Close the recorded frame: publish and restart the draw counters
+     *
+     */
+    static void endDrawFrame(){
+        std::lock_guard<std::mutex> lock(mutex);
+        lastCounters = counters;
+        counters = {};
+    }
+
+    static const FrameHistory& getCpuHistory(){ return cpuHistory; }
+    static const FrameHistory& getGpuHistory(){ return gpuHistory; }
+
+    static void countDraw(){ counters.draws++; }
+    static void countTriangles(uint64_t triangles){ counters.triangles += triangles; }
+    static void countBinds(uint32_t binds = 1){ counters.binds += binds; }
+    static void countStateCall(bool issued){ issued ? counters.stateIssued++ : counters.stateFiltered++; }
+    // counters of the last completed frame
+    static FrameCounters getCounters(){ 
+        std::lock_guard<std::mutex> lock(mutex);
+        return lastCounters; 
+    }
+
+    // written by the main thread once the snapshot is culled
+    static void setCulling(uint32_t visible, uint32_t total){
+        std::lock_guard<std::mutex> lock(mutex);
+        culling = {visible, total};
+    }
+    static CullingCounters getCulling(){
+        std::lock_guard<std::mutex> lock(mutex);
+        return culling;
+    }
+
+    static void setHeapBudgets(const HeapBudget *budgets, uint32_t count){
+        std::lock_guard<std::mutex> lock(mutex);
+        heapCount = count < MAX_MEMORY_HEAPS ? count : MAX_MEMORY_HEAPS;
+        for(uint32_t i = 0; i < heapCount; i++){
+            heaps[i] = budgets[i];
+        }
+    }
+    static uint32_t getHeapCount(){ 
+        std::lock_guard<std::mutex> lock(mutex);
+        return heapCount; 
+    }
+    static HeapBudget getHeapBudget(uint32_t heap){ 
+        std::lock_guard<std::mutex> lock(mutex);
+        return heaps[heap]; 
+    }
+
+    // resident gpu resources, negative values release memory
+    static void addTextureBytes(int64_t bytes){ textureBytes += bytes; }
+    static void addMeshBytes(int64_t bytes){ meshBytes += bytes; }
+    static int64_t getTextureBytes(){ return textureBytes; }
+    static int64_t getMeshBytes(){ return meshBytes; }
+
+    // scale of the scene target chosen for the last recorded frame
+    static void setRenderScale(float scale){ renderScale = scale; }
+    static float getRenderScale(){ return renderScale; }
+
+    static void setBackend(std::string name){ backend = std::move(name); }
+
+    // startup time of the programs and how many came from the binary cache
+    static void setProgramsReady(double ms, uint32_t cached, uint32_t count){
+        std::lock_guard<std::mutex> lock(mutex);
+        programsReadyMs = ms;
+        programsCached = cached;
+        programCount = count;
+    }
+
+    /**
+     * @brief Enable the benchmark report, written as json at the end of Engine::run
+     *
+     * @param path output json file
+     */
+    static void setBenchmarkOutput(std::string path){ benchmarkPath = std::move(path); }
+
+    static void writeBenchmark();
+};
+
+} // namespace ngn
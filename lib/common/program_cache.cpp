@@ -0,0 +1,167 @@
+#include "program_cache.hpp"
+//std
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+namespace ngn
+{
+
+namespace
+{
+    constexpr char MAGIC[4] = {'N', 'G', 'P', 'B'};
+    constexpr uint32_t VERSION = 1;
+    constexpr uint64_t FNV_PRIME = 0x100000001b3ull;
+
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+        uint64_t driver;
+        uint64_t key;
+        uint32_t format;
+        uint32_t reserved;
+        uint64_t size;
+        // hash of the binary, catches a corrupted file before the driver sees it
+        uint64_t checksum;
+    };
+
+    bool makeDirectory(const std::filesystem::path &directory)
+    {
+        std::error_code error{};
+        std::filesystem::create_directories(directory, error);
+        return !error && std::filesystem::is_directory(directory, error);
+    }
+}
+
+ProgramCache::ProgramCache(const std::string &directory, std::string_view driver)
+    : driver_{hash(driver)}
+{
+    if(makeDirectory(directory)){
+        directory_ = directory;
+        return;
+    }
+    std::error_code error{};
+    auto temp = std::filesystem::temp_directory_path(error);
+    if(!error && makeDirectory(temp / "opengl_vulkan" / "programs")){
+        directory_ = (temp / "opengl_vulkan" / "programs").string();
+    }
+}
+
+uint64_t ProgramCache::hash(std::span<const std::byte> bytes, uint64_t seed)
+{
+    uint64_t h = seed;
+    for(std::byte b : bytes){
+        h ^= static_cast<uint64_t>(b);
+        h *= FNV_PRIME;
+    }
+    return h;
+}
+
+uint64_t ProgramCache::hash(std::string_view text, uint64_t seed)
+{
+    return hash(std::as_bytes(std::span{text.data(), text.size()}), seed);
+}
+
+uint64_t ProgramCache::key(std::span<const std::vector<char>> sources) const
+{
+    uint64_t h = hash(std::as_bytes(std::span{&driver_, 1}));
+    for(const auto &source : sources){
+        // the size keeps "ab" + "c" apart from "a" + "bc"
+        const uint64_t size = source.size();
+        h = hash(std::as_bytes(std::span{&size, 1}), h);
+        h = hash(std::as_bytes(std::span{source.data(), source.size()}), h);
+    }
+    return h;
+}
+
+std::string ProgramCache::path(uint64_t key) const
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+    return (std::filesystem::path(directory_) / name).string();
+}
+
+std::optional<ProgramCache::Binary> ProgramCache::load(uint64_t key) const
+{
+    if(directory_.empty()){
+        return std::nullopt;
+    }
+    std::ifstream file(path(key), std::ios::binary | std::ios::ate);
+    if(!file){
+        return std::nullopt;
+    }
+    const auto fileSize = static_cast<uint64_t>(file.tellg());
+    if(fileSize < sizeof(Header)){
+        return std::nullopt;
+    }
+    file.seekg(0);
+    Header header{};
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if(!file || std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+       header.driver != driver_ || header.key != key || header.size != fileSize - sizeof(Header)){
+        return std::nullopt;
+    }
+
+    Binary binary{header.format, std::vector<std::byte>(static_cast<size_t>(header.size))};
+    file.read(reinterpret_cast<char*>(binary.data.data()), static_cast<std::streamsize>(binary.data.size()));
+    if(!file || hash(binary.data) != header.checksum){
+        return std::nullopt;
+    }
+    return binary;
+}
+
+bool ProgramCache::store(uint64_t key, uint32_t format, std::span<const std::byte> data) const
+{
+    if(directory_.empty()){
+        return false;
+    }
+    Header header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.driver = driver_;
+    header.key = key;
+    header.format = format;
+    header.size = data.size();
+    header.checksum = hash(data);
+
+    const std::string target = path(key);
+    const std::string temp = target + ".tmp";
+    {
+        std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        if(!file){
+            file.close();
+            std::error_code error{};
+            std::filesystem::remove(temp, error);
+            return false;
+        }
+    }
+    std::error_code error{};
+    std::filesystem::rename(temp, target, error);
+    if(error){
+        std::filesystem::remove(temp, error);
+        return false;
+    }
+    return true;
+}
+
+void ProgramCache::erase(uint64_t key) const
+{
+    if(directory_.empty()){
+        return;
+    }
+    std::error_code error{};
+    std::filesystem::remove(path(key), error);
+}
+
+void ProgramCache::clear(const std::string &directory)
+{
+    std::error_code error{};
+    std::filesystem::remove_all(directory, error);
+}
+
+} // namespace ngn
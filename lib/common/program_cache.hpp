@@ -0,0 +1,67 @@
+#pragma once
+//std
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ngn
+{
+
+/**
+ * @brief Linked program binaries on disk, one file per key in a cache directory.
+ *        A binary is only valid for the driver that produced it: entries written under another
+ *        driver string, truncated or corrupted are reported as a miss and the caller links again.
+ *        Nothing here throws, a cache that can't be read or written just misses
+ */
+class ProgramCache
+{
+public:
+    static constexpr uint64_t HASH_SEED = 0xcbf29ce484222325ull;
+    // of the engine programs, relative to the working directory
+    static constexpr const char *DIRECTORY = "cache/programs";
+
+    struct Binary
+    {
+        // driver defined, as returned by glGetProgramBinary
+        uint32_t format;
+        std::vector<std::byte> data;
+    };
+
+    /**
+     * @param directory created if missing, if it can't be a folder of the temp directory is used
+     * @param driver vendor, renderer and version of the driver
+     */
+    ProgramCache(const std::string &directory, std::string_view driver);
+
+    // 64 bit FNV-1a, chain the calls to hash several buffers
+    static uint64_t hash(std::span<const std::byte> bytes, uint64_t seed = HASH_SEED);
+    static uint64_t hash(std::string_view text, uint64_t seed = HASH_SEED);
+
+    /**
+     * @brief Key of a program: its sources and the driver
+     */
+    uint64_t key(std::span<const std::vector<char>> sources) const;
+
+    std::optional<Binary> load(uint64_t key) const;
+    // replace the entry, written aside and renamed so readers never see half a file
+    bool store(uint64_t key, uint32_t format, std::span<const std::byte> data) const;
+    // drop an entry the driver refused
+    void erase(uint64_t key) const;
+    // drop every entry of a directory, the next run starts cold
+    static void clear(const std::string &directory);
+
+    // empty when no directory could be created, every load misses
+    const std::string& directory() const { return directory_; }
+
+private:
+    std::string path(uint64_t key) const;
+
+    std::string directory_{};
+    uint64_t driver_ = 0;
+};
+
+} // namespace ngn
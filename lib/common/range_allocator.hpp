@@ -0,0 +1,95 @@
+#pragma once
+
+//std
+#include <cstdint>
+#include <iterator>
+#include <map>
+
+namespace ngn
+{
+
+/**
+ * @brief First fit sub-allocation of ranges of [0, capacity), for elements of a shared gpu buffer.
+ *        Freed ranges merge with their free neighbours; grow() appends free space at the end
+ */
+class RangeAllocator
+{
+public:
+    static constexpr uint32_t NO_RANGE = UINT32_MAX;
+
+    explicit RangeAllocator(uint32_t capacity = 0) { grow(capacity); }
+
+    /**
+     * @brief Reserve count elements
+     *
+     * @return first element, NO_RANGE if no free range is large enough
+     */
+    uint32_t allocate(uint32_t count)
+    {
+        if(count == 0){
+            return NO_RANGE;
+        }
+        for(auto it = free_.begin(); it != free_.end(); ++it){
+            if(it->second < count){
+                continue;
+            }
+            const uint32_t offset = it->first;
+            const uint32_t left = it->second - count;
+            free_.erase(it);
+            if(left){
+                free_.emplace(offset + count, left);
+            }
+            used_ += count;
+            return offset;
+        }
+        return NO_RANGE;
+    }
+
+    // give back a range returned by allocate()
+    void free(uint32_t offset, uint32_t count)
+    {
+        if(offset == NO_RANGE || count == 0){
+            return;
+        }
+        used_ -= count;
+        auto next = free_.lower_bound(offset);
+        if(next != free_.begin()){
+            auto prev = std::prev(next);
+            if(prev->first + prev->second == offset){
+                offset = prev->first;
+                count += prev->second;
+                free_.erase(prev);
+            }
+        }
+        if(next != free_.end() && offset + count == next->first){
+            count += next->second;
+            free_.erase(next);
+        }
+        free_.emplace(offset, count);
+    }
+
+    // extend the managed space to capacity elements, never shrinks
+    void grow(uint32_t capacity)
+    {
+        if(capacity <= capacity_){
+            return;
+        }
+        const uint32_t added = capacity - capacity_;
+        const uint32_t offset = capacity_;
+        capacity_ = capacity;
+        // a free range is given back like any other, merging with a free tail
+        used_ += added;
+        free(offset, added);
+    }
+
+    uint32_t capacity() const { return capacity_; }
+    uint32_t used() const { return used_; }
+
+private:
+    // free ranges, offset to count
+    std::map<uint32_t, uint32_t> free_{};
+    uint32_t capacity_{0};
+    uint32_t used_{0};
+};
+
+} // namespace ngn
@@ -0,0 +1,110 @@
+#pragma once
+#include "bounds.hpp"
+//lib
+#include <glm/glm.hpp>
+//std
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace ngn
+{
+
+/**
+ * @brief Half line origin + t * direction, t >= 0
+ *        invDirection is cached for the slab tests, infinite on axis parallel rays
+ */
+struct Ray
+{
+    glm::vec3 origin{0.0f};
+    glm::vec3 direction{0.0f, 0.0f, -1.0f};
+    glm::vec3 invDirection{0.0f, 0.0f, -1.0f};
+
+    Ray() = default;
+    Ray(const glm::vec3 &o, const glm::vec3 &d)
+        : origin{o}, direction{d}, invDirection{1.0f / d.x, 1.0f / d.y, 1.0f / d.z} {}
+
+    glm::vec3 at(float t) const { return origin + direction * t; }
+
+    /**
+     * @brief Ray from the camera through a window position, as given by MultiplatformInput
+     *
+     * @param cursor window coordinates in pixels, origin top left
+     * @param viewport window size in pixels
+     * @param view
+     * @param proj opengl convention, as Engine::getMVP
+     * @return world space ray starting on the near plane, unit direction
+     */
+    static Ray fromScreen(std::pair<float, float> cursor, std::pair<float, float> viewport,
+                          const glm::mat4 &view, const glm::mat4 &proj)
+    {
+        const float x = 2.0f * cursor.first / viewport.first - 1.0f;
+        const float y = 1.0f - 2.0f * cursor.second / viewport.second;
+
+        const glm::mat4 inverse = glm::inverse(proj * view);
+        glm::vec4 nearPoint = inverse * glm::vec4(x, y, -1.0f, 1.0f);
+        glm::vec4 farPoint  = inverse * glm::vec4(x, y,  1.0f, 1.0f);
+        const glm::vec3 from = glm::vec3(nearPoint) / nearPoint.w;
+        const glm::vec3 to   = glm::vec3(farPoint) / farPoint.w;
+
+        return Ray{from, glm::normalize(to - from)};
+    }
+};
+
+/**
+ * @brief Slab test
+ *
+ * @param tMax farthest distance of interest
+ * @param tNear entry distance, 0 if the origin is inside the box
+ * @return true if the ray enters the box before tMax
+ */
+inline bool intersect(const Ray &ray, const Aabb &box, float tMax, float &tNear)
+{
+    const glm::vec3 t0 = (box.min - ray.origin) * ray.invDirection;
+    const glm::vec3 t1 = (box.max - ray.origin) * ray.invDirection;
+
+    const float enter = std::max({std::min(t0.x, t1.x), std::min(t0.y, t1.y), std::min(t0.z, t1.z), 0.0f});
+    const float exit  = std::min({std::max(t0.x, t1.x), std::max(t0.y, t1.y), std::max(t0.z, t1.z), tMax});
+
+    tNear = enter;
+    return enter <= exit;
+}
+
+/**
+ * @brief Two sided ray triangle test (Moller-Trumbore)
+ *
+ * @param t distance of the hit in direction units, set only on hit
+ * @return true if the triangle is hit in [0, tMax)
+ */
+inline bool intersect(const Ray &ray, const glm::vec3 &v0, const glm::vec3 &v1, const glm::vec3 &v2, float tMax, float &t)
+{
+    const glm::vec3 e1 = v1 - v0;
+    const glm::vec3 e2 = v2 - v0;
+    const glm::vec3 p = glm::cross(ray.direction, e2);
+    const float det = glm::dot(e1, p);
+    // ray parallel to the triangle plane
+    if(det == 0.0f){
+        return false;
+    }
+    const float invDet = 1.0f / det;
+
+    const glm::vec3 s = ray.origin - v0;
+    const float u = glm::dot(s, p) * invDet;
+    if(u < 0.0f || u > 1.0f){
+        return false;
+    }
+    const glm::vec3 q = glm::cross(s, e1);
+    const float v = glm::dot(ray.direction, q) * invDet;
+    if(v < 0.0f || u + v > 1.0f){
+        return false;
+    }
+
+    const float hit = glm::dot(e2, q) * invDet;
+    if(hit < 0.0f || hit >= tMax){
+        return false;
+    }
+    t = hit;
+    return true;
+}
+
+} // namespace ngn
@@ -0,0 +1,235 @@
+#include "render_graph.hpp"
+//std
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+namespace ngn
+{
+
+RenderGraph::ResourceId RenderGraph::importResource(std::string name, GraphUsage initial, GraphUsage final, bool discard)
+{
+    resources_.push_back({std::move(name), false, initial, final, discard});
+    return static_cast<ResourceId>(resources_.size() - 1);
+}
+
+RenderGraph::ResourceId RenderGraph::createTransient(std::string name)
+{
+    resources_.push_back({std::move(name), true, GraphUsage::NONE, GraphUsage::NONE, true});
+    return static_cast<ResourceId>(resources_.size() - 1);
+}
+
+RenderGraph::PassId RenderGraph::addPass(std::string name, bool sideEffect)
+{
+    passes_.push_back({std::move(name), sideEffect, false, {}});
+    return static_cast<PassId>(passes_.size() - 1);
+}
+
+void RenderGraph::read(PassId pass, ResourceId resource, GraphUsage usage)
+{
+    access(pass, resource, usage, false);
+}
+
+void RenderGraph::write(PassId pass, ResourceId resource, GraphUsage usage)
+{
+    access(pass, resource, usage, true);
+}
+
+void RenderGraph::access(PassId pass, ResourceId resource, GraphUsage usage, bool write)
+{
+    if(resource >= resources_.size()){
+        throw std::runtime_error("render graph resource not declared!");
+    }
+    auto &accesses = passes_.at(pass).accesses;
+    auto found = std::find_if(accesses.begin(), accesses.end(), [&](const Access &a){ return a.resource == resource; });
+    if(found == accesses.end()){
+        accesses.push_back({resource, usage, !write, write});
+        return;
+    }
+    if(found->usage != usage){
+        throw std::runtime_error("render graph pass " + passes_[pass].name + " uses " + resources_[resource].name + " twice!");
+    }
+    (write ? found->write : found->read) = true;
+}
+
+void RenderGraph::cull()
+{
+    // resources whose current content is still needed, walking from the last pass
+    std::vector<bool> live(resources_.size(), false);
+    for(size_t i = 0; i < resources_.size(); i++){
+        live[i] = !resources_[i].transient && resources_[i].final != GraphUsage::NONE;
+    }
+
+    for(auto pass = passes_.rbegin(); pass != passes_.rend(); pass++){
+        pass->kept = pass->sideEffect || std::any_of(pass->accesses.begin(), pass->accesses.end(),
+            [&](const Access &a){ return a.write && live[a.resource]; });
+        if(!pass->kept){
+            continue;
+        }
+        // a full write produces the content, earlier writers are not needed for it
+        for(const Access &a : pass->accesses){
+            if(a.write && !a.read){
+                live[a.resource] = false;
+            }
+        }
+        for(const Access &a : pass->accesses){
+            if(a.read){
+                live[a.resource] = true;
+            }
+        }
+    }
+}
+
+void RenderGraph::compile()
+{
+    cull();
+
+    struct State
+    {
+        GraphUsage usage = GraphUsage::NONE;
+        bool written = false;
+        bool discard = true;
+    };
+    std::vector<State> states(resources_.size());
+    for(size_t i = 0; i < resources_.size(); i++){
+        // the previous frame may still access an import: treated as a write
+        states[i] = {resources_[i].initial, resources_[i].initial != GraphUsage::NONE, resources_[i].discard};
+    }
+
+    compiled_.clear();
+    final_.clear();
+    lifetimes_.clear();
+    std::vector<int64_t> first(resources_.size(), -1);
+    std::vector<int64_t> last(resources_.size(), -1);
+
+    for(PassId id = 0; id < passes_.size(); id++){
+        const Pass &pass = passes_[id];
+        if(!pass.kept){
+            continue;
+        }
+        CompiledPass compiled{id, {}};
+        const auto index = static_cast<int64_t>(compiled_.size());
+
+        for(const Access &a : pass.accesses){
+            State &state = states[a.resource];
+            // reads of the same usage share the layout and need no barrier
+            if(state.usage != a.usage || state.written || a.write){
+                compiled.before.push_back({a.resource, state.usage, a.usage, state.written, a.write, state.discard});
+            }
+            state = {a.usage, a.write, false};
+
+            if(first[a.resource] < 0){
+                first[a.resource] = index;
+            }
+            last[a.resource] = index;
+        }
+        compiled_.push_back(std::move(compiled));
+    }
+
+    for(ResourceId id = 0; id < resources_.size(); id++){
+        const Resource &resource = resources_[id];
+        if(!resource.transient && resource.final != GraphUsage::NONE && states[id].usage != resource.final){
+            final_.push_back({id, states[id].usage, resource.final, states[id].written, false, states[id].discard});
+        }
+        if(resource.transient && first[id] >= 0){
+            lifetimes_.push_back({id, static_cast<uint32_t>(first[id]), static_cast<uint32_t>(last[id]),
+                                  states[id].usage, states[id].written});
+        }
+    }
+}
+
+std::vector<uint64_t> RenderGraph::placeTransients(std::span<const TransientMemory> transients, std::vector<uint64_t> &offsets)
+{
+    offsets.assign(transients.size(), 0);
+    std::vector<uint64_t> heapSizes{};
+    std::vector<const Lifetime*> lifetimes(transients.size(), nullptr);
+    for(size_t i = 0; i < transients.size(); i++){
+        auto found = std::find_if(lifetimes_.begin(), lifetimes_.end(), [&](const Lifetime &l){ return l.resource == transients[i].resource; });
+        if(found == lifetimes_.end()){
+            throw std::runtime_error("render graph transient " + resources_.at(transients[i].resource).name + " has no lifetime!");
+        }
+        lifetimes[i] = &*found;
+        heapSizes.resize(std::max<size_t>(heapSizes.size(), transients[i].heap + 1), 0);
+    }
+
+    std::vector<AliasBlock> blocks{};
+    std::vector<size_t> members{};
+    std::vector<uint64_t> heapOffsets{};
+    for(uint32_t heap = 0; heap < heapSizes.size(); heap++){
+        blocks.clear();
+        members.clear();
+        for(size_t i = 0; i < transients.size(); i++){
+            if(transients[i].heap == heap){
+                blocks.push_back({lifetimes[i]->first, lifetimes[i]->last, transients[i].size, transients[i].alignment});
+                members.push_back(i);
+            }
+        }
+        heapSizes[heap] = alias(blocks, heapOffsets);
+        for(size_t m = 0; m < members.size(); m++){
+            offsets[members[m]] = heapOffsets[m];
+        }
+    }
+
+    // the first transition of a transient waits for the earlier users of its bytes
+    for(size_t b = 0; b < transients.size(); b++){
+        const Lifetime &next = *lifetimes[b];
+        auto &before = compiled_[next.first].before;
+        auto first = std::find_if(before.begin(), before.end(), [&](const Transition &t){ return t.resource == next.resource; });
+        if(first == before.end()){
+            continue;
+        }
+        const Transition entered = *first;
+        for(size_t a = 0; a < transients.size(); a++){
+            const Lifetime &previous = *lifetimes[a];
+            const bool overlap = offsets[a] < offsets[b] + transients[b].size && offsets[b] < offsets[a] + transients[a].size;
+            if(transients[a].heap != transients[b].heap || !overlap || previous.last >= next.first){
+                continue;
+            }
+            first = before.insert(first, {previous.resource, previous.lastUsage, entered.to, previous.lastWrite, entered.toWrite, true, true}) + 1;
+        }
+    }
+    return heapSizes;
+}
+
+uint64_t RenderGraph::alias(std::span<const AliasBlock> blocks, std::vector<uint64_t> &offsets)
+{
+    offsets.assign(blocks.size(), 0);
+
+    // largest first: small blocks fill the gaps left between the large ones
+    std::vector<size_t> order(blocks.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b){ return blocks[a].size > blocks[b].size; });
+
+    struct Range { uint64_t begin; uint64_t end; };
+    std::vector<size_t> placed{};
+    std::vector<Range> taken{};
+    uint64_t total = 0;
+
+    for(size_t index : order){
+        const AliasBlock &block = blocks[index];
+        const uint64_t alignment = std::max<uint64_t>(block.alignment, 1);
+
+        // memory used meanwhile by the blocks already placed
+        taken.clear();
+        for(size_t other : placed){
+            if(blocks[other].first <= block.last && block.first <= blocks[other].last){
+                taken.push_back({offsets[other], offsets[other] + blocks[other].size});
+            }
+        }
+        std::sort(taken.begin(), taken.end(), [](const Range &a, const Range &b){ return a.begin < b.begin; });
+
+        uint64_t offset = 0;
+        for(const Range &range : taken){
+            if(offset + block.size <= range.begin){
+                break;
+            }
+            offset = std::max(offset, (range.end + alignment - 1) / alignment * alignment);
+        }
+        offsets[index] = offset;
+        placed.push_back(index);
+        total = std::max(total, offset + block.size);
+    }
+    return total;
+}
+
+} // namespace ngn
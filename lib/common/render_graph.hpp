@@ -0,0 +1,176 @@
+#pragma once
+//std
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace ngn
+{
+
+/**
+ * @brief How a pass uses an image, a change of usage or a write needs a barrier
+ *
+ */
+enum class GraphUsage : uint32_t {
+    NONE,
+    COLOR_ATTACHMENT,
+    DEPTH_ATTACHMENT,
+    SAMPLED,
+    TRANSFER_SRC,
+    TRANSFER_DST,
+    PRESENT,
+    COUNT
+};
+
+/**
+ * @brief Frame passes in submission order with the resources they read and write.
+ *        compile() drops the passes whose writes reach no output, lists the transitions
+ *        each kept pass needs and the lifetime of the transient resources. The backends map
+ *        usages to their barriers and place transients of disjoint lifetimes in the same memory
+ *        with placeTransients(), which also orders each transient after the previous users of its memory
+ */
+class RenderGraph
+{
+public:
+    using ResourceId = uint32_t;
+    using PassId = uint32_t;
+
+    struct Transition
+    {
+        ResourceId resource = 0;
+        GraphUsage from = GraphUsage::NONE;
+        GraphUsage to = GraphUsage::NONE;
+        // last access before the transition wrote, the next one writes
+        bool fromWrite = false;
+        bool toWrite = false;
+        // the content is not kept: first use of a transient or of a discarded import
+        bool discard = false;
+        // resource is a transient whose memory the next one takes over:
+        // a memory dependency from its last usage, no layout change
+        bool aliasing = false;
+    };
+
+    struct CompiledPass
+    {
+        PassId pass = 0;
+        // recorded before the pass
+        std::vector<Transition> before{};
+    };
+
+    // first and last index in passes() using a transient
+    struct Lifetime
+    {
+        ResourceId resource = 0;
+        uint32_t first = 0;
+        uint32_t last = 0;
+        // access of the last pass
+        GraphUsage lastUsage = GraphUsage::NONE;
+        bool lastWrite = false;
+    };
+
+    // memory needs of a transient, transients share memory only within a heap
+    struct TransientMemory
+    {
+        ResourceId resource = 0;
+        uint32_t heap = 0;
+        uint64_t size = 0;
+        uint64_t alignment = 1;
+    };
+
+    struct AliasBlock
+    {
+        uint32_t first = 0;
+        uint32_t last = 0;
+        uint64_t size = 0;
+        uint64_t alignment = 1;
+    };
+
+    /**
+     * @brief Resource owned outside of the graph
+     *
+     * @param initial usage left by the previous frame
+     * @param final usage expected after the frame, NONE when the resource is no output
+     * @param discard the frame does not read the previous content
+     */
+    ResourceId importResource(std::string name, GraphUsage initial, GraphUsage final, bool discard);
+    // created for the graph, content undefined before its first pass
+    ResourceId createTransient(std::string name);
+
+    // passes run in the order they are added, a side effect pass is never culled
+    PassId addPass(std::string name, bool sideEffect = false);
+    // one usage per resource and pass, read and write of the same resource for a read-modify-write
+    void read(PassId pass, ResourceId resource, GraphUsage usage);
+    void write(PassId pass, ResourceId resource, GraphUsage usage);
+
+    void compile();
+
+    // kept passes in order, valid after compile()
+    const std::vector<CompiledPass>& passes() const { return compiled_; }
+    // outputs moved to their final usage after the last pass
+    const std::vector<Transition>& finalTransitions() const { return final_; }
+    // of the transients used by a kept pass
+    const std::vector<Lifetime>& lifetimes() const { return lifetimes_; }
+    bool culled(PassId pass) const { return !passes_.at(pass).kept; }
+
+    const std::string& passName(PassId pass) const { return passes_.at(pass).name; }
+    const std::string& resourceName(ResourceId resource) const { return resources_.at(resource).name; }
+    bool transient(ResourceId resource) const { return resources_.at(resource).transient; }
+    size_t passCount() const { return passes_.size(); }
+
+    /**
+     * @brief Offsets in one memory block, blocks of overlapping lifetimes never share bytes
+     *
+     * @param offsets one per block, aligned
+     * @return uint64_t size of the memory holding every block
+     */
+    static uint64_t alias(std::span<const AliasBlock> blocks, std::vector<uint64_t> &offsets);
+
+    /**
+     * @brief Offsets of the transients in their heap, after compile(). A transient placed over bytes
+     *        of earlier ones gets an aliasing transition from each of them before its first transition
+     *
+     * @param transients one per lifetime
+     * @param offsets one per transient, aligned
+     * @return std::vector<uint64_t> size of every heap, indexed by heap
+     */
+    std::vector<uint64_t> placeTransients(std::span<const TransientMemory> transients, std::vector<uint64_t> &offsets);
+
+private:
+    struct Access
+    {
+        ResourceId resource = 0;
+        GraphUsage usage = GraphUsage::NONE;
+        bool read = false;
+        bool write = false;
+    };
+
+    struct Pass
+    {
+        std::string name{};
+        bool sideEffect = false;
+        bool kept = false;
+        std::vector<Access> accesses{};
+    };
+
+    struct Resource
+    {
+        std::string name{};
+        bool transient = false;
+        GraphUsage initial = GraphUsage::NONE;
+        GraphUsage final = GraphUsage::NONE;
+        bool discard = true;
+    };
+
+    void access(PassId pass, ResourceId resource, GraphUsage usage, bool write);
+    void cull();
+
+    std::vector<Resource> resources_{};
+    std::vector<Pass> passes_{};
+
+    std::vector<CompiledPass> compiled_{};
+    std::vector<Transition> final_{};
+    std::vector<Lifetime> lifetimes_{};
+};
+
+} // namespace ngn
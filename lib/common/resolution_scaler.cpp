@@ -0,0 +1,60 @@
+#include "resolution_scaler.hpp"
+//std
+#include <algorithm>
+#include <cmath>
+
+namespace ngn
+{
+
+ResolutionScaler::ResolutionScaler(Settings settings)
+    : settings_{settings}
+    , scale_{settings.maxScale}
+{
+}
+
+float ResolutionScaler::update(float gpuMs)
+{
+    const float target = targetMs_;
+    if(target <= 0.f){
+        scale_ = settings_.maxScale;
+        smoothedMs_ = 0.f;
+        settle_ = 0;
+        return scale_;
+    }
+    if(gpuMs <= 0.f){
+        return scale_;
+    }
+
+    smoothedMs_ = smoothedMs_ > 0.f ? smoothedMs_ + settings_.smoothing * (gpuMs - smoothedMs_) : gpuMs;
+    if(settle_ > 0){
+        settle_--;
+        return scale_;
+    }
+
+    const float larger = std::min(scale_ + settings_.step, settings_.maxScale);
+    const float growth = (larger * larger) / (scale_ * scale_);
+    float next = scale_;
+    if(smoothedMs_ > target){
+        next = std::max(scale_ - settings_.step, settings_.minScale);
+    }else if(smoothedMs_ * growth < target){
+        next = larger;
+    }
+
+    if(next != scale_){
+        // the smoothed time restarts from the timings of the new size
+        scale_ = next;
+        smoothedMs_ = 0.f;
+        settle_ = settings_.settleFrames;
+    }
+    return scale_;
+}
+
+std::pair<uint32_t, uint32_t> ResolutionScaler::scaled(uint32_t width, uint32_t height) const
+{
+    auto apply = [this](uint32_t size){
+        return std::clamp(static_cast<uint32_t>(std::lround(size * scale_)), 1u, std::max(size, 1u));
+    };
+    return {apply(width), apply(height)};
+}
+
+} // namespace ngn
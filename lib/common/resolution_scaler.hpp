@@ -0,0 +1,61 @@
+#pragma once
+//std
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+namespace ngn
+{
+
+/**
+ * @brief Scale of the scene render target, adjusted from the measured gpu frame time to hold a target.
+ *        The time is smoothed and the scale moves one step at a time, then waits for the gpu timings
+ *        of the new size before the next step. Going down is eager, going up only when the time
+ *        predicted at the larger size (pixels grow with the square of the scale) still fits the target
+ */
+class ResolutionScaler
+{
+public:
+    struct Settings
+    {
+        float minScale = 0.5f;
+        float maxScale = 1.0f;
+        float step = 0.05f;
+        // frames between two steps, covers the latency of the gpu timings
+        uint32_t settleFrames = 8;
+        // weight of the new sample in the smoothed time
+        float smoothing = 0.2f;
+    };
+
+    ResolutionScaler() = default;
+    explicit ResolutionScaler(Settings settings);
+
+    /**
+     * @brief Gpu milliseconds per frame to hold, 0 renders at full resolution.
+     *        Shared by every scaler, written by the ui or the command line, read by the renderer
+     */
+    static void setTargetFrameTime(float ms) { targetMs_ = ms > 0.f ? ms : 0.f; }
+    static float getTargetFrameTime() { return targetMs_; }
+
+    /**
+     * @brief Feed the gpu time of the last measured frame, once per rendered frame
+     *
+     * @param gpuMs 0 when no timing is available yet, the scale is kept
+     * @return scale of the next frame
+     */
+    float update(float gpuMs);
+    float scale() const { return scale_; }
+
+    // size of the scene target for a window of width by height, never 0
+    std::pair<uint32_t, uint32_t> scaled(uint32_t width, uint32_t height) const;
+
+private:
+    inline static std::atomic<float> targetMs_{0.f};
+
+    Settings settings_{};
+    float scale_ = 1.0f;
+    float smoothedMs_ = 0.f;
+    uint32_t settle_ = 0;
+};
+
+} // namespace ngn
@@ -0,0 +1,68 @@
+#pragma once
+
+//std
+#include <array>
+#include <cstddef>
+
+namespace ngn
+{
+
+/**
+ * @brief Fixed size circular history, push overwrites the oldest value
+ *        Storage is a std::array: no allocation after construction
+ *
+ * @tparam T value type
+ * @tparam N capacity
+ */
+template<typename T, size_t N>
+class RingBuffer
+{
+public:
+    static_assert(N > 0, "RingBuffer capacity must be greater than zero");
+
+    void push(const T &value){
+        values_[head_] = value;
+        head_ = (head_ + 1) % N;
+        if(count_ < N){
+            count_++;
+        }
+    }
+
+    void clear(){
+        head_ = 0;
+        count_ = 0;
+    }
+
+    /**
+     * @brief Get a value by age
+     *
+     * @param i 0 is the oldest stored value, size() - 1 the latest
+     * @return const T&
+     */
+    const T& operator[](size_t i) const { return values_[(head_ + N - count_ + i) % N]; }
+
+    const T& latest() const { return values_[(head_ + N - 1) % N]; }
+
+    /**
+     * @brief Raw storage, to be read from offset() to keep the chronological order
+     *        ( e.g. ImGui::PlotLines values_offset )
+     */
+    const T* data() const { return values_.data(); }
+
+    /**
+     * @brief Index of the oldest value in data() once the buffer is full
+     */
+    size_t offset() const { return count_ < N ? 0 : head_; }
+
+    size_t size() const { return count_; }
+    static constexpr size_t capacity() { return N; }
+    bool empty() const { return count_ == 0; }
+    bool full() const { return count_ == N; }
+
+private:
+    std::array<T, N> values_{};
+    size_t head_{0};
+    size_t count_{0};
+};
+
+} // namespace ngn
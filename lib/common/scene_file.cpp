@@ -0,0 +1,359 @@
+#include "scene_file.hpp"
+#include "glsl_constants.h"
+//libs
+#include <nlohmann/json.hpp>
+//std
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+
+namespace ngn
+{
+
+namespace
+{
+    using Json = nlohmann::json;
+
+    constexpr char MAGIC[4] = {'N', 'G', 'S', 'C'};
+    constexpr uint32_t VERSION = 1;
+
+    static_assert(std::is_trivially_copyable_v<SceneMaterial> && std::is_trivially_copyable_v<SceneTexture> &&
+                  std::is_trivially_copyable_v<SceneNode>, "scene records are copied as bytes");
+    static_assert(alignof(SceneNode) == 4 && alignof(SceneMaterial) == 4 && alignof(SceneTexture) == 4,
+                  "scene records are packed one after the other");
+
+    [[noreturn]] void fail(const std::string &message)
+    {
+        throw std::runtime_error("scene: " + message);
+    }
+
+    // member of an object, nullptr if missing
+    const Json* find(const Json &object, std::string_view key)
+    {
+        if(!object.is_object()){
+            fail("expected an object around \"" + std::string(key) + "\"");
+        }
+        auto found = object.find(std::string(key));
+        return found == object.end() ? nullptr : &*found;
+    }
+
+    const Json& member(const Json &object, std::string_view key)
+    {
+        const Json *value = find(object, key);
+        if(!value){
+            fail("missing \"" + std::string(key) + "\"");
+        }
+        return *value;
+    }
+
+    // typed access, the key only names the value in the error
+    const std::string& asString(const Json &value, std::string_view key)
+    {
+        if(!value.is_string()){
+            fail("\"" + std::string(key) + "\" must be a string");
+        }
+        return value.get_ref<const std::string&>();
+    }
+
+    const Json::array_t& asArray(const Json &value, std::string_view key)
+    {
+        if(!value.is_array()){
+            fail("\"" + std::string(key) + "\" must be an array");
+        }
+        return value.get_ref<const Json::array_t&>();
+    }
+
+    double asNumber(const Json &value, std::string_view key)
+    {
+        if(!value.is_number()){
+            fail("\"" + std::string(key) + "\" must be a number");
+        }
+        return value.get<double>();
+    }
+
+    std::string optionalString(const Json &object, std::string_view key, std::string_view fallback)
+    {
+        const Json *value = find(object, key);
+        return value ? asString(*value, key) : std::string(fallback);
+    }
+
+    void readVec3(const Json &object, std::string_view key, float (&out)[3], float fallback)
+    {
+        out[0] = out[1] = out[2] = fallback;
+        const Json *value = find(object, key);
+        if(!value){
+            return;
+        }
+        const auto &items = asArray(*value, key);
+        if(items.size() != 3){
+            fail("\"" + std::string(key) + "\" needs 3 numbers");
+        }
+        for(size_t i = 0; i < 3; i++){
+            out[i] = static_cast<float>(asNumber(items[i], key));
+        }
+    }
+
+    // shader binding of a texture, the image sampler if not given
+    uint32_t textureBinding(const Json &texture)
+    {
+        const Json *value = find(texture, "binding");
+        if(!value){
+            return static_cast<uint32_t>(GLSL::IMAGE_SAMPLER);
+        }
+        // negative, fractional or too large values can't be cast
+        if(!value->is_number_unsigned() || value->get<uint64_t>() > std::numeric_limits<uint32_t>::max()){
+            fail("texture binding must be an integer from 0 to " + std::to_string(std::numeric_limits<uint32_t>::max()));
+        }
+        return static_cast<uint32_t>(value->get<uint64_t>());
+    }
+
+    uint32_t shaderType(const std::string &name)
+    {
+        for(uint32_t type = GLSL::AXIS; type <= GLSL::NORMALMAP; type++){
+            if(GLSL::getName(static_cast<GLSL::ShaderType>(type)) == name){
+                return type;
+            }
+        }
+        fail("unknown shader " + name);
+    }
+
+    // strings deduplicated, models are usually shared by several nodes
+    class StringTable
+    {
+    public:
+        SceneString add(const std::string &str)
+        {
+            auto [it, inserted] = offsets_.try_emplace(str, SceneString{static_cast<uint32_t>(bytes_.size()), static_cast<uint32_t>(str.size())});
+            if(inserted){
+                bytes_.insert(bytes_.end(), str.begin(), str.end());
+            }
+            return it->second;
+        }
+        const std::string& bytes() const { return bytes_; }
+
+    private:
+        std::unordered_map<std::string, SceneString> offsets_{};
+        std::string bytes_{};
+    };
+
+    template<typename T>
+    void append(std::vector<std::byte> &blob, const T *records, size_t count)
+    {
+        const auto *bytes = reinterpret_cast<const std::byte*>(records);
+        blob.insert(blob.end(), bytes, bytes + count * sizeof(T));
+    }
+}
+
+SceneFile SceneFile::open(const std::string &path)
+{
+    if(std::filesystem::path(path).extension() == ".json"){
+        std::ifstream file(path, std::ios::binary);
+        if(!file.is_open()){
+            fail("failed to open " + path);
+        }
+        const std::string text{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+        try{
+            return fromJson(text);
+        }catch(const std::runtime_error &e){
+            throw std::runtime_error(path + ": " + e.what());
+        }
+    }
+
+    SceneFile scene{};
+    scene.mapped_ = MappedFile(path);
+    scene.data_ = scene.mapped_.data();
+    scene.size_ = scene.mapped_.size();
+    try{
+        scene.bind();
+    }catch(const std::runtime_error &e){
+        throw std::runtime_error(path + ": " + e.what());
+    }
+    return scene;
+}
+
+SceneFile SceneFile::fromJson(std::string_view text)
+{
+    Json document{};
+    try{
+        document = Json::parse(text.begin(), text.end());
+    }catch(const Json::parse_error &e){
+        fail(e.what());
+    }
+    StringTable strings{};
+
+    std::vector<SceneMaterial> materials{};
+    std::vector<SceneTexture> textures{};
+    std::unordered_map<std::string, uint32_t> materialIndex{};
+    if(const Json *list = find(document, "materials")){
+        for(const Json &item : asArray(*list, "materials")){
+            const std::string &name = asString(member(item, "name"), "name");
+            if(!materialIndex.try_emplace(name, static_cast<uint32_t>(materials.size())).second){
+                fail("material " + name + " defined twice");
+            }
+
+            SceneMaterial material{};
+            material.name = strings.add(name);
+            material.shader = shaderType(asString(member(item, "shader"), "shader"));
+            const std::string polygon = optionalString(item, "polygon", "triangles");
+            if(polygon != "triangles" && polygon != "lines"){
+                fail("material " + name + ": polygon is triangles or lines");
+            }
+            material.polygonMode = polygon == "lines" ? GLSL::LINES : GLSL::TRIANGLES;
+            material.firstTexture = static_cast<uint32_t>(textures.size());
+            if(const Json *list = find(item, "textures")){
+                for(const Json &texture : asArray(*list, "textures")){
+                    textures.push_back({strings.add(asString(member(texture, "path"), "path")), textureBinding(texture)});
+                }
+            }
+            material.textureCount = static_cast<uint32_t>(textures.size()) - material.firstTexture;
+            materials.push_back(material);
+        }
+    }
+
+    std::vector<SceneNode> nodes{};
+    std::unordered_map<std::string, uint32_t> nodeIndex{};
+    for(const Json &item : asArray(member(document, "nodes"), "nodes")){
+        const std::string &name = asString(member(item, "name"), "name");
+        if(!nodeIndex.try_emplace(name, static_cast<uint32_t>(nodes.size())).second){
+            fail("node " + name + " defined twice");
+        }
+
+        SceneNode node{};
+        node.name = strings.add(name);
+        node.model = strings.add(optionalString(item, "model", ""));
+        node.material = SCENE_NONE;
+        node.parent = SCENE_NONE;
+
+        const std::string material = optionalString(item, "material", "");
+        if((node.model.size == 0) != material.empty()){
+            fail("node " + name + ": model and material go together");
+        }
+        if(!material.empty()){
+            auto found = materialIndex.find(material);
+            if(found == materialIndex.end()){
+                fail("node " + name + ": unknown material " + material);
+            }
+            node.material = found->second;
+        }
+
+        const std::string parent = optionalString(item, "parent", "");
+        if(!parent.empty()){
+            auto found = nodeIndex.find(parent);
+            // the scene graph wants parents first, this also rules out cycles
+            if(found == nodeIndex.end() || found->second == nodes.size()){
+                fail("node " + name + ": parent " + parent + " must be listed before it");
+            }
+            node.parent = found->second;
+        }
+
+        const std::string up = optionalString(item, "up", "y");
+        if(up != "y" && up != "z"){
+            fail("node " + name + ": up is y or z");
+        }
+        // Model::UP
+        node.up = up == "z" ? 1 : 0;
+
+        readVec3(item, "translation", node.translation, 0.0f);
+        readVec3(item, "rotation", node.rotation, 0.0f);
+        readVec3(item, "scale", node.scale, 1.0f);
+        nodes.push_back(node);
+    }
+
+    const Header header{{MAGIC[0], MAGIC[1], MAGIC[2], MAGIC[3]}, VERSION,
+                        static_cast<uint32_t>(materials.size()), static_cast<uint32_t>(textures.size()),
+                        static_cast<uint32_t>(nodes.size()), static_cast<uint32_t>(strings.bytes().size())};
+    std::vector<std::byte> blob{};
+    append(blob, &header, 1);
+    append(blob, materials.data(), materials.size());
+    append(blob, textures.data(), textures.size());
+    append(blob, nodes.data(), nodes.size());
+    append(blob, strings.bytes().data(), strings.bytes().size());
+    return fromBinary(std::move(blob));
+}
+
+SceneFile SceneFile::fromBinary(std::vector<std::byte> blob)
+{
+    SceneFile scene{};
+    scene.owned_ = std::move(blob);
+    scene.data_ = scene.owned_.data();
+    scene.size_ = scene.owned_.size();
+    scene.bind();
+    return scene;
+}
+
+void SceneFile::save(const std::string &path) const
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if(!file.is_open()){
+        fail("failed to write " + path);
+    }
+    file.write(reinterpret_cast<const char*>(data_), static_cast<std::streamsize>(size_));
+}
+
+Transformations SceneFile::transform(const SceneNode &node)
+{
+    Transformations tra{};
+    tra.T = {node.translation[0], node.translation[1], node.translation[2]};
+    tra.R = {node.rotation[0], node.rotation[1], node.rotation[2]};
+    tra.S = {node.scale[0], node.scale[1], node.scale[2]};
+    return tra;
+}
+
+void SceneFile::bind()
+{
+    if(size_ < sizeof(Header) || reinterpret_cast<uintptr_t>(data_) % alignof(Header) != 0){
+        fail("not a scene file");
+    }
+    const Header &head = header();
+    if(std::memcmp(head.magic, MAGIC, sizeof(MAGIC)) != 0){
+        fail("not a scene file");
+    }
+    if(head.version != VERSION){
+        fail("version " + std::to_string(head.version) + " is not supported");
+    }
+
+    // 64 bit sums, counts come from the file
+    const uint64_t materialsAt = sizeof(Header);
+    const uint64_t texturesAt = materialsAt + uint64_t{head.materialCount} * sizeof(SceneMaterial);
+    const uint64_t nodesAt = texturesAt + uint64_t{head.textureCount} * sizeof(SceneTexture);
+    const uint64_t stringsAt = nodesAt + uint64_t{head.nodeCount} * sizeof(SceneNode);
+    if(stringsAt + head.stringBytes != size_){
+        fail("truncated or corrupted file");
+    }
+    materials_ = reinterpret_cast<const SceneMaterial*>(data_ + materialsAt);
+    textures_ = reinterpret_cast<const SceneTexture*>(data_ + texturesAt);
+    nodes_ = reinterpret_cast<const SceneNode*>(data_ + nodesAt);
+    strings_ = reinterpret_cast<const char*>(data_ + stringsAt);
+
+    auto checkString = [&](SceneString str){
+        if(uint64_t{str.offset} + str.size > head.stringBytes){
+            fail("string out of the table");
+        }
+    };
+    for(const SceneMaterial &material : materials()){
+        checkString(material.name);
+        if(material.shader > GLSL::NORMALMAP || material.polygonMode > GLSL::LINES ||
+           uint64_t{material.firstTexture} + material.textureCount > head.textureCount){
+            fail("invalid material");
+        }
+    }
+    for(const SceneTexture &texture : textures()){
+        checkString(texture.path);
+    }
+    for(uint32_t i = 0; i < head.nodeCount; i++){
+        const SceneNode &node = nodes_[i];
+        checkString(node.name);
+        checkString(node.model);
+        if((node.material != SCENE_NONE && node.material >= head.materialCount) ||
+           (node.parent != SCENE_NONE && node.parent >= i) || node.up > 1){
+            fail("invalid node");
+        }
+    }
+}
+
+} // namespace ngn
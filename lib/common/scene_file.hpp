@@ -0,0 +1,125 @@
+#pragma once
+#include "mapped_file.hpp"
+#include "scene_graph.hpp"
+//std
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ngn
+{
+
+// no material or no parent
+constexpr uint32_t SCENE_NONE = std::numeric_limits<uint32_t>::max();
+
+// bytes of the string table, not null terminated
+struct SceneString
+{
+    uint32_t offset;
+    uint32_t size;
+};
+
+struct SceneMaterial
+{
+    SceneString name;
+    // GLSL::ShaderType
+    uint32_t shader;
+    // GLSL::PolygonMode
+    uint32_t polygonMode;
+    uint32_t firstTexture;
+    uint32_t textureCount;
+};
+
+struct SceneTexture
+{
+    SceneString path;
+    // GLSL::ShaderBinding of the sampler
+    uint32_t binding;
+};
+
+struct SceneNode
+{
+    SceneString name;
+    // empty for a group node
+    SceneString model;
+    // SCENE_NONE for a group node
+    uint32_t material;
+    // SCENE_NONE or a node listed before this one
+    uint32_t parent;
+    // Model::UP
+    uint32_t up;
+    float translation[3];
+    // degrees, X = pitch Y = yaw Z = roll
+    float rotation[3];
+    float scale[3];
+};
+
+/**
+ * @brief Scene content: materials with their textures and a hierarchy of nodes with models.
+ *        In memory it is one blob of fixed size records followed by a string table,
+ *        header | materials | textures | nodes | strings, in host byte order.
+ *        The binary file is that blob: it is mapped and only its bounds are checked,
+ *        O(objects) and no parsing. The json form is for authoring and compiles to the same blob
+ */
+class SceneFile
+{
+public:
+    SceneFile() = default;
+
+    /**
+     * @brief A .json file is compiled, any other file is mapped as binary
+     *
+     * @throw std::runtime_error on a missing file or invalid content
+     */
+    static SceneFile open(const std::string &path);
+    static SceneFile fromJson(std::string_view text);
+    static SceneFile fromBinary(std::vector<std::byte> blob);
+
+    // write the binary form, loaded back by open()
+    void save(const std::string &path) const;
+
+    std::span<const SceneMaterial> materials() const { return {materials_, data_ ? header().materialCount : 0}; }
+    std::span<const SceneTexture> textures() const { return {textures_, data_ ? header().textureCount : 0}; }
+    std::span<const SceneNode> nodes() const { return {nodes_, data_ ? header().nodeCount : 0}; }
+
+    std::span<const SceneTexture> textures(const SceneMaterial &material) const
+    {
+        return textures().subspan(material.firstTexture, material.textureCount);
+    }
+    std::string_view string(SceneString str) const { return {strings_ + str.offset, str.size}; }
+    static Transformations transform(const SceneNode &node);
+
+    // the whole blob, as written by save()
+    std::span<const std::byte> bytes() const { return {data_, size_}; }
+
+private:
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t materialCount;
+        uint32_t textureCount;
+        uint32_t nodeCount;
+        uint32_t stringBytes;
+    };
+
+    const Header& header() const { return *reinterpret_cast<const Header*>(data_); }
+    // point the record views into data_, after checking every count, index and string
+    void bind();
+
+    MappedFile mapped_{};
+    std::vector<std::byte> owned_{};
+    const std::byte *data_ = nullptr;
+    size_t size_ = 0;
+
+    const SceneMaterial *materials_ = nullptr;
+    const SceneTexture *textures_ = nullptr;
+    const SceneNode *nodes_ = nullptr;
+    const char *strings_ = nullptr;
+};
+
+} // namespace ngn
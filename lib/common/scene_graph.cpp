@@ -0,0 +1,165 @@
+#include "scene_graph.hpp"
+#include "simd_transform.hpp"
+//lib
+#include <glm/gtx/euler_angles.hpp>
+#include <glm/ext/matrix_transform.hpp>
+//std
+#include <cassert>
+
+namespace ngn
+{
+
+glm::mat4 SceneGraph::compose(const Transformations &tra)
+{
+    glm::mat4 rot = glm::yawPitchRoll(glm::radians(tra.R.y), glm::radians(tra.R.x), glm::radians(tra.R.z));
+    glm::mat4 trasl = glm::translate(glm::mat4(1.0f), tra.T);
+    glm::mat4 scale = glm::scale(glm::mat4(1.0f), tra.S);
+    return trasl * rot * scale;
+}
+
+NodeId SceneGraph::add(NodeId parent)
+{
+    assert(parent == NO_PARENT || (parent < size() && !(flags_[parent] & FREE)));
+
+    // a released slot keeps the parent before child order only if it comes after the parent
+    auto slot = free_.lower_bound(parent == NO_PARENT ? 0 : parent + 1);
+    if(slot != free_.end()){
+        NodeId node = *slot;
+        free_.erase(slot);
+        parents_[node] = parent;
+        for(size_t c = 0; c < CHANNELS; c++){
+            trs_[c][node] = c >= SX ? 1.0f : 0.0f;
+        }
+        locals_[node] = glm::mat4(1.0f);
+        worlds_[node] = glm::mat4(1.0f);
+        flags_[node] = DIRTY;
+        changed_[node] = 0;
+        return node;
+    }
+
+    NodeId node = static_cast<NodeId>(parents_.size());
+    parents_.push_back(parent);
+    for(size_t c = 0; c < CHANNELS; c++){
+        trs_[c].push_back(c >= SX ? 1.0f : 0.0f);
+    }
+    locals_.emplace_back(1.0f);
+    worlds_.emplace_back(1.0f);
+    flags_.push_back(DIRTY);
+    changed_.push_back(0);
+    return node;
+}
+
+NodeId SceneGraph::create(NodeId parent, const Transformations &tra)
+{
+    NodeId node = add(parent);
+    setTransform(node, tra);
+    return node;
+}
+
+NodeId SceneGraph::createFixed(NodeId parent, const glm::mat4 &local)
+{
+    NodeId node = add(parent);
+    locals_[node] = local;
+    flags_[node] |= FIXED;
+    return node;
+}
+
+void SceneGraph::release(NodeId node)
+{
+    assert(node < size() && !(flags_[node] & FREE));
+
+    flags_[node] = FREE;
+    changed_[node] = 0;
+    free_.insert(node);
+}
+
+bool SceneGraph::hasChildren(NodeId node) const
+{
+    // children come after their parent
+    for(size_t i = node + 1; i < parents_.size(); i++){
+        if(parents_[i] == node && !(flags_[i] & FREE)){
+            return true;
+        }
+    }
+    return false;
+}
+
+void SceneGraph::setTransform(NodeId node, const Transformations &tra)
+{
+    trs_[TX][node] = tra.T.x; trs_[TY][node] = tra.T.y; trs_[TZ][node] = tra.T.z;
+    trs_[RX][node] = tra.R.x; trs_[RY][node] = tra.R.y; trs_[RZ][node] = tra.R.z;
+    trs_[SX][node] = tra.S.x; trs_[SY][node] = tra.S.y; trs_[SZ][node] = tra.S.z;
+    flags_[node] |= DIRTY;
+}
+
+Transformations SceneGraph::getTransform(NodeId node) const
+{
+    Transformations tra{};
+    tra.T = {trs_[TX][node], trs_[TY][node], trs_[TZ][node]};
+    tra.R = {trs_[RX][node], trs_[RY][node], trs_[RZ][node]};
+    tra.S = {trs_[SX][node], trs_[SY][node], trs_[SZ][node]};
+    return tra;
+}
+
+void SceneGraph::composeLocals(size_t first, size_t count)
+{
+    const simd::TrsArrays trs{
+        trs_[TX].data() + first, trs_[TY].data() + first, trs_[TZ].data() + first,
+        trs_[RX].data() + first, trs_[RY].data() + first, trs_[RZ].data() + first,
+        trs_[SX].data() + first, trs_[SY].data() + first, trs_[SZ].data() + first,
+    };
+    simd::composeTRS(trs, &locals_[first], count);
+}
+
+size_t SceneGraph::update()
+{
+    size_t updated = 0;
+    const size_t count = parents_.size();
+
+    // local matrices: consecutive dirty nodes are composed as one batch
+    for(size_t i = 0; i < count; ){
+        if((flags_[i] & (DIRTY | FIXED | FREE)) != DIRTY){
+            i++;
+            continue;
+        }
+        size_t end = i + 1;
+        while(end < count && (flags_[end] & (DIRTY | FIXED | FREE)) == DIRTY){
+            end++;
+        }
+        composeLocals(i, end - i);
+        i = end;
+    }
+
+    // world matrices
+    for(size_t i = 0; i < count; i++){
+        if(flags_[i] & FREE){
+            continue;
+        }
+        const NodeId parent = parents_[i];
+        // parents come first: their changed flag is already set for this update
+        const bool recompute = (flags_[i] & DIRTY) || (parent != NO_PARENT && changed_[parent]);
+
+        if(recompute){
+            worlds_[i] = parent == NO_PARENT ? locals_[i] : simd::multiply(worlds_[parent], locals_[i]);
+            flags_[i] = static_cast<uint8_t>(flags_[i] & ~DIRTY);
+            updated++;
+        }
+        changed_[i] = recompute;
+    }
+    return updated;
+}
+
+void SceneGraph::clear()
+{
+    parents_.clear();
+    for(auto &channel : trs_){
+        channel.clear();
+    }
+    locals_.clear();
+    worlds_.clear();
+    flags_.clear();
+    changed_.clear();
+    free_.clear();
+}
+
+} // namespace ngn
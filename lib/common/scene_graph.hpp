@@ -0,0 +1,108 @@
+#pragma once
+
+//lib
+#include <glm/glm.hpp>
+//std
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <set>
+#include <vector>
+
+struct Transformations
+{
+    glm::vec3 T{};
+    glm::vec3 R{};
+    glm::vec3 S{1.0f};
+};
+
+namespace ngn
+{
+
+using NodeId = uint32_t;
+constexpr NodeId NO_PARENT = std::numeric_limits<NodeId>::max();
+
+/**
+ * @brief Transform hierarchy stored as structure of arrays.
+ *        A node is always created after its parent, so arrays are sorted parent before child
+ *        and update() computes every world matrix in one linear pass.
+ *        Only nodes whose transformations changed, and their subtrees, are recomputed,
+ *        runs of changed nodes go through the simd batch kernels
+ */
+class SceneGraph
+{
+public:
+    /**
+     * @brief Add a node driven by translation, rotation (degrees, X = pitch Y = yaw Z = roll) and scale
+     *
+     * @param parent an existing node or NO_PARENT
+     */
+    NodeId create(NodeId parent = NO_PARENT, const Transformations &tra = {});
+
+    /**
+     * @brief Add a node with a constant local matrix, e.g. the up axis correction of a model
+     */
+    NodeId createFixed(NodeId parent, const glm::mat4 &local);
+
+    /**
+     * @brief Give back a node, its slot is reused by a later create()
+     *        Children have to be released before or together with their parent
+     */
+    void release(NodeId node);
+
+    void setTransform(NodeId node, const Transformations &tra);
+    Transformations getTransform(NodeId node) const;
+
+    NodeId parent(NodeId node) const { return parents_[node]; }
+    // linear in the node count
+    bool hasChildren(NodeId node) const;
+    const glm::mat4& local(NodeId node) const { return locals_[node]; }
+    // valid after update()
+    const glm::mat4& world(NodeId node) const { return worlds_[node]; }
+    const std::vector<glm::mat4>& worlds() const { return worlds_; }
+
+    /**
+     * @brief Recompute local matrices of changed nodes and world matrices of their subtrees
+     *
+     * @return number of world matrices recomputed
+     */
+    size_t update();
+
+    // true if the world matrix of node changed in the last update()
+    bool changed(NodeId node) const { return changed_[node] != 0; }
+    size_t size() const { return parents_.size(); }
+    void clear();
+
+    // scalar reference of the batch kernel used by update()
+    static glm::mat4 compose(const Transformations &tra);
+
+private:
+    enum Flags : uint8_t {
+        DIRTY = 1 << 0,
+        FIXED = 1 << 1,
+        FREE  = 1 << 2,
+    };
+
+    // one array per component, the layout of simd::TrsArrays
+    enum Channel : size_t {
+        TX, TY, TZ,
+        RX, RY, RZ,
+        SX, SY, SZ,
+        CHANNELS
+    };
+
+    NodeId add(NodeId parent);
+    void composeLocals(size_t first, size_t count);
+
+    std::vector<NodeId> parents_{};
+    std::array<std::vector<float>, CHANNELS> trs_{};
+    std::vector<glm::mat4> locals_{};
+    std::vector<glm::mat4> worlds_{};
+    std::vector<uint8_t> flags_{};
+    std::vector<uint8_t> changed_{};
+    // released slots, ordered to find one after a given parent
+    std::set<NodeId> free_{};
+};
+
+} // namespace ngn
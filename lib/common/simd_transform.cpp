@@ -0,0 +1,524 @@
+#include "simd_transform.hpp"
+//std
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if defined(__AVX2__)
+    #define NGN_SIMD_AVX2 1
+    #define NGN_SIMD_X86 1
+    #include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define NGN_SIMD_SSE2 1
+    #define NGN_SIMD_X86 1
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    #define NGN_SIMD_NEON 1
+    #include <arm_neon.h>
+#endif
+
+namespace ngn::simd
+{
+
+namespace
+{
+// ---------------------------------------------------------------------------------------
+// wide vectors: one node per lane
+
+#if defined(NGN_SIMD_AVX2)
+
+using vf = __m256;
+using vi = __m256i;
+constexpr size_t LANES = 8;
+
+inline vf set1(float x) { return _mm256_set1_ps(x); }
+inline vf load(const float *p) { return _mm256_loadu_ps(p); }
+inline void store(float *p, vf v) { _mm256_storeu_ps(p, v); }
+inline vf add(vf a, vf b) { return _mm256_add_ps(a, b); }
+inline vf sub(vf a, vf b) { return _mm256_sub_ps(a, b); }
+inline vf mul(vf a, vf b) { return _mm256_mul_ps(a, b); }
+// a * b + c
+inline vf madd(vf a, vf b, vf c) {
+#if defined(__FMA__) || defined(_MSC_VER)
+    return _mm256_fmadd_ps(a, b, c);
+#else
+    return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+}
+// round to nearest
+inline vi toInt(vf a) { return _mm256_cvtps_epi32(a); }
+inline vf toFloat(vi a) { return _mm256_cvtepi32_ps(a); }
+inline vi iand(vi a, int m) { return _mm256_and_si256(a, _mm256_set1_epi32(m)); }
+inline vi iadd(vi a, int b) { return _mm256_add_epi32(a, _mm256_set1_epi32(b)); }
+inline vf maskEq(vi a, int b) { return _mm256_castsi256_ps(_mm256_cmpeq_epi32(a, _mm256_set1_epi32(b))); }
+// bit 1 of a moved to the sign bit
+inline vf signOf(vi a) { return _mm256_castsi256_ps(_mm256_slli_epi32(a, 30)); }
+inline vf xorf(vf a, vf b) { return _mm256_xor_ps(a, b); }
+// mask ? a : b
+inline vf select(vf mask, vf a, vf b) { return _mm256_blendv_ps(b, a, mask); }
+inline vf minf(vf a, vf b) { return _mm256_min_ps(a, b); }
+// one bit per lane, set if the lane is negative
+inline uint32_t signBits(vf a) { return static_cast<uint32_t>(_mm256_movemask_ps(a)); }
+
+#elif defined(NGN_SIMD_SSE2)
+
+using vf = __m128;
+using vi = __m128i;
+constexpr size_t LANES = 4;
+
+inline vf set1(float x) { return _mm_set1_ps(x); }
+inline vf load(const float *p) { return _mm_loadu_ps(p); }
+inline void store(float *p, vf v) { _mm_storeu_ps(p, v); }
+inline vf add(vf a, vf b) { return _mm_add_ps(a, b); }
+inline vf sub(vf a, vf b) { return _mm_sub_ps(a, b); }
+inline vf mul(vf a, vf b) { return _mm_mul_ps(a, b); }
+inline vf madd(vf a, vf b, vf c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+inline vi toInt(vf a) { return _mm_cvtps_epi32(a); }
+inline vf toFloat(vi a) { return _mm_cvtepi32_ps(a); }
+inline vi iand(vi a, int m) { return _mm_and_si128(a, _mm_set1_epi32(m)); }
+inline vi iadd(vi a, int b) { return _mm_add_epi32(a, _mm_set1_epi32(b)); }
+inline vf maskEq(vi a, int b) { return _mm_castsi128_ps(_mm_cmpeq_epi32(a, _mm_set1_epi32(b))); }
+inline vf signOf(vi a) { return _mm_castsi128_ps(_mm_slli_epi32(a, 30)); }
+inline vf xorf(vf a, vf b) { return _mm_xor_ps(a, b); }
+inline vf select(vf mask, vf a, vf b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+inline vf minf(vf a, vf b) { return _mm_min_ps(a, b); }
+inline uint32_t signBits(vf a) { return static_cast<uint32_t>(_mm_movemask_ps(a)); }
+
+#elif defined(NGN_SIMD_NEON)
+
+using vf = float32x4_t;
+using vi = int32x4_t;
+constexpr size_t LANES = 4;
+
+inline vf set1(float x) { return vdupq_n_f32(x); }
+inline vf load(const float *p) { return vld1q_f32(p); }
+inline void store(float *p, vf v) { vst1q_f32(p, v); }
+inline vf add(vf a, vf b) { return vaddq_f32(a, b); }
+inline vf sub(vf a, vf b) { return vsubq_f32(a, b); }
+inline vf mul(vf a, vf b) { return vmulq_f32(a, b); }
+inline vf madd(vf a, vf b, vf c) { return vfmaq_f32(c, a, b); }
+inline vi toInt(vf a) { return vcvtnq_s32_f32(a); }
+inline vf toFloat(vi a) { return vcvtq_f32_s32(a); }
+inline vi iand(vi a, int m) { return vandq_s32(a, vdupq_n_s32(m)); }
+inline vi iadd(vi a, int b) { return vaddq_s32(a, vdupq_n_s32(b)); }
+inline vf maskEq(vi a, int b) { return vreinterpretq_f32_u32(vceqq_s32(a, vdupq_n_s32(b))); }
+inline vf signOf(vi a) { return vreinterpretq_f32_s32(vshlq_n_s32(a, 30)); }
+inline vf xorf(vf a, vf b) {
+    return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b)));
+}
+inline vf select(vf mask, vf a, vf b) { return vbslq_f32(vreinterpretq_u32_f32(mask), a, b); }
+inline vf minf(vf a, vf b) { return vminq_f32(a, b); }
+inline uint32_t signBits(vf a) {
+    const int32_t shifts[4] = {0, 1, 2, 3};
+    return vaddvq_u32(vshlq_u32(vshrq_n_u32(vreinterpretq_u32_f32(a), 31), vld1q_s32(shifts)));
+}
+
+#else
+
+using vf = float;
+using vi = int32_t;
+constexpr size_t LANES = 1;
+
+inline vf set1(float x) { return x; }
+inline vf load(const float *p) { return *p; }
+inline void store(float *p, vf v) { *p = v; }
+inline vf add(vf a, vf b) { return a + b; }
+inline vf sub(vf a, vf b) { return a - b; }
+inline vf mul(vf a, vf b) { return a * b; }
+inline vf madd(vf a, vf b, vf c) { return a * b + c; }
+inline vi toInt(vf a) { return static_cast<int32_t>(std::nearbyint(a)); }
+inline vf toFloat(vi a) { return static_cast<float>(a); }
+inline vi iand(vi a, int m) { return a & m; }
+inline vi iadd(vi a, int b) { return a + b; }
+inline vf maskEq(vi a, int b) { return std::bit_cast<float>(a == b ? 0xFFFFFFFFu : 0u); }
+inline vf signOf(vi a) { return std::bit_cast<float>(static_cast<uint32_t>(a) << 30); }
+inline vf xorf(vf a, vf b) { return std::bit_cast<float>(std::bit_cast<uint32_t>(a) ^ std::bit_cast<uint32_t>(b)); }
+inline vf select(vf mask, vf a, vf b) { return std::bit_cast<uint32_t>(mask) ? a : b; }
+inline vf minf(vf a, vf b) { return std::min(a, b); }
+inline uint32_t signBits(vf a) { return std::bit_cast<uint32_t>(a) >> 31; }
+
+#endif
+
+constexpr float DEG2RAD = 0.017453292519943295f;
+
+/**
+ * @brief Sine and cosine of every lane
+ *        Cody-Waite reduction to [-pi/4, pi/4] then minimax polynomials, about 1e-7 absolute error
+ */
+inline void sincos(vf x, vf &s, vf &c)
+{
+    const vi qi = toInt(mul(x, set1(0.636619772367581f)));
+    const vf q  = toFloat(qi);
+
+    // x - q * pi/2 with pi/2 split in two floats
+    vf r = madd(q, set1(-1.5707963705062866f), x);
+    r = madd(q, set1(4.3711388286737929e-08f), r);
+    const vf r2 = mul(r, r);
+
+    vf sp = madd(r2, set1(-1.9515295891e-4f), set1(8.3321608736e-3f));
+    sp = madd(sp, r2, set1(-1.6666654611e-1f));
+    sp = madd(mul(sp, r2), r, r);
+
+    vf cp = madd(r2, set1(2.443315711809948e-5f), set1(-1.388731625493765e-3f));
+    cp = madd(cp, r2, set1(4.166664568298827e-2f));
+    cp = madd(mul(cp, r2), r2, madd(r2, set1(-0.5f), set1(1.0f)));
+
+    // quadrant: odd swaps sine and cosine, then the signs
+    const vf swap = maskEq(iand(qi, 1), 1);
+    s = xorf(select(swap, cp, sp), signOf(iand(qi, 2)));
+    c = xorf(select(swap, sp, cp), signOf(iand(iadd(qi, 1), 2)));
+}
+
+/**
+ * @brief Elements of LANES matrices, m[4 * column + row] as glm
+ */
+inline void composeBlock(const TrsArrays &t, size_t i, vf m[16])
+{
+    const vf toRad = set1(DEG2RAD);
+    const vf zero  = set1(0.0f);
+
+    vf sinY, cosY, sinP, cosP, sinR, cosR;
+    sincos(mul(load(t.ry + i), toRad), sinY, cosY);
+    sincos(mul(load(t.rx + i), toRad), sinP, cosP);
+    sincos(mul(load(t.rz + i), toRad), sinR, cosR);
+
+    const vf scaleX = load(t.sx + i);
+    const vf scaleY = load(t.sy + i);
+    const vf scaleZ = load(t.sz + i);
+
+    // glm::yawPitchRoll
+    const vf spsr = mul(sinP, sinR);
+    const vf spcr = mul(sinP, cosR);
+
+    const vf r00 = madd(sinY, spsr, mul(cosY, cosR));
+    const vf r01 = mul(sinR, cosP);
+    const vf r02 = sub(mul(cosY, spsr), mul(sinY, cosR));
+    const vf r10 = sub(mul(sinY, spcr), mul(cosY, sinR));
+    const vf r11 = mul(cosR, cosP);
+    const vf r12 = madd(cosY, spcr, mul(sinR, sinY));
+    const vf r20 = mul(sinY, cosP);
+    const vf r21 = sub(zero, sinP);
+    const vf r22 = mul(cosY, cosP);
+
+    // translate * rotate * scale
+    m[0]  = mul(r00, scaleX); m[1]  = mul(r01, scaleX); m[2]  = mul(r02, scaleX); m[3]  = zero;
+    m[4]  = mul(r10, scaleY); m[5]  = mul(r11, scaleY); m[6]  = mul(r12, scaleY); m[7]  = zero;
+    m[8]  = mul(r20, scaleZ); m[9]  = mul(r21, scaleZ); m[10] = mul(r22, scaleZ); m[11] = zero;
+    m[12] = load(t.tx + i);   m[13] = load(t.ty + i);   m[14] = load(t.tz + i);   m[15] = set1(1.0f);
+}
+
+/**
+ * @brief Scatter the first count lanes of m to count consecutive matrices
+ */
+inline void storeBlock(const vf m[16], glm::mat4 *out, size_t count)
+{
+#if defined(NGN_SIMD_X86)
+    if(count == LANES){
+        for(int c = 0; c < 4; c++){
+    #if defined(NGN_SIMD_AVX2)
+            for(int half = 0; half < 2; half++){
+                __m128 r0 = half ? _mm256_extractf128_ps(m[4 * c + 0], 1) : _mm256_castps256_ps128(m[4 * c + 0]);
+                __m128 r1 = half ? _mm256_extractf128_ps(m[4 * c + 1], 1) : _mm256_castps256_ps128(m[4 * c + 1]);
+                __m128 r2 = half ? _mm256_extractf128_ps(m[4 * c + 2], 1) : _mm256_castps256_ps128(m[4 * c + 2]);
+                __m128 r3 = half ? _mm256_extractf128_ps(m[4 * c + 3], 1) : _mm256_castps256_ps128(m[4 * c + 3]);
+                _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+                glm::mat4 *dst = out + 4 * half;
+                _mm_storeu_ps(&dst[0][c][0], r0);
+                _mm_storeu_ps(&dst[1][c][0], r1);
+                _mm_storeu_ps(&dst[2][c][0], r2);
+                _mm_storeu_ps(&dst[3][c][0], r3);
+            }
+    #else
+            __m128 r0 = m[4 * c + 0];
+            __m128 r1 = m[4 * c + 1];
+            __m128 r2 = m[4 * c + 2];
+            __m128 r3 = m[4 * c + 3];
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+            _mm_storeu_ps(&out[0][c][0], r0);
+            _mm_storeu_ps(&out[1][c][0], r1);
+            _mm_storeu_ps(&out[2][c][0], r2);
+            _mm_storeu_ps(&out[3][c][0], r3);
+    #endif
+        }
+        return;
+    }
+#endif
+
+    alignas(32) float lanes[16][LANES];
+    for(int k = 0; k < 16; k++){
+        store(lanes[k], m[k]);
+    }
+    for(size_t l = 0; l < count; l++){
+        float *dst = &out[l][0][0];
+        for(int k = 0; k < 16; k++){
+            dst[k] = lanes[k][l];
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------
+// 4 wide vectors: one matrix column per register
+
+#if defined(NGN_SIMD_X86) || defined(NGN_SIMD_NEON)
+
+#if defined(NGN_SIMD_X86)
+
+using v4 = __m128;
+
+inline v4 load4(const float *p) { return _mm_loadu_ps(p); }
+inline void store4(float *p, v4 v) { _mm_storeu_ps(p, v); }
+inline v4 set4(float x, float y, float z, float w) { return _mm_setr_ps(x, y, z, w); }
+inline v4 add4(v4 a, v4 b) { return _mm_add_ps(a, b); }
+inline v4 sub4(v4 a, v4 b) { return _mm_sub_ps(a, b); }
+inline v4 mul4(v4 a, v4 b) { return _mm_mul_ps(a, b); }
+inline v4 abs4(v4 a) { return _mm_and_ps(a, _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF))); }
+template<int N>
+inline v4 splat4(v4 a) { return _mm_shuffle_ps(a, a, _MM_SHUFFLE(N, N, N, N)); }
+
+#else
+
+using v4 = float32x4_t;
+
+inline v4 load4(const float *p) { return vld1q_f32(p); }
+inline void store4(float *p, v4 v) { vst1q_f32(p, v); }
+inline v4 set4(float x, float y, float z, float w) { const float v[4] = {x, y, z, w}; return vld1q_f32(v); }
+inline v4 add4(v4 a, v4 b) { return vaddq_f32(a, b); }
+inline v4 sub4(v4 a, v4 b) { return vsubq_f32(a, b); }
+inline v4 mul4(v4 a, v4 b) { return vmulq_f32(a, b); }
+inline v4 abs4(v4 a) { return vabsq_f32(a); }
+template<int N>
+inline v4 splat4(v4 a) { return vdupq_laneq_f32(a, N); }
+
+#endif
+
+// c0 * v.x + c1 * v.y + c2 * v.z + c3 * v.w
+inline v4 combine(v4 c0, v4 c1, v4 c2, v4 c3, v4 v)
+{
+    v4 r = mul4(c0, splat4<0>(v));
+    r = add4(r, mul4(c1, splat4<1>(v)));
+    r = add4(r, mul4(c2, splat4<2>(v)));
+    return add4(r, mul4(c3, splat4<3>(v)));
+}
+
+inline void multiplyColumns(const float *a, const float *b, float *out)
+{
+    const v4 a0 = load4(a);
+    const v4 a1 = load4(a + 4);
+    const v4 a2 = load4(a + 8);
+    const v4 a3 = load4(a + 12);
+
+    // every column is computed before the stores: out may alias b
+    const v4 r0 = combine(a0, a1, a2, a3, load4(b));
+    const v4 r1 = combine(a0, a1, a2, a3, load4(b + 4));
+    const v4 r2 = combine(a0, a1, a2, a3, load4(b + 8));
+    const v4 r3 = combine(a0, a1, a2, a3, load4(b + 12));
+
+    store4(out, r0);
+    store4(out + 4, r1);
+    store4(out + 8, r2);
+    store4(out + 12, r3);
+}
+
+inline Sphere transformSphere(const glm::mat4 &matrix, const Sphere &in)
+{
+    const float *m = &matrix[0][0];
+    const v4 c0 = load4(m);
+    const v4 c1 = load4(m + 4);
+    const v4 c2 = load4(m + 8);
+    const v4 c3 = load4(m + 12);
+
+    const v4 center = combine(c0, c1, c2, c3, set4(in.center.x, in.center.y, in.center.z, 1.0f));
+
+    // squared length of the basis vectors, w ignored
+    alignas(16) float len0[4], len1[4], len2[4];
+    store4(len0, mul4(c0, c0));
+    store4(len1, mul4(c1, c1));
+    store4(len2, mul4(c2, c2));
+    const float scale = std::max({len0[0] + len0[1] + len0[2],
+                                  len1[0] + len1[1] + len1[2],
+                                  len2[0] + len2[1] + len2[2]});
+
+    alignas(16) float c[4];
+    store4(c, center);
+    return Sphere{glm::vec3(c[0], c[1], c[2]), in.radius * std::sqrt(scale)};
+}
+
+inline Aabb transformAabb(const glm::mat4 &matrix, const Aabb &in)
+{
+    const float *m = &matrix[0][0];
+    const v4 c0 = load4(m);
+    const v4 c1 = load4(m + 4);
+    const v4 c2 = load4(m + 8);
+    const v4 c3 = load4(m + 12);
+
+    const glm::vec3 center = in.center();
+    const glm::vec3 extent = in.extent();
+
+    const v4 c = combine(c0, c1, c2, c3, set4(center.x, center.y, center.z, 1.0f));
+    const v4 e = combine(abs4(c0), abs4(c1), abs4(c2), set4(0.0f, 0.0f, 0.0f, 0.0f),
+                         set4(extent.x, extent.y, extent.z, 0.0f));
+
+    alignas(16) float lo[4], hi[4];
+    store4(lo, sub4(c, e));
+    store4(hi, add4(c, e));
+    return Aabb{glm::vec3(lo[0], lo[1], lo[2]), glm::vec3(hi[0], hi[1], hi[2])};
+}
+
+#else
+
+inline void multiplyColumns(const float *a, const float *b, float *out)
+{
+    glm::mat4 r = *reinterpret_cast<const glm::mat4*>(a) * *reinterpret_cast<const glm::mat4*>(b);
+    std::memcpy(out, &r[0][0], sizeof(glm::mat4));
+}
+
+inline Sphere transformSphere(const glm::mat4 &matrix, const Sphere &in)
+{
+    const glm::vec3 center = glm::vec3(matrix * glm::vec4(in.center, 1.0f));
+    const float scale = std::max({glm::dot(glm::vec3(matrix[0]), glm::vec3(matrix[0])),
+                                  glm::dot(glm::vec3(matrix[1]), glm::vec3(matrix[1])),
+                                  glm::dot(glm::vec3(matrix[2]), glm::vec3(matrix[2]))});
+    return Sphere{center, in.radius * std::sqrt(scale)};
+}
+
+inline Aabb transformAabb(const glm::mat4 &matrix, const Aabb &in)
+{
+    const glm::vec3 center = glm::vec3(matrix * glm::vec4(in.center(), 1.0f));
+    const glm::mat3 basis{matrix};
+    const glm::vec3 extent = glm::abs(basis[0]) * in.extent().x
+                           + glm::abs(basis[1]) * in.extent().y
+                           + glm::abs(basis[2]) * in.extent().z;
+    return Aabb{center - extent, center + extent};
+}
+
+#endif
+
+} // namespace
+
+const char* isa()
+{
+#if defined(NGN_SIMD_AVX2)
+    return "avx2";
+#elif defined(NGN_SIMD_SSE2)
+    return "sse2";
+#elif defined(NGN_SIMD_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+
+size_t lanes()
+{
+    return LANES;
+}
+
+void composeTRS(const TrsArrays &trs, glm::mat4 *out, size_t count)
+{
+    vf m[16];
+
+    size_t i = 0;
+    for(; i + LANES <= count; i += LANES){
+        composeBlock(trs, i, m);
+        storeBlock(m, out + i, LANES);
+    }
+
+    if(i < count){
+        // tail padded to a full block with identity transformations
+        const float *src[9] = {trs.tx, trs.ty, trs.tz, trs.rx, trs.ry, trs.rz, trs.sx, trs.sy, trs.sz};
+        alignas(32) float pad[9][LANES];
+        const size_t rest = count - i;
+        for(size_t c = 0; c < 9; c++){
+            for(size_t l = 0; l < LANES; l++){
+                pad[c][l] = l < rest ? src[c][i + l] : (c >= 6 ? 1.0f : 0.0f);
+            }
+        }
+        const TrsArrays tail{pad[0], pad[1], pad[2], pad[3], pad[4], pad[5], pad[6], pad[7], pad[8]};
+        composeBlock(tail, 0, m);
+        storeBlock(m, out + i, rest);
+    }
+}
+
+glm::mat4 multiply(const glm::mat4 &a, const glm::mat4 &b)
+{
+    glm::mat4 result;
+    multiplyColumns(&a[0][0], &b[0][0], &result[0][0]);
+    return result;
+}
+
+void multiply(const glm::mat4 *a, const glm::mat4 *b, glm::mat4 *out, size_t count)
+{
+    for(size_t i = 0; i < count; i++){
+        multiplyColumns(&a[i][0][0], &b[i][0][0], &out[i][0][0]);
+    }
+}
+
+void multiplyParents(const uint32_t *parents, const glm::mat4 *locals, glm::mat4 *worlds, size_t count)
+{
+    for(size_t i = 0; i < count; i++){
+        const uint32_t parent = parents[i];
+        if(parent == UINT32_MAX){
+            worlds[i] = locals[i];
+        }else{
+            multiplyColumns(&worlds[parent][0][0], &locals[i][0][0], &worlds[i][0][0]);
+        }
+    }
+}
+
+void transformSpheres(const glm::mat4 *matrices, const Sphere *in, Sphere *out, size_t count)
+{
+    for(size_t i = 0; i < count; i++){
+        out[i] = transformSphere(matrices[i], in[i]);
+    }
+}
+
+void transformAabbs(const glm::mat4 *matrices, const Aabb *in, Aabb *out, size_t count)
+{
+    for(size_t i = 0; i < count; i++){
+        out[i] = transformAabb(matrices[i], in[i]);
+    }
+}
+
+size_t cullSpheres(const glm::vec4 planes[6], const Sphere *spheres, uint8_t *visible, size_t count)
+{
+    vf px[6], py[6], pz[6], pw[6];
+    for(int p = 0; p < 6; p++){
+        px[p] = set1(planes[p].x);
+        py[p] = set1(planes[p].y);
+        pz[p] = set1(planes[p].z);
+        pw[p] = set1(planes[p].w);
+    }
+
+    size_t inside = 0;
+    alignas(32) float cx[LANES], cy[LANES], cz[LANES], r[LANES];
+    for(size_t i = 0; i < count; i += LANES){
+        // spheres are 16 bytes each, gathered to one component per register
+        const size_t block = std::min(LANES, count - i);
+        for(size_t l = 0; l < LANES; l++){
+            const Sphere &sphere = spheres[i + (l < block ? l : 0)];
+            cx[l] = sphere.center.x;
+            cy[l] = sphere.center.y;
+            cz[l] = sphere.center.z;
+            r[l]  = sphere.radius;
+        }
+        const vf x = load(cx), y = load(cy), z = load(cz), radius = load(r);
+
+        // smallest signed distance + radius over the planes, negative if outside any of them
+        vf nearest = set1(std::numeric_limits<float>::max());
+        for(int p = 0; p < 6; p++){
+            const vf distance = madd(px[p], x, madd(py[p], y, madd(pz[p], z, add(pw[p], radius))));
+            nearest = minf(nearest, distance);
+        }
+
+        const uint32_t outside = signBits(nearest);
+        for(size_t l = 0; l < block; l++){
+            visible[i + l] = static_cast<uint8_t>(((outside >> l) & 1u) ^ 1u);
+            inside += visible[i + l];
+        }
+    }
+    return inside;
+}
+
+} // namespace ngn::simd
@@ -0,0 +1,69 @@
+#pragma once
+#include "bounds.hpp"
+//lib
+#include <glm/glm.hpp>
+//std
+#include <cstddef>
+#include <cstdint>
+
+namespace ngn::simd
+{
+
+/**
+ * @brief Translation, rotation and scale of N nodes as structure of arrays
+ *        Rotations in degrees, X = pitch Y = yaw Z = roll, same convention of SceneGraph::compose
+ */
+struct TrsArrays
+{
+    const float *tx, *ty, *tz;
+    const float *rx, *ry, *rz;
+    const float *sx, *sy, *sz;
+};
+
+// instruction set selected at compile time: "avx2", "sse2", "neon" or "scalar"
+const char* isa();
+// nodes processed per iteration of composeTRS
+size_t lanes();
+
+/**
+ * @brief out[i] = translate * yawPitchRoll * scale for count nodes, one node per simd lane
+ */
+void composeTRS(const TrsArrays &trs, glm::mat4 *out, size_t count);
+
+glm::mat4 multiply(const glm::mat4 &a, const glm::mat4 &b);
+
+/**
+ * @brief out[i] = a[i] * b[i]
+ */
+void multiply(const glm::mat4 *a, const glm::mat4 *b, glm::mat4 *out, size_t count);
+
+/**
+ * @brief worlds[i] = worlds[parents[i]] * locals[i], or locals[i] for roots
+ *        Parents must come before their children, as in SceneGraph
+ */
+void multiplyParents(const uint32_t *parents, const glm::mat4 *locals, glm::mat4 *worlds, size_t count);
+
+/**
+ * @brief Bounding spheres to world space, the radius is scaled by the largest axis scale
+ *
+ * @param matrices one matrix per sphere
+ */
+void transformSpheres(const glm::mat4 *matrices, const Sphere *in, Sphere *out, size_t count);
+
+/**
+ * @brief Bounding boxes to world space, the result encloses the transformed box (Arvo)
+ *
+ * @param matrices one matrix per box
+ */
+void transformAabbs(const glm::mat4 *matrices, const Aabb *in, Aabb *out, size_t count);
+
+/**
+ * @brief Frustum test of bounding spheres, one sphere per simd lane
+ *
+ * @param planes normalized planes, a point p is inside when dot(plane.xyz, p) + plane.w >= 0
+ * @param visible set to 1 for the spheres intersecting the frustum, 0 otherwise
+ * @return number of visible spheres
+ */
+size_t cullSpheres(const glm::vec4 planes[6], const Sphere *spheres, uint8_t *visible, size_t count);
+
+} // namespace ngn::simd
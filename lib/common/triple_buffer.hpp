@@ -0,0 +1,63 @@
+#pragma once
+
+//std
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace ngn
+{
+
+/**
+ * @brief Lock free single producer / single consumer handoff of T
+ *        The writer fills writeBuffer() then publish(), the reader acquire() the latest published buffer.
+ *        Writer and reader never touch the same buffer, unread buffers are overwritten
+ *
+ * @tparam T
+ */
+template<typename T>
+class TripleBuffer
+{
+public:
+    TripleBuffer() = default;
+
+    TripleBuffer(const TripleBuffer &) = delete;
+    TripleBuffer &operator=(const TripleBuffer &) = delete;
+
+    // writer side
+    T& writeBuffer(){ return buffers_[write_]; }
+
+    void publish(){
+        write_ = middle_.exchange(static_cast<uint8_t>(write_ | FRESH), std::memory_order_acq_rel) & INDEX;
+    }
+
+    // reader side
+    /**
+     * @brief Swap the read buffer with the last published one
+     *
+     * @return true if a new buffer was published since the last acquire
+     */
+    bool acquire(){
+        if((middle_.load(std::memory_order_relaxed) & FRESH) == 0){
+            return false;
+        }
+        read_ = middle_.exchange(read_, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+
+    const T& readBuffer() const { return buffers_[read_]; }
+
+    // both sides, only while no other thread is using the buffers
+    std::array<T, 3>& buffers(){ return buffers_; }
+
+private:
+    static constexpr uint8_t INDEX = 0x3;
+    static constexpr uint8_t FRESH = 0x4;
+
+    std::array<T, 3> buffers_{};
+    uint8_t write_{0};
+    uint8_t read_{1};
+    std::atomic<uint8_t> middle_{2};
+};
+
+} // namespace ngn
@@ -0,0 +1,117 @@
+#pragma once
+
+//std
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace ngn
+{
+
+/**
+ * @brief Bounded Chase-Lev deque of pointers
+ *        The owner thread push() and pop() at the bottom (LIFO), any other thread steal() from the top (FIFO).
+ *        Memory orders follow "Correct and Efficient Work-Stealing for Weak Memory Models" (Le et al. 2013)
+ *
+ * @tparam T pointed type
+ * @tparam N capacity, power of two
+ */
+template<typename T, size_t N>
+class WorkStealingQueue
+{
+public:
+    static_assert(N > 0 && (N & (N - 1)) == 0, "WorkStealingQueue capacity must be a power of two");
+
+    WorkStealingQueue() = default;
+
+    WorkStealingQueue(const WorkStealingQueue &) = delete;
+    WorkStealingQueue &operator=(const WorkStealingQueue &) = delete;
+
+    // owner side
+    /**
+     * @brief Add an item at the bottom
+     *
+     * @return false if the queue is full, the item is not added
+     */
+    bool push(T *item){
+        int64_t b = bottom_.load(std::memory_order_relaxed);
+        int64_t t = top_.load(std::memory_order_acquire);
+        if(b - t >= static_cast<int64_t>(N)){
+            return false;
+        }
+        items_[b & MASK].store(item, std::memory_order_relaxed);
+        // publishes the item and the job it points to, pairs with the acquire of steal()
+        bottom_.store(b + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Take the last pushed item
+     *
+     * @return nullptr if the queue is empty or the last item has been stolen
+     */
+    T* pop(){
+        int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top_.load(std::memory_order_relaxed);
+
+        if(t > b){
+            // empty
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        T *item = items_[b & MASK].load(std::memory_order_relaxed);
+        if(t == b){
+            // last item, race against the thieves
+            if(!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)){
+                item = nullptr;
+            }
+            bottom_.store(b + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    // thief side
+    /**
+     * @brief Take the oldest item
+     *
+     * @return nullptr if the queue is empty or another thread won the race
+     */
+    T* steal(){
+        int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom_.load(std::memory_order_acquire);
+
+        if(t >= b){
+            return nullptr;
+        }
+
+        T *item = items_[t & MASK].load(std::memory_order_relaxed);
+        if(!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)){
+            return nullptr;
+        }
+        return item;
+    }
+
+    // approximate when other threads are working on the queue
+    size_t size() const {
+        int64_t b = bottom_.load(std::memory_order_relaxed);
+        int64_t t = top_.load(std::memory_order_relaxed);
+        return b > t ? static_cast<size_t>(b - t) : 0;
+    }
+    bool empty() const { return size() == 0; }
+    static constexpr size_t capacity() { return N; }
+
+private:
+    static constexpr int64_t MASK = static_cast<int64_t>(N - 1);
+
+    // top and bottom on separate cache lines: thieves only write top
+    alignas(64) std::atomic<int64_t> top_{0};
+    alignas(64) std::atomic<int64_t> bottom_{0};
+    alignas(64) std::array<std::atomic<T*>, N> items_{};
+};
+
+} // namespace ngn
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "GUI.h"
+//common lib
+#include <vertex.h>
+//lib
+#include <glm/glm.hpp>
+//std
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Immutable state of one frame, built by the main thread and consumed by the renderer.
+ *        Snapshots are recycled by a triple buffer, vectors keep their capacity between frames
+ */
+struct FrameSnapshot
+{
+    uint64_t frame{0};
+
+    // render camera, perspective projection in opengl convention
+    UniformBufferObject mvp{};
+    // final matrix of every renderable, same order of Engine::renderables_
+    std::vector<glm::mat4> transforms{};
+    // indices in renderables_ of the objects inside the view frustum, in ascending order
+    std::vector<uint32_t> visible{};
+
+    uint32_t width{0};
+    uint32_t height{0};
+    // the window has been resized since the previous snapshot
+    bool resized{false};
+
+    // ui draw lists recorded by the main thread
+    GUI::DrawDataCopy ui{};
+};
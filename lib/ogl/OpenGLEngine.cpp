@@ -1,6 +1,11 @@
 #include "OpenglVertexBuffer.hpp"
 #include "OpenglShader.hpp"
 #include "OpenglUbo.hpp"
+#include "OpenglRingBuffer.hpp"
+#include "OpenglGeometry.hpp"
+#include "OpenglState.hpp"
+#include "OpenglLoader.hpp"
+#include "OpenglRenderTarget.hpp"
 #include "OpenGLEngine.hpp"
 // common lib
 #include <model.hpp>
@@ -10,6 +15,8 @@
 #define GLFW_INCLUDE_NONE
 #include <GLFW/glfw3.h>
 // std
+#include <algorithm>
+#include <chrono>
 
 void APIENTRY glDebugOutput(GLenum source, GLenum type, unsigned int id, GLenum severity, 
                             GLsizei length, const char *message, const void *userParam);
@@ -19,6 +26,7 @@ namespace ogl
 OpenGLEngine::OpenGLEngine(EngineType type) : Engine(type)
 {    
     SPDLOG_DEBUG("constructor"); 
+    ngn::Profiler::setBackend("opengl");
     init();
 }
 
@@ -32,9 +40,24 @@ void OpenGLEngine::init()
 {
     initOpenglGlobalStates();
 
-    Shader::addBuilder(std::make_unique<OpenglShaderBuilder>());
-    RenderObject::addBuilder(std::make_unique<OpenglObjectBuilder>());
+    // gl_DrawID needs the extension, core only since opengl 4.6
+    multiDraw_ = GLEW_ARB_shader_draw_parameters;
+    spdlog::info("Opengl objects drawn with {}", multiDraw_ ? "multi draw indirect" : "one draw per object");
+
+    // programs and textures are built by the loader while the meshes upload and the first frames draw
+    loaderContext_ = window_->createSharedContext();
+    if(loaderContext_){
+        loader_ = std::make_unique<OpenglLoader>(loaderContext_);
+    }else{
+        spdlog::warn("Opengl shared context not available, programs are built before the first frame");
+    }
+
+    geometry_ = std::make_unique<OpenglGeometry>();
+    Shader::addBuilder(std::make_unique<OpenglShaderBuilder>(multiDraw_, loader_.get()));
+    RenderObject::addBuilder(std::make_unique<OpenglObjectBuilder>(*geometry_));
     
+    // startup cost of the programs, compare a cold run (empty cache/programs) with a warm one
+    shadersStart_ = std::chrono::steady_clock::now();
     Engine::init_shaders(); 
     Engine::init_fixed_shaders(); 
     Engine::init_renderables();
@@ -42,6 +65,13 @@ void OpenGLEngine::init()
 
     prepareUniformBuffers();
 
+    gpuTimer_ = std::make_unique<OpenglGpuTimer>();
+    // the window framebuffer is single sampled to receive the upscale, samples belong to the scene target
+    display_ = ngn::Display::get();
+    const auto [width, height] = window_->extents();
+    sceneTarget_ = std::make_unique<OpenglRenderTarget>(width, height, static_cast<GLsizei>(display_.samples));
+    applySwapInterval();
+
     if(ui_Overlay_){
         UIoverlay.windowPtr = window_->getWindowPtr();
         UIoverlay.init();
@@ -50,9 +80,19 @@ void OpenGLEngine::init()
 
 void OpenGLEngine::cleanup() 
 { 
-    if (uboDataDynamic_.model) {
-		delete uboDataDynamic_.model;
-	} 
+    // the queued programs are finished, the shaders are released later with the engine
+    loader_.reset();
+    window_->destroySharedContext(loaderContext_);
+    loaderContext_ = nullptr;
+
+    gpuTimer_.reset();
+    sceneTarget_.reset();
+    openglUbo_.dynamic.reset();
+
+    // the meshes give their ranges back to the geometry
+    Engine::renderables_.clear();
+    Engine::fixed_objects_.clear();
+    geometry_.reset();
 
     if(ui_Overlay_){
         UIoverlay.cleanup();
@@ -79,10 +119,11 @@ void OpenGLEngine::initOpenglGlobalStates()
 
     // configure global opengl state
     // -----------------------------
-    glEnable(GL_DEPTH_TEST);
+    OpenglState::invalidate();
+    OpenglState::setEnabled(GL_DEPTH_TEST, true);
 
     // using multisample
-    glEnable(GL_MULTISAMPLE);
+    OpenglState::setEnabled(GL_MULTISAMPLE, true);
 
     //check opengl internals
     GLint maxSamples{};
@@ -96,20 +137,15 @@ void OpenGLEngine::initOpenglGlobalStates()
     spdlog::info("Opengl maxSamples = {} samples = {}", maxSamples, samples);
     spdlog::info("Opengl GL_MAX_UNIFORM_BUFFER_BINDINGS = {} ", max_uniform_buffer_bindings);
     spdlog::info("Opengl GL_MAX_UNIFORM_BLOCK_SIZE = {} ", max_uniform_blocksize);
-
-    //enable vsync glfwSwapInterval(0)
-    glfwSwapInterval(0);
 }
 
 void OpenGLEngine::prepareUniformBuffers()
 {
-    size_t bufferSize = sizeof(glm::mat4);
-
-    uboDataDynamic_.model = new glm::mat4;
-    assert(uboDataDynamic_.model);
-
     openglUbo_.view = std::make_unique<OpenglUbo>(sizeof(UniformBufferObject), GLSL::ShaderBinding::UNIFORM_BUFFER, &uniformBuffer_);
-    openglUbo_.dynamic = std::make_unique<OpenglUbo>(bufferSize, GLSL::ShaderBinding::UNIFORM_BUFFER_DYNAMIC, uboDataDynamic_.model);
+    openglUbo_.dynamic = std::make_unique<OpenglRingBuffer>(renderables_.size() * sizeof(glm::mat4));
+    // per object ubo ranges start at aligned offsets, multi draw packs the matrices
+    const size_t alignment = openglUbo_.dynamic->alignment();
+    openglUbo_.dynamicAlignment = (sizeof(glm::mat4) + alignment - 1) / alignment * alignment;
 
     canvasUbo = std::make_unique<OpenglUbo>(sizeof(UniformBufferObject), GLSL::ShaderBinding::UNIFORM_BUFFER, nullptr);
 
@@ -117,7 +153,7 @@ void OpenGLEngine::prepareUniformBuffers()
 
 void OpenGLEngine::updateUbo()
 {
-    UniformBufferObject mvp = Engine::getMVP();
+    const UniformBufferObject &mvp = frame_->mvp;
 
     uniformBuffer_.view  = mvp.view;
     uniformBuffer_.proj  = mvp.proj;
@@ -128,8 +164,13 @@ void OpenGLEngine::updateUbo()
 
 void OpenGLEngine::resizeFrame() 
 {
-    auto [w, h] = window_->extents();
-    glViewport(0, 0, w, h);
+    glViewport(0, 0, frame_->width, frame_->height);
+    sceneTarget_->resize(frame_->width, frame_->height);
+}
+
+void OpenGLEngine::newUiFrame()
+{
+    UIoverlay.newFrame();
 }
 
 
@@ -137,20 +178,87 @@ void OpenGLEngine::draw()
 {
     begin_frame();
     
-        draw_fixed();
-        draw_objects();
-
-        if(ui_Overlay_){
-            UIoverlay.newFrame();
-            Engine::draw_UiOverlay();
-            UIoverlay.draw();
+        gpuTimer_->begin(ngn::GpuPass::FIXED);
+            draw_fixed();
+        gpuTimer_->end(ngn::GpuPass::FIXED);
+
+        gpuTimer_->begin(ngn::GpuPass::OBJECTS);
+            draw_objects();
+        gpuTimer_->end(ngn::GpuPass::OBJECTS);
+
+        gpuTimer_->begin(ngn::GpuPass::UPSCALE);
+            sceneTarget_->present(frame_->width, frame_->height);
+        gpuTimer_->end(ngn::GpuPass::UPSCALE);
+
+        if(ui_Overlay_ && frame_->ui.get()){
+            gpuTimer_->begin(ngn::GpuPass::UIOVERLAY);
+                UIoverlay.draw(frame_->ui.get());
+            gpuTimer_->end(ngn::GpuPass::UIOVERLAY);
+            // the ui backend sets its own state
+            OpenglState::invalidate();
         }
 
     end_frame();
 }
 
+void OpenGLEngine::checkShadersReady()
+{
+    for(auto *shaders : {&shaders_, &fixed_shaders_}){
+        for(auto &[name, shader] : *shaders){
+            if(!static_cast<OpenglShader&>(*shader).ready()){
+                return;
+            }
+        }
+    }
+    shadersReady_ = true;
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - shadersStart_;
+    const auto programs = static_cast<uint32_t>(shaders_.size() + fixed_shaders_.size());
+    spdlog::info("Opengl programs ready in {:.1f} ms, {} of {} from the binary cache",
+        elapsed.count(), OpenglShader::cacheHits(), programs);
+    ngn::Profiler::setProgramsReady(elapsed.count(), OpenglShader::cacheHits(), programs);
+}
+
+void OpenGLEngine::applyDisplay()
+{
+    const ngn::DisplayState display = ngn::Display::get();
+    if(display == display_){
+        return;
+    }
+    const bool samplesChanged = display.samples != display_.samples;
+    display_ = display;
+
+    // only the scene target is multisampled, the context is kept
+    if(samplesChanged){
+        sceneTarget_ = std::make_unique<OpenglRenderTarget>(frame_->width, frame_->height, static_cast<GLsizei>(display_.samples));
+    }
+    applySwapInterval();
+}
+
+void OpenGLEngine::applySwapInterval()
+{
+    // adaptive vsync: a late frame tears instead of waiting for the next vertical blank
+    const bool adaptive = display_.presentMode == ngn::PresentMode::FIFO_RELAXED
+        && (glfwExtensionSupported("WGL_EXT_swap_control_tear") || glfwExtensionSupported("GLX_EXT_swap_control_tear"));
+    const int interval = display_.vsync ? (adaptive ? -1 : 1) : 0;
+    glfwSwapInterval(interval);
+    spdlog::info("Opengl swap interval = {}", interval);
+}
+
 void OpenGLEngine::begin_frame()
 {
+    if(!shadersReady_){
+        checkShadersReady();
+    }
+    applyDisplay();
+
+    // read back old gpu timings
+    gpuTimer_->reset();
+
+    // the scene is drawn at the scale chosen from the latest gpu timings
+    ngn::Profiler::setRenderScale(resolution_.update(ngn::Profiler::getGpuFrameTime()));
+    const auto [width, height] = resolution_.scaled(frame_->width, frame_->height);
+    sceneTarget_->begin(width, height);
+
     // set the background color
     glClearColor( Engine::background.r,  Engine::background.g,  Engine::background.b,  Engine::background.a);
     glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );    
@@ -159,6 +267,7 @@ void OpenGLEngine::begin_frame()
 
 void OpenGLEngine::end_frame()
 {
+    openglUbo_.dynamic->endFrame();
     window_->swapBuffers();  
 }
 
@@ -169,7 +278,8 @@ void OpenGLEngine::draw_fixed()
     OpenglShader &shader                = dynamic_cast<OpenglShader&>(Engine::getShader(fixed_shaders_, ro.shader));
     OpenglVertexBuffer &vertexbuffer    = dynamic_cast<OpenglVertexBuffer&>(ro);
 
-    auto [x, y] = window_->extents();
+    const float x = static_cast<float>(frame_->width);
+    const float y = static_cast<float>(frame_->height);
 
     // set new world origin to bottom left + offset
     const float offset = 50; 
@@ -179,10 +289,13 @@ void OpenGLEngine::draw_fixed()
     const float top    = y-offset;
 
     UniformBufferObject mvp{};
-    mvp.view = ourCamera.GetViewMatrix();
+    mvp.view = frame_->mvp.view;
     mvp.proj = glm::ortho(left, right, bottom, top, -100.0f, 100.0f);
     canvasUbo->bind(&mvp, sizeof(UniformBufferObject));
 
+    if(!shader.ready()){
+        return;
+    }
     shader.bind(GL_LINE);
     vertexbuffer.draw(shader.getTopology());
     
@@ -190,22 +303,118 @@ void OpenGLEngine::draw_fixed()
 
 void OpenGLEngine::draw_objects()
 {
-    uint32_t index = 0;
     updateUbo();
-    
-    for(  auto & ro : renderables_){
+    openglUbo_.view->bind();
 
-        OpenglShader &shader                = dynamic_cast<OpenglShader&>(Engine::getShader(shaders_, ro->shader));
-        OpenglVertexBuffer &vertexbuffer    = dynamic_cast<OpenglVertexBuffer&>(*ro);
+    if(multiDraw_){
+        draw_objects_indirect();
+        return;
+    }
+
+    // culled by the main thread, the matrices of the visible objects are packed in draw order
+    const std::vector<uint32_t> &visible = frame_->visible;
+    const size_t stride = openglUbo_.dynamicAlignment;
+    openglUbo_.dynamic->beginFrame(visible.size() * stride);
+    uint8_t *matrices = openglUbo_.dynamic->data();
+    for(size_t i = 0; i < visible.size(); i++){
+        *reinterpret_cast<glm::mat4*>(matrices + i * stride) = frame_->transforms[visible[i]];
+    }
 
-        *uboDataDynamic_.model = ro->objNode.getfinal();
-        index++;
+    const auto meshes = renderables_.column<MeshComponent>();
+    const auto materials = renderables_.column<MaterialComponent>();
+    for(size_t i = 0; i < visible.size(); i++){
+        OpenglShader &shader                = dynamic_cast<OpenglShader&>(*materials[visible[i]]);
+        OpenglVertexBuffer &vertexbuffer    = dynamic_cast<OpenglVertexBuffer&>(*meshes[visible[i]]);
+        if(!shader.ready()){
+            continue;
+        }
 
         shader.bind(GL_FILL);
-        openglUbo_.view->bind();
-        openglUbo_.dynamic->bind(uboDataDynamic_.model, sizeof(glm::mat4));
+        const GLintptr offset = openglUbo_.dynamic->offset() + static_cast<GLintptr>(i * stride);
+        OpenglState::bindBufferRange(GL_UNIFORM_BUFFER, GLSL::ShaderBinding::UNIFORM_BUFFER_DYNAMIC, openglUbo_.dynamic->buffer(), offset, sizeof(glm::mat4));
         vertexbuffer.draw(shader.getTopology());
+        ngn::Profiler::countTriangles(vertexbuffer.getIndexSize() / 3);
+    }
+}
+
+void OpenGLEngine::draw_objects_indirect()
+{
+    struct DrawElementsIndirectCommand {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint firstIndex;
+        GLint  baseVertex;
+        GLuint baseInstance;
+    };
+
+    const std::vector<uint32_t> &visible = frame_->visible;
+    const auto meshes = renderables_.column<MeshComponent>();
+    const auto materials = renderables_.column<MaterialComponent>();
+
+    // gl_DrawID restarts at every multi draw: one batch per program
+    for(auto &batch : batches_){
+        batch.objects.clear();
+    }
+    for(uint32_t index : visible){
+        OpenglShader *shader = static_cast<OpenglShader*>(materials[index]);
+        auto batch = std::find_if(batches_.begin(), batches_.end(), [&](const DrawBatch &b){ return b.shader == shader; });
+        if(batch == batches_.end()){
+            batch = batches_.insert(batches_.end(), DrawBatch{shader, {}});
+        }
+        batch->objects.push_back(index);
+    }
+
+    // region: the commands of every batch, then the matrices of every batch at a storage buffer offset
+    const size_t alignment = openglUbo_.dynamic->alignment();
+    auto align = [&](size_t bytes){ return (bytes + alignment - 1) / alignment * alignment; };
+    size_t bytes = visible.size() * sizeof(DrawElementsIndirectCommand);
+    for(const auto &batch : batches_){
+        bytes = align(bytes) + batch.objects.size() * sizeof(glm::mat4);
+    }
+    openglUbo_.dynamic->beginFrame(bytes);
+    uint8_t *region = openglUbo_.dynamic->data();
+
+    auto *commands = reinterpret_cast<DrawElementsIndirectCommand*>(region);
+    size_t matricesAt = visible.size() * sizeof(DrawElementsIndirectCommand);
+    uint64_t triangles = 0;
+
+    OpenglState::bindBuffer(GL_DRAW_INDIRECT_BUFFER, openglUbo_.dynamic->buffer());
+    geometry_->bind();
+    for(const auto &batch : batches_){
+        // programs still on the loader: their objects appear in a later frame
+        if(batch.objects.empty() || !batch.shader->ready()){
+            continue;
+        }
+        const size_t firstCommand = static_cast<size_t>(commands - reinterpret_cast<DrawElementsIndirectCommand*>(region));
+        matricesAt = align(matricesAt);
+        auto *matrices = reinterpret_cast<glm::mat4*>(region + matricesAt);
+        GLsizei drawCount = 0;
+        for(uint32_t index : batch.objects){
+            const auto &mesh = static_cast<OpenglVertexBuffer&>(*meshes[index]).getMesh();
+            // matrices follow the commands: an empty mesh gets neither
+            if(mesh.empty()){
+                continue;
+            }
+            *commands++ = {mesh.indexCount, 1, mesh.firstIndex, static_cast<GLint>(mesh.baseVertex), 0};
+            *matrices++ = frame_->transforms[index];
+            triangles += mesh.indexCount / 3;
+            drawCount++;
+        }
+        if(drawCount == 0){
+            continue;
+        }
+
+        const GLintptr base = openglUbo_.dynamic->offset();
+        batch.shader->bind(GL_FILL);
+        OpenglState::bindBufferRange(GL_SHADER_STORAGE_BUFFER, GLSL::ShaderBinding::STORAGE_BUFFER, openglUbo_.dynamic->buffer(),
+                          base + static_cast<GLintptr>(matricesAt), drawCount * sizeof(glm::mat4));
+        const void *indirect = reinterpret_cast<const void*>(base + static_cast<GLintptr>(firstCommand * sizeof(DrawElementsIndirectCommand)));
+        glMultiDrawElementsIndirect(batch.shader->getTopology(), GL_UNSIGNED_INT, indirect, drawCount, 0);
+        ngn::Profiler::countDraw();
+
+        matricesAt += static_cast<size_t>(drawCount) * sizeof(glm::mat4);
     }
+    ngn::Profiler::countTriangles(triangles);
 }
 
-}//namespace ogl
\ No newline at end of file
+}//namespace ogl
@@ -2,18 +2,28 @@
 
 #include "..\Engine.hpp"
 #include "OpenglUIOverlay.h"
+#include "OpenglGpuTimer.hpp"
 // common
 #include <baseclass.hpp>
+#include <display_settings.hpp>
+// std
+#include <chrono>
 
 
 class OpenglShader;
 class OpenglUbo;
 class OpenglVertexBuffer;
 class Window;
+struct GLFWwindow;
 
 
 namespace ogl
 {
+class OpenglGeometry;
+class OpenglRingBuffer;
+class OpenglLoader;
+class OpenglRenderTarget;
+
 class OpenGLEngine : public Engine
 {    
 public:
@@ -23,28 +33,60 @@ public:
 protected:
     void draw() override;
     void resizeFrame() override;
+    void newUiFrame() override;
 private:
 
     void initOpenglGlobalStates();
     void prepareUniformBuffers();
     void updateUbo();
     void init();
+    // log the startup time once every program is ready
+    void checkShadersReady();
+    // samples and swap interval changed by the command line or the ui
+    void applyDisplay();
+    void applySwapInterval();
     void begin_frame();
     void draw_fixed();
     void draw_objects();
+    // one multi draw indirect per program, per-draw data read at gl_DrawID
+    void draw_objects_indirect();
     void end_frame();
     void cleanup();
 
+    // multisampled scene target of the scaled resolution, the ui draws over the upscaled image
+    std::unique_ptr<OpenglRenderTarget> sceneTarget_;
+    // settings the scene target and the swap interval were created with
+    ngn::DisplayState display_{};
     OpenglUIOverlay UIoverlay{};
+    std::unique_ptr<OpenglGpuTimer> gpuTimer_;
 
     struct {
         std::unique_ptr<OpenglUbo> view;
-        std::unique_ptr<OpenglUbo> dynamic;
+        // model matrices of the visible objects written once per frame, with the draw commands in multi draw
+        std::unique_ptr<OpenglRingBuffer> dynamic;
         size_t dynamicAlignment;
     }openglUbo_;
 
+    // vertices and indices of every mesh, created before the object builder and released after the objects
+    std::unique_ptr<OpenglGeometry> geometry_;
+    // GL_ARB_shader_draw_parameters is available, objects go through draw_objects_indirect()
+    bool multiDraw_ = false;
+
+    // visible objects of one program, scratch of draw_objects_indirect()
+    struct DrawBatch {
+        OpenglShader *shader = nullptr;
+        std::vector<uint32_t> objects{};
+    };
+    std::vector<DrawBatch> batches_{};
+
     std::unique_ptr<OpenglUbo> canvasUbo;
 
+    // hidden window of the loader context, null when no shared context could be created
+    GLFWwindow *loaderContext_ = nullptr;
+    std::unique_ptr<OpenglLoader> loader_;
+    std::chrono::steady_clock::time_point shadersStart_{};
+    bool shadersReady_ = false;
+
 };
 }//namespace ogl
 
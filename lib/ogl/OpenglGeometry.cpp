@@ -0,0 +1,126 @@
+#include "OpenglGeometry.hpp"
+#include "OpenglVertexBuffer.hpp"
+#include "OpenglState.hpp"
+// common
+#include <model.hpp>
+//libs
+#include <spdlog/spdlog.h>
+//std
+#include <algorithm>
+
+namespace ogl
+{
+namespace
+{
+    // first allocation, in vertices and in indices
+    constexpr uint32_t INITIAL_CAPACITY = 1u << 16;
+}
+
+OpenglGeometry::OpenglGeometry()
+{
+    SPDLOG_DEBUG("constructor");
+
+    glCreateVertexArrays(1, &VAO);
+    setVertexAttribPointer();
+    growVertices(INITIAL_CAPACITY);
+    growIndices(INITIAL_CAPACITY);
+}
+
+OpenglGeometry::~OpenglGeometry()
+{
+    SPDLOG_DEBUG("destructor");
+
+    OpenglState::forgetVertexArray(VAO);
+    OpenglState::forgetBuffer(VBO);
+    OpenglState::forgetBuffer(IBO);
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteBuffers(1, &IBO);
+}
+
+OpenglGeometry::Mesh OpenglGeometry::add(const Model &model)
+{
+    // allocate() has no range for 0 elements
+    if(model.verticesSize() == 0 || model.indicesSize() == 0){
+        return Mesh{};
+    }
+
+    Mesh mesh{};
+    mesh.vertexCount = static_cast<uint32_t>(model.verticesSize());
+    mesh.indexCount = static_cast<uint32_t>(model.indicesSize());
+
+    mesh.baseVertex = vertices_.allocate(mesh.vertexCount);
+    if(mesh.baseVertex == ngn::RangeAllocator::NO_RANGE){
+        growVertices(std::max(vertices_.capacity() * 2, vertices_.capacity() + mesh.vertexCount));
+        mesh.baseVertex = vertices_.allocate(mesh.vertexCount);
+    }
+    mesh.firstIndex = indices_.allocate(mesh.indexCount);
+    if(mesh.firstIndex == ngn::RangeAllocator::NO_RANGE){
+        growIndices(std::max(indices_.capacity() * 2, indices_.capacity() + mesh.indexCount));
+        mesh.firstIndex = indices_.allocate(mesh.indexCount);
+    }
+
+    // indices stay relative to the mesh, the base vertex is added by the draw
+    glNamedBufferSubData(VBO, static_cast<GLintptr>(mesh.baseVertex) * sizeof(Vertex), mesh.vertexCount * sizeof(Vertex), model.verticesData());
+    glNamedBufferSubData(IBO, static_cast<GLintptr>(mesh.firstIndex) * sizeof(Index), mesh.indexCount * sizeof(Index), model.indicesData());
+    return mesh;
+}
+
+void OpenglGeometry::remove(const Mesh &mesh)
+{
+    // the draws already queued read the old content, the next add() is ordered after them
+    vertices_.free(mesh.baseVertex, mesh.vertexCount);
+    indices_.free(mesh.firstIndex, mesh.indexCount);
+}
+
+void OpenglGeometry::bind()
+{
+    OpenglState::bindVertexArray(VAO);
+}
+
+GLuint OpenglGeometry::resize(GLuint buffer, size_t oldBytes, size_t newBytes)
+{
+    GLuint resized{};
+    glCreateBuffers(1, &resized);
+    glNamedBufferStorage(resized, static_cast<GLsizeiptr>(newBytes), nullptr, GL_DYNAMIC_STORAGE_BIT);
+    if(buffer){
+        glCopyNamedBufferSubData(buffer, resized, 0, 0, static_cast<GLsizeiptr>(oldBytes));
+        OpenglState::forgetBuffer(buffer);
+        glDeleteBuffers(1, &buffer);
+    }
+    return resized;
+}
+
+void OpenglGeometry::growVertices(uint32_t capacity)
+{
+    VBO = resize(VBO, vertices_.capacity() * sizeof(Vertex), capacity * sizeof(Vertex));
+    glVertexArrayVertexBuffer(VAO, bindingIndex, VBO, 0, sizeof(Vertex));
+    vertices_.grow(capacity);
+    SPDLOG_DEBUG("geometry vertices {}", capacity);
+}
+
+void OpenglGeometry::growIndices(uint32_t capacity)
+{
+    IBO = resize(IBO, indices_.capacity() * sizeof(Index), capacity * sizeof(Index));
+    glVertexArrayElementBuffer(VAO, IBO);
+    indices_.grow(capacity);
+    SPDLOG_DEBUG("geometry indices {}", capacity);
+}
+
+void OpenglGeometry::setVertexAttribPointer(){
+    auto attributes =  OpenglVertexBuffer::getAttributeDescriptions();
+    for( const auto & attribute : attributes){
+        glEnableVertexArrayAttrib(VAO, attribute.location);
+        glVertexArrayAttribFormat(
+            VAO,
+            attribute.location,
+            attribute.size,
+            attribute.type,
+            attribute.normalized,
+            attribute.reloffset
+        );
+        glVertexArrayAttribBinding(VAO, attribute.location, bindingIndex);
+    }
+}
+
+}//namespace ogl
@@ -0,0 +1,58 @@
+#pragma once
+// common
+#include <range_allocator.hpp>
+#include <vertex.h>
+// lib
+#include <GL/glew.h>
+// std
+#include <cstdint>
+
+class Model;
+
+namespace ogl
+{
+/**
+ * @brief Vertices and indices of every mesh in one vbo and one ibo behind one vao.
+ *        Meshes are sub-allocated ranges drawn with a base vertex, so any number of them
+ *        can go in a single multi draw. The buffers double when full, ranges keep their offsets
+ */
+class OpenglGeometry
+{
+public:
+    // ranges of a mesh, in vertices and indices
+    struct Mesh
+    {
+        uint32_t baseVertex{ngn::RangeAllocator::NO_RANGE};
+        uint32_t vertexCount{0};
+        uint32_t firstIndex{ngn::RangeAllocator::NO_RANGE};
+        uint32_t indexCount{0};
+
+        // nothing to draw, owns no range
+        bool empty() const { return indexCount == 0; }
+    };
+
+    OpenglGeometry();
+    ~OpenglGeometry();
+
+    OpenglGeometry(const OpenglGeometry &) = delete;
+    void operator=(const OpenglGeometry &) = delete;
+
+    // an empty mesh for a model without vertices or indices
+    Mesh add(const Model &model);
+    void remove(const Mesh &mesh);
+    void bind();
+
+private:
+    // copy the used buffer into one of capacity elements
+    void growVertices(uint32_t capacity);
+    void growIndices(uint32_t capacity);
+    static GLuint resize(GLuint buffer, size_t oldBytes, size_t newBytes);
+    void setVertexAttribPointer();
+
+    const GLuint bindingIndex = 0;
+    GLuint VAO{0}, VBO{0}, IBO{0};
+    ngn::RangeAllocator vertices_{};
+    ngn::RangeAllocator indices_{};
+};
+
+}//namespace ogl
@@ -0,0 +1,85 @@
+#include "OpenglGpuTimer.hpp"
+//libs
+#include <spdlog/spdlog.h>
+
+namespace ogl
+{
+OpenglGpuTimer::OpenglGpuTimer()
+{
+    SPDLOG_DEBUG("constructor");
+
+    for(auto &set : queries){
+        glCreateQueries(GL_TIME_ELAPSED, ngn::GPU_PASS_COUNT, set.time.data());
+        glCreateQueries(GL_PRIMITIVES_GENERATED, ngn::GPU_PASS_COUNT, set.primitives.data());
+    }
+}
+
+OpenglGpuTimer::~OpenglGpuTimer()
+{
+    SPDLOG_DEBUG("destructor");
+
+    for(auto &set : queries){
+        glDeleteQueries(ngn::GPU_PASS_COUNT, set.time.data());
+        glDeleteQueries(ngn::GPU_PASS_COUNT, set.primitives.data());
+    }
+}
+
+void OpenglGpuTimer::reset()
+{
+    currentFrame = (currentFrame + 1) % QUERY_FRAMES;
+
+    // the queries of this slot were issued QUERY_FRAMES ago: read them before reusing
+    readback(currentFrame);
+}
+
+void OpenglGpuTimer::begin(ngn::GpuPass pass)
+{
+    uint32_t index = static_cast<uint32_t>(pass);
+    auto &set = queries[currentFrame];
+
+    glBeginQuery(GL_TIME_ELAPSED, set.time[index]);
+    glBeginQuery(GL_PRIMITIVES_GENERATED, set.primitives[index]);
+}
+
+void OpenglGpuTimer::end(ngn::GpuPass pass)
+{
+    uint32_t index = static_cast<uint32_t>(pass);
+    auto &set = queries[currentFrame];
+
+    glEndQuery(GL_PRIMITIVES_GENERATED);
+    glEndQuery(GL_TIME_ELAPSED);
+    set.issued[index] = true;
+}
+
+void OpenglGpuTimer::readback(uint32_t frame)
+{
+    auto &set = queries[frame];
+
+    for(uint32_t i = 0; i < ngn::GPU_PASS_COUNT; i++){
+        if(!set.issued[i]){
+            continue;
+        }
+        set.issued[i] = false;
+
+        // never wait on the gpu, a late result is dropped
+        GLuint timeAvailable = GL_FALSE;
+        GLuint primitivesAvailable = GL_FALSE;
+        glGetQueryObjectuiv(set.time[i], GL_QUERY_RESULT_AVAILABLE, &timeAvailable);
+        glGetQueryObjectuiv(set.primitives[i], GL_QUERY_RESULT_AVAILABLE, &primitivesAvailable);
+        if(!timeAvailable || !primitivesAvailable){
+            continue;
+        }
+
+        GLuint64 elapsed{};
+        GLuint64 primitives{};
+        glGetQueryObjectui64v(set.time[i], GL_QUERY_RESULT, &elapsed);
+        glGetQueryObjectui64v(set.primitives[i], GL_QUERY_RESULT, &primitives);
+
+        ngn::GpuPassStats stats{};
+        stats.timeMs = static_cast<float>(elapsed / 1000000.0);
+        stats.primitives = primitives;
+        ngn::Profiler::setGpuPass(static_cast<ngn::GpuPass>(i), stats);
+    }
+}
+
+}//namespace ogl
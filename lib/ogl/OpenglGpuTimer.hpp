@@ -0,0 +1,43 @@
+#pragma once
+#include <GL/glew.h>
+//common lib
+#include <profiler.hpp>
+//std
+#include <array>
+
+namespace ogl
+{
+/**
+ * @brief Time elapsed and primitives generated queries around the engine render passes
+ *        Results are read back QUERY_FRAMES frames later, only when available to avoid stalls
+ */
+class OpenglGpuTimer
+{
+public:
+    OpenglGpuTimer();
+    ~OpenglGpuTimer();
+
+    OpenglGpuTimer(const OpenglGpuTimer &) = delete;
+    void operator=(const OpenglGpuTimer &) = delete;
+
+    // call once per frame before the first pass
+    void reset();
+    void begin(ngn::GpuPass pass);
+    void end(ngn::GpuPass pass);
+
+private:
+    void readback(uint32_t frame);
+
+    static constexpr uint32_t QUERY_FRAMES = 3;
+
+    struct QuerySet{
+        std::array<GLuint, ngn::GPU_PASS_COUNT> time{};
+        std::array<GLuint, ngn::GPU_PASS_COUNT> primitives{};
+        std::array<bool, ngn::GPU_PASS_COUNT> issued{};
+    };
+
+    std::array<QuerySet, QUERY_FRAMES> queries{};
+    uint32_t currentFrame{0};
+};
+
+}//namespace ogl
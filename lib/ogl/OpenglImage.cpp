@@ -1,13 +1,28 @@
 #include "OpenglImage.hpp"
+#include "OpenglState.hpp"
+#include "OpenglRingBuffer.hpp"
 // common lib
 #include "mytypes.hpp"
+#include <profiler.hpp>
 // stb lib    
 #include <stb_image.h>
 // std
+#include <algorithm>
+#include <cstring>
 #include <string>
 #include <iostream>
 
-OpenglImage::OpenglImage(const std::string  &filename/*  = "data/textures/viking_room.png" */)
+// full chain down to 1x1
+static GLsizei mipLevels(int width, int height)
+{
+    GLsizei levels = 1;
+    for(int size = std::max(width, height); size > 1; size /= 2){
+        levels++;
+    }
+    return levels;
+}
+
+OpenglImage::OpenglImage(const std::string  &filename/*  = "data/textures/viking_room.png" */, ogl::OpenglRingBuffer *staging /* = nullptr */)
 {
     SPDLOG_DEBUG("constructor"); 
 
@@ -38,28 +53,61 @@ OpenglImage::OpenglImage(const std::string  &filename/*  = "data/textures/viking
         internalformat = GL_RGBA8;
     }
 
+    const GLsizei levels = mipLevels(width, height);
     glCreateTextures(GL_TEXTURE_2D, num_of_textures, &textureID);
-    glTextureParameteri(textureID, GL_TEXTURE_MAX_LEVEL, 0);
-    glTextureParameteri(textureID, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTextureParameteri(textureID, GL_TEXTURE_MAX_LEVEL, levels - 1);
     glTextureParameteri(textureID, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTextureParameteri(textureID, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);  
-    glTextureStorage2D(textureID, num_of_textures, internalformat, width, height);
-    glTextureSubImage2D(textureID, level_of_detail, xoffset, yoffset, width, height, format, GL_UNSIGNED_BYTE, pixels);
+    glTextureStorage2D(textureID, levels, internalformat, width, height);
+
+    // rows of 1 and 3 components are tightly packed
+    glPixelStorei(GL_UNPACK_ALIGNMENT, alignement);
+    if(staging){
+        uploadStaged(*staging, pixels, width, height, nrComponents, format);
+    }else{
+        glTextureSubImage2D(textureID, level_of_detail, xoffset, yoffset, width, height, format, GL_UNSIGNED_BYTE, pixels);
+    }
     glGenerateTextureMipmap(textureID);
 
+    // the chain adds a third of the base level
+    residentBytes = static_cast<size_t>(width) * height * nrComponents * 4 / 3;
+    ngn::Profiler::addTextureBytes(static_cast<int64_t>(residentBytes));
+
     // free image
     stbi_image_free(pixels);
 } 
 
+void OpenglImage::uploadStaged(ogl::OpenglRingBuffer &staging, const unsigned char *pixels, int width, int height,
+                               int components, GLenum format)
+{
+    const size_t rowBytes = static_cast<size_t>(width) * components;
+    const int bandRows = static_cast<int>(std::max<size_t>(staging.regionBytes() / rowBytes, 1));
+
+    for(int row = 0; row < height; row += bandRows){
+        const int rows = std::min(bandRows, height - row);
+        // waits only when the band RING_FRAMES uploads ago is still being read
+        staging.beginFrame(rows * rowBytes);
+        std::memcpy(staging.data(), pixels + row * rowBytes, rows * rowBytes);
+
+        // a band larger than a region reallocates the buffer: bind every band
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, staging.buffer());
+        glTextureSubImage2D(textureID, 0, 0, row, width, rows, format, GL_UNSIGNED_BYTE,
+                            reinterpret_cast<const void*>(staging.offset()));
+        staging.endFrame();
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
 OpenglImage::~OpenglImage()
 {   
     SPDLOG_DEBUG("destructor");
+    ogl::OpenglState::forgetTexture(textureID);
     glDeleteTextures( num_of_textures, &textureID );
+    ngn::Profiler::addTextureBytes(-static_cast<int64_t>(residentBytes));
 }
 
-void OpenglImage::bind(){
-    const GLuint  binding = 1;
-    glBindTextureUnit(binding, textureID);
+void OpenglImage::bind(GLuint binding){
+    ogl::OpenglState::bindTextureUnit(binding, textureID);
 }
 
 
@@ -5,18 +5,30 @@
 //std
 #include <string>
 
+namespace ogl
+{
+class OpenglRingBuffer;
+}
+
 class OpenglImage
 {
 public:
-    OpenglImage(const std::string  &filename = "data/textures/viking_room.png");
+    /**
+     * @param staging pixel unpack ring: the image is copied to it in bands of rows and each band
+     *        uploaded from the buffer with a fence, without it the upload reads client memory
+     */
+    OpenglImage(const std::string  &filename = "data/textures/viking_room.png", ogl::OpenglRingBuffer *staging = nullptr);
     ~OpenglImage();
 
-    void bind();
+    void bind(GLuint binding);
 private:
+    void uploadStaged(ogl::OpenglRingBuffer &staging, const unsigned char *pixels, int width, int height,
+                      int components, GLenum format);
+
     GLuint textureID;
+    size_t residentBytes{0};
 
     const int num_of_textures = 1;
     
 };    
 
-
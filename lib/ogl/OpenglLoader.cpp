@@ -0,0 +1,168 @@
+#include "OpenglLoader.hpp"
+#include "OpenglRingBuffer.hpp"
+//libs
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+#include <spdlog/spdlog.h>
+//std
+#include <utility>
+
+namespace ogl
+{
+namespace
+{
+    // texture rows copied per upload, a larger image streams through the regions in bands
+    constexpr size_t STAGING_BYTES = 4u << 20;
+}
+
+OpenglLoader::Pending::~Pending()
+{
+    release();
+}
+
+OpenglLoader::Pending::Pending(Pending &&other) noexcept
+    : task_{std::move(other.task_)}, fence_{std::exchange(other.fence_, nullptr)}, done_{std::exchange(other.done_, true)}
+{
+}
+
+OpenglLoader::Pending& OpenglLoader::Pending::operator=(Pending &&other) noexcept
+{
+    if(this != &other){
+        release();
+        task_ = std::move(other.task_);
+        fence_ = std::exchange(other.fence_, nullptr);
+        done_ = std::exchange(other.done_, true);
+    }
+    return *this;
+}
+
+void OpenglLoader::Pending::release() noexcept
+{
+    if(done_){
+        return;
+    }
+    // the task may still write to the objects of its owner
+    if(task_.valid()){
+        task_.wait();
+        try{
+            fence_ = task_.get();
+        }catch(...){
+            fence_ = nullptr;
+        }
+    }
+    if(fence_){
+        glDeleteSync(fence_);
+        fence_ = nullptr;
+    }
+    done_ = true;
+}
+
+void OpenglLoader::Pending::take()
+{
+    try{
+        fence_ = task_.get();
+    }catch(...){
+        // nothing left to wait for
+        done_ = true;
+        throw;
+    }
+}
+
+bool OpenglLoader::Pending::ready()
+{
+    if(done_){
+        return true;
+    }
+    if(task_.valid()){
+        if(task_.wait_for(std::chrono::seconds(0)) != std::future_status::ready){
+            return false;
+        }
+        take();
+    }
+    // the task ran, its commands may still be executing
+    if(glClientWaitSync(fence_, 0, 0) == GL_TIMEOUT_EXPIRED){
+        return false;
+    }
+    glDeleteSync(fence_);
+    fence_ = nullptr;
+    done_ = true;
+    return true;
+}
+
+void OpenglLoader::Pending::wait()
+{
+    if(done_){
+        return;
+    }
+    if(task_.valid()){
+        take();
+    }
+    // the loader flushed after the fence, no flush of this context needed
+    while(glClientWaitSync(fence_, 0, 1000000) == GL_TIMEOUT_EXPIRED){
+    }
+    glDeleteSync(fence_);
+    fence_ = nullptr;
+    done_ = true;
+}
+
+OpenglLoader::OpenglLoader(GLFWwindow *context) : context_{context}
+{
+    SPDLOG_DEBUG("constructor");
+    staging_ = std::make_unique<OpenglRingBuffer>(STAGING_BYTES);
+    thread_ = std::thread([this]{ loop(); });
+}
+
+OpenglLoader::~OpenglLoader()
+{
+    SPDLOG_DEBUG("destructor");
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_one();
+    thread_.join();
+    staging_.reset();
+}
+
+OpenglLoader::Pending OpenglLoader::submit(std::function<void()> task)
+{
+    Task queued{std::move(task), {}};
+    Pending pending{queued.fence.get_future()};
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(std::move(queued));
+    }
+    wake_.notify_one();
+    return pending;
+}
+
+void OpenglLoader::loop()
+{
+    glfwMakeContextCurrent(context_);
+
+    while(true){
+        Task task{};
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this]{ return stop_ || !tasks_.empty(); });
+            if(tasks_.empty()){
+                break;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        try{
+            task.run();
+            GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            // a fence waited on by another context must reach the gpu
+            glFlush();
+            task.fence.set_value(fence);
+        }catch(...){
+            task.fence.set_exception(std::current_exception());
+        }
+    }
+
+    glfwMakeContextCurrent(nullptr);
+}
+
+}//namespace ogl
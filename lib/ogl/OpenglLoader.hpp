@@ -0,0 +1,89 @@
+#pragma once
+// lib
+#include <GL/glew.h>
+// std
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+struct GLFWwindow;
+
+namespace ogl
+{
+class OpenglRingBuffer;
+
+/**
+ * @brief Thread owning a second context of the share group, it compiles and uploads while the
+ *        drawing context records frames. Every task ends with a fence: its objects may be used by the
+ *        drawing context once the fence is signaled. Tasks must not go through OpenglState,
+ *        the cache shadows the drawing context only
+ */
+class OpenglLoader
+{
+public:
+    // work of one task, checked from the drawing context
+    class Pending
+    {
+    public:
+        Pending() = default;
+        explicit Pending(std::future<GLsync> task) : task_{std::move(task)}, done_{false} {}
+        ~Pending();
+
+        Pending(Pending &&other) noexcept;
+        Pending &operator=(Pending &&other) noexcept;
+
+        // without blocking, rethrows the error of the task
+        bool ready();
+        // block until the objects can be used
+        void wait();
+
+    private:
+        void release() noexcept;
+        // fence of the finished task, or its error
+        void take();
+
+        std::future<GLsync> task_{};
+        // set by the task, signaled when its commands completed
+        GLsync fence_ = nullptr;
+        bool done_ = true;
+    };
+
+    /**
+     * @param context hidden window sharing the drawing context, made current on the loader thread
+     */
+    explicit OpenglLoader(GLFWwindow *context);
+    // runs the queued tasks, then joins
+    ~OpenglLoader();
+
+    OpenglLoader(const OpenglLoader &) = delete;
+    OpenglLoader &operator=(const OpenglLoader &) = delete;
+
+    Pending submit(std::function<void()> task);
+
+    // pixel unpack staging of the tasks, one task at a time uses it
+    OpenglRingBuffer* staging() { return staging_.get(); }
+
+private:
+    void loop();
+
+    struct Task
+    {
+        std::function<void()> run;
+        std::promise<GLsync> fence;
+    };
+
+    GLFWwindow *context_ = nullptr;
+    // created and released by the drawing context, the loader only writes and fences it
+    std::unique_ptr<OpenglRingBuffer> staging_;
+    std::mutex mutex_{};
+    std::condition_variable wake_{};
+    std::deque<Task> tasks_{};
+    bool stop_ = false;
+    std::thread thread_{};
+};
+
+}//namespace ogl
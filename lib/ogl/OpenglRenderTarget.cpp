@@ -0,0 +1,117 @@
+#include "OpenglRenderTarget.hpp"
+#include "OpenglState.hpp"
+//libs
+#include <spdlog/spdlog.h>
+//std
+#include <algorithm>
+#include <stdexcept>
+
+namespace ogl
+{
+OpenglRenderTarget::OpenglRenderTarget(uint32_t width, uint32_t height, GLsizei samples)
+    : width_{std::max(width, 1u)}, height_{std::max(height, 1u)}
+{
+    SPDLOG_DEBUG("constructor");
+
+    GLint maxSamples{};
+    glGetIntegerv(GL_MAX_SAMPLES, &maxSamples);
+    samples_ = std::clamp(samples, 1, std::max(maxSamples, 1));
+    create();
+}
+
+OpenglRenderTarget::~OpenglRenderTarget()
+{
+    SPDLOG_DEBUG("destructor");
+    destroy();
+}
+
+void OpenglRenderTarget::resize(uint32_t width, uint32_t height)
+{
+    // minimized window
+    width = std::max(width, 1u);
+    height = std::max(height, 1u);
+    if(width == width_ && height == height_){
+        return;
+    }
+    destroy();
+    width_ = width;
+    height_ = height;
+    create();
+}
+
+void OpenglRenderTarget::create()
+{
+    const GLsizei width = static_cast<GLsizei>(width_);
+    const GLsizei height = static_cast<GLsizei>(height_);
+
+    glCreateRenderbuffers(1, &color_);
+    glCreateRenderbuffers(1, &depth_);
+    glNamedRenderbufferStorageMultisample(color_, samples_ > 1 ? samples_ : 0, GL_RGBA8, width, height);
+    glNamedRenderbufferStorageMultisample(depth_, samples_ > 1 ? samples_ : 0, GL_DEPTH24_STENCIL8, width, height);
+
+    glCreateFramebuffers(1, &scene_);
+    glNamedFramebufferRenderbuffer(scene_, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color_);
+    glNamedFramebufferRenderbuffer(scene_, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depth_);
+    if(glCheckNamedFramebufferStatus(scene_, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE){
+        throw std::runtime_error("failed to create scene framebuffer!");
+    }
+
+    if(samples_ > 1){
+        glCreateRenderbuffers(1, &resolveColor_);
+        glNamedRenderbufferStorage(resolveColor_, GL_RGBA8, width, height);
+        glCreateFramebuffers(1, &resolve_);
+        glNamedFramebufferRenderbuffer(resolve_, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, resolveColor_);
+        if(glCheckNamedFramebufferStatus(resolve_, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE){
+            throw std::runtime_error("failed to create resolve framebuffer!");
+        }
+    }
+
+    spdlog::info("Opengl scene target {}x{} samples = {}", width_, height_, samples_);
+}
+
+void OpenglRenderTarget::destroy()
+{
+    glDeleteFramebuffers(1, &scene_);
+    glDeleteFramebuffers(1, &resolve_);
+    glDeleteRenderbuffers(1, &color_);
+    glDeleteRenderbuffers(1, &depth_);
+    glDeleteRenderbuffers(1, &resolveColor_);
+    scene_ = resolve_ = color_ = depth_ = resolveColor_ = 0;
+}
+
+void OpenglRenderTarget::begin(uint32_t width, uint32_t height)
+{
+    drawWidth_ = std::clamp(width, 1u, width_);
+    drawHeight_ = std::clamp(height, 1u, height_);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, scene_);
+    glViewport(0, 0, static_cast<GLsizei>(drawWidth_), static_cast<GLsizei>(drawHeight_));
+    // the clear stays inside the rect as well
+    glScissor(0, 0, static_cast<GLsizei>(drawWidth_), static_cast<GLsizei>(drawHeight_));
+    OpenglState::setEnabled(GL_SCISSOR_TEST, true);
+}
+
+void OpenglRenderTarget::present(uint32_t width, uint32_t height)
+{
+    const GLint drawWidth = static_cast<GLint>(drawWidth_);
+    const GLint drawHeight = static_cast<GLint>(drawHeight_);
+
+    // blits are scissored too
+    OpenglState::setEnabled(GL_SCISSOR_TEST, false);
+
+    GLuint source = scene_;
+    if(resolve_){
+        glBlitNamedFramebuffer(scene_, resolve_, 0, 0, drawWidth, drawHeight,
+                               0, 0, drawWidth, drawHeight, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        source = resolve_;
+    }
+    const bool scaled = drawWidth_ != width || drawHeight_ != height;
+    glBlitNamedFramebuffer(source, 0, 0, 0, drawWidth, drawHeight,
+                           0, 0, static_cast<GLint>(width), static_cast<GLint>(height),
+                           GL_COLOR_BUFFER_BIT, scaled ? GL_LINEAR : GL_NEAREST);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height));
+}
+
+}//namespace ogl
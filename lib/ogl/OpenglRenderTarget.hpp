@@ -0,0 +1,50 @@
+#pragma once
+#include <GL/glew.h>
+//std
+#include <cstdint>
+
+namespace ogl
+{
+/**
+ * @brief Offscreen scene target at the window size, drawn in a bottom left rect of the scaled size.
+ *        A scale change only moves the rect, the window size reallocates. present() resolves the
+ *        multisampled rect and stretches it with a linear blit over the default framebuffer
+ */
+class OpenglRenderTarget
+{
+public:
+    // samples are clamped to GL_MAX_SAMPLES, 1 draws without multisampling
+    OpenglRenderTarget(uint32_t width, uint32_t height, GLsizei samples);
+    ~OpenglRenderTarget();
+
+    OpenglRenderTarget(const OpenglRenderTarget &) = delete;
+    void operator=(const OpenglRenderTarget &) = delete;
+
+    void resize(uint32_t width, uint32_t height);
+    // bind the scene framebuffer, viewport and scissor to the rect of width x height
+    void begin(uint32_t width, uint32_t height);
+    // upscale the rect to the default framebuffer of width x height, left bound
+    void present(uint32_t width, uint32_t height);
+
+    GLsizei samples() const { return samples_; }
+
+private:
+    void create();
+    void destroy();
+
+    GLsizei samples_ = 1;
+    uint32_t width_ = 0;
+    uint32_t height_ = 0;
+    // rect of the last begin()
+    uint32_t drawWidth_ = 0;
+    uint32_t drawHeight_ = 0;
+
+    GLuint scene_ = 0;
+    GLuint color_ = 0;
+    GLuint depth_ = 0;
+    // single sampled copy of the rect, only when multisampled: a resolve blit cannot scale
+    GLuint resolve_ = 0;
+    GLuint resolveColor_ = 0;
+};
+
+}//namespace ogl
@@ -0,0 +1,107 @@
+#include "OpenglRingBuffer.hpp"
+#include "OpenglState.hpp"
+//libs
+#include <spdlog/spdlog.h>
+//std
+#include <algorithm>
+#include <stdexcept>
+
+namespace ogl
+{
+OpenglRingBuffer::OpenglRingBuffer(size_t regionBytes)
+{
+    SPDLOG_DEBUG("constructor");
+
+    GLint uniformAlignment{};
+    GLint storageAlignment{};
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformAlignment);
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storageAlignment);
+    alignment_ = static_cast<size_t>(std::max({uniformAlignment, storageAlignment, 1}));
+
+    allocate(regionBytes);
+}
+
+OpenglRingBuffer::~OpenglRingBuffer()
+{
+    SPDLOG_DEBUG("destructor");
+    release();
+}
+
+void OpenglRingBuffer::allocate(size_t regionBytes)
+{
+    regionBytes_ = (std::max<size_t>(regionBytes, 1) + alignment_ - 1) / alignment_ * alignment_;
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    const GLsizeiptr size = static_cast<GLsizeiptr>(RING_FRAMES * regionBytes_);
+
+    glCreateBuffers(1, &buffer_);
+    glNamedBufferStorage(buffer_, size, nullptr, flags);
+    mapped_ = static_cast<uint8_t*>(glMapNamedBufferRange(buffer_, 0, size, flags));
+    if(!mapped_){
+        throw std::runtime_error("failed to map the ring buffer!");
+    }
+    SPDLOG_DEBUG("ring buffer {} regions of {} bytes", RING_FRAMES, regionBytes_);
+}
+
+void OpenglRingBuffer::release()
+{
+    for(auto &fence : fences_){
+        if(fence){
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+    if(buffer_){
+        glUnmapNamedBuffer(buffer_);
+        OpenglState::forgetBuffer(buffer_);
+        // the driver keeps the storage alive for the draws already queued
+        glDeleteBuffers(1, &buffer_);
+        buffer_ = 0;
+        mapped_ = nullptr;
+    }
+}
+
+void OpenglRingBuffer::wait(uint32_t region)
+{
+    GLsync &fence = fences_[region];
+    if(!fence){
+        return;
+    }
+    // flush once so the fence can signal, then block in 1 ms steps
+    GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+    while(true){
+        const GLenum result = glClientWaitSync(fence, flags, 1000000);
+        if(result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED){
+            break;
+        }
+        if(result == GL_WAIT_FAILED){
+            spdlog::error("ring buffer fence wait failed");
+            break;
+        }
+        flags = 0;
+    }
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+void OpenglRingBuffer::beginFrame(size_t bytes)
+{
+    if(bytes > regionBytes_){
+        // regions change size: start over in a new buffer
+        release();
+        allocate(std::max(bytes, regionBytes_ * 2));
+        current_ = 0;
+        return;
+    }
+    current_ = (current_ + 1) % RING_FRAMES;
+    wait(current_);
+}
+
+void OpenglRingBuffer::endFrame()
+{
+    if(fences_[current_]){
+        glDeleteSync(fences_[current_]);
+    }
+    fences_[current_] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+}//namespace ogl
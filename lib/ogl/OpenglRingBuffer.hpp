@@ -0,0 +1,56 @@
+#pragma once
+#include <GL/glew.h>
+//std
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace ogl
+{
+/**
+ * @brief Per-frame gpu data in one persistently mapped buffer split in RING_FRAMES regions.
+ *        A frame writes everything it needs in its own region and binds ranges of it,
+ *        the gpu reads the previous regions meanwhile. A region is fenced after its frame
+ *        and the fence is waited only when the cpu gets RING_FRAMES frames ahead
+ */
+class OpenglRingBuffer
+{
+public:
+    static constexpr uint32_t RING_FRAMES = 3;
+
+    // regions start at offsets valid for uniform and storage buffer ranges
+    explicit OpenglRingBuffer(size_t regionBytes);
+    ~OpenglRingBuffer();
+
+    OpenglRingBuffer(const OpenglRingBuffer &) = delete;
+    void operator=(const OpenglRingBuffer &) = delete;
+
+    // move to the next region, waiting for the gpu to release it, with room for bytes
+    void beginFrame(size_t bytes);
+    // current region, coherent: no flush needed
+    uint8_t* data() { return mapped_ + offset(); }
+    // of the current region in buffer()
+    GLintptr offset() const { return static_cast<GLintptr>(current_ * regionBytes_); }
+    GLuint buffer() const { return buffer_; }
+    // fence the region after the last draw reading it
+    void endFrame();
+
+    // largest of the uniform and storage buffer offset alignments
+    size_t alignment() const { return alignment_; }
+    // room of one region, beginFrame() with more reallocates the buffer
+    size_t regionBytes() const { return regionBytes_; }
+
+private:
+    void allocate(size_t regionBytes);
+    void release();
+    void wait(uint32_t region);
+
+    size_t alignment_{1};
+    size_t regionBytes_{0};
+    GLuint buffer_{0};
+    uint8_t *mapped_ = nullptr;
+    std::array<GLsync, RING_FRAMES> fences_{};
+    uint32_t current_{0};
+};
+
+}//namespace ogl
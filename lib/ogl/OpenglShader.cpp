@@ -1,6 +1,11 @@
 #include "OpenglShader.hpp"
 #include "OpenglImage.hpp"
 #include "OpenglUbo.hpp"
+#include "OpenglState.hpp"
+// common lib
+#include <program_cache.hpp>
+// std
+#include <algorithm>
 
 std::string getShaderInfoLog(GLuint shader) {
     GLint logLen;
@@ -29,8 +34,46 @@ std::string getProgramInfoLog(GLuint program) {
     return log;
 }
 
+// declare the multi draw variant right after the #version line, keeping the line numbers of the file
+static std::vector<char> multiDrawSource(const std::vector<char> &glsl)
+{
+    const std::string header = "#extension GL_ARB_shader_draw_parameters : require\n#define MULTI_DRAW\n#line 2\n";
+    auto version = std::find(glsl.begin(), glsl.end(), '\n');
+    if(version != glsl.end()){
+        ++version;
+    }
+    std::vector<char> source(glsl.begin(), version);
+    source.insert(source.end(), header.begin(), header.end());
+    source.insert(source.end(), version, glsl.end());
+    return source;
+}
+
+// programs linked by this driver, read on first use with the context current
+static ngn::ProgramCache& programCache()
+{
+    static ngn::ProgramCache cache = []{
+        auto driver = [](GLenum name){
+            auto str = reinterpret_cast<const char*>(glGetString(name));
+            return std::string(str ? str : "");
+        };
+        ngn::ProgramCache cache(ngn::ProgramCache::DIRECTORY, driver(GL_VENDOR) + "|" + driver(GL_RENDERER) + "|" + driver(GL_VERSION));
+        SPDLOG_DEBUG("program cache in {}", cache.directory());
+        return cache;
+    }();
+    return cache;
+}
+
+static bool programBinarySupported()
+{
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    return formats > 0;
+}
+
 ShaderBuilder& OpenglShaderBuilder::Reset(){
     this->shader = std::make_unique<OpenglShader>();
+    this->shader->multiDraw = multiDraw;
+    this->shader->loader = loader;
     return *this;
 }
 
@@ -42,8 +85,8 @@ ShaderBuilder& OpenglShaderBuilder::type(GLSL::ShaderType id) {
 
 ShaderBuilder& OpenglShaderBuilder::addTexture(std::string imagepath, uint32_t binding ) 
 {
-    auto image =  std::make_unique<OpenglImage>(imagepath);
-    this->shader->shaderBindings.image.emplace(binding, std::move(image));
+    // decoded and uploaded with the program
+    this->shader->textures.emplace_back(binding, std::move(imagepath));
     return *this;
 }
 
@@ -83,7 +126,11 @@ OpenglShader::~OpenglShader()
 {
     SPDLOG_DEBUG("OpenglShader destructor"); 
 
+    // the loader may still be writing to the program and the images
+    pending = {};
+
     if(prepared){
+        ogl::OpenglState::forgetProgram(shaderProgram);
         glDeleteProgram(shaderProgram);
     }
 }
@@ -91,51 +138,46 @@ OpenglShader::~OpenglShader()
 void OpenglShader::buid()
 {
     SPDLOG_DEBUG("OpenglShader build");
-    buildShaders();
+    if(loader){
+        pending = loader->submit([this]{ load(); });
+    }else{
+        load();
+    }
     prepared = true;
 }
 
+void OpenglShader::load()
+{
+    buildShaders();
+    for(const auto &[binding, path] : textures){
+        shaderBindings.image.emplace(binding, std::make_unique<OpenglImage>(path, loader ? loader->staging() : nullptr));
+    }
+}
+
 void  OpenglShader::bind(GLenum mode){
-    //TODO : set polygonmode & topology
-    
-    glPolygonMode(GL_FRONT_AND_BACK ,mode);
+    // drawing skips shaders not ready(), anything else waits for the loader
+    pending.wait();
 
-    glUseProgram(shaderProgram);
+    // redundant calls are dropped by the state cache, objects of the same shader bind nothing
+    ogl::OpenglState::polygonMode(mode);
+    ogl::OpenglState::useProgram(shaderProgram);
 
     for(auto& shaderBinding : shaderBindings.image){
-        shaderBinding.second->bind();
+        shaderBinding.second->bind(shaderBinding.first);
     }
 
 }
 
 void OpenglShader::buildShaders()
 {
-    GLuint vert_shader = glCreateShader(GL_VERTEX_SHADER);
-    GLuint frag_shader = glCreateShader(GL_FRAGMENT_SHADER);
-
-    GLint status;
-
-    auto glsl_vert = GLSL::readFile(GLSL::getPath(shaderType) + ".vert.spv");
-    auto glsl_frag = GLSL::readFile(GLSL::getPath(shaderType) + ".frag.spv");
-
-    // if (glsl)
-    // compile(vert_shader, glsl_vert, GL_VERTEX_SHADER);
-    // compile(frag_shader, glsl_frag, GL_FRAGMENT_SHADER);
-
-    glShaderBinary(1, &vert_shader, GL_SHADER_BINARY_FORMAT_SPIR_V, glsl_vert.data(), static_cast<GLsizei>(glsl_vert.size()));
-    glShaderBinary(1, &frag_shader, GL_SHADER_BINARY_FORMAT_SPIR_V, glsl_frag.data(), static_cast<GLsizei>(glsl_frag.size()));
-
-    glSpecializeShader( vert_shader, "main", 0, nullptr, nullptr);
-    glSpecializeShader( frag_shader, "main", 0, nullptr, nullptr);
-
-    glGetShaderiv(vert_shader, GL_COMPILE_STATUS, &status);
-    if( GL_FALSE == status ) {
-        spdlog::error("Failed to load vertex shader (SPIR-V) {}", getShaderInfoLog(vert_shader) );
-    }
-
-    glGetShaderiv(frag_shader, GL_COMPILE_STATUS, &status);
-    if( GL_FALSE == status ) {
-        spdlog::error("Failed to load fragment shader (SPIR-V) {}", getShaderInfoLog(frag_shader) );
+    std::vector<std::vector<char>> sources{};
+    if(multiDraw){
+        // spir-v has no opengl draw parameters and can't be linked with glsl: both stages from source
+        sources.push_back(multiDrawSource(GLSL::readFile(GLSL::getPath(shaderType) + ".vert")));
+        sources.push_back(multiDrawSource(GLSL::readFile(GLSL::getPath(shaderType) + ".frag")));
+    }else{
+        sources.push_back(GLSL::readFile(GLSL::getPath(shaderType) + ".vert.spv"));
+        sources.push_back(GLSL::readFile(GLSL::getPath(shaderType) + ".frag.spv"));
     }
 
     // Create the program object
@@ -144,15 +186,93 @@ void OpenglShader::buildShaders()
         spdlog::error("Error creating program object.");
     }
 
+    static const bool binarySupported = programBinarySupported();
+    const uint64_t key = binarySupported ? programCache().key(sources) : 0;
+    if(binarySupported && loadBinary(key)){
+        return;
+    }
+
+    GLuint vert_shader = glCreateShader(GL_VERTEX_SHADER);
+    GLuint frag_shader = glCreateShader(GL_FRAGMENT_SHADER);
+
+    GLint status;
+
+    auto &glsl_vert = sources[0];
+    auto &glsl_frag = sources[1];
+    if(multiDraw){
+        compile(vert_shader, glsl_vert, GL_VERTEX_SHADER);
+        compile(frag_shader, glsl_frag, GL_FRAGMENT_SHADER);
+    }else{
+        glShaderBinary(1, &vert_shader, GL_SHADER_BINARY_FORMAT_SPIR_V, glsl_vert.data(), static_cast<GLsizei>(glsl_vert.size()));
+        glShaderBinary(1, &frag_shader, GL_SHADER_BINARY_FORMAT_SPIR_V, glsl_frag.data(), static_cast<GLsizei>(glsl_frag.size()));
+
+        glSpecializeShader( vert_shader, "main", 0, nullptr, nullptr);
+        glSpecializeShader( frag_shader, "main", 0, nullptr, nullptr);
+
+        glGetShaderiv(vert_shader, GL_COMPILE_STATUS, &status);
+        if( GL_FALSE == status ) {
+            spdlog::error("Failed to load vertex shader (SPIR-V) {}", getShaderInfoLog(vert_shader) );
+        }
+
+        glGetShaderiv(frag_shader, GL_COMPILE_STATUS, &status);
+        if( GL_FALSE == status ) {
+            spdlog::error("Failed to load fragment shader (SPIR-V) {}", getShaderInfoLog(frag_shader) );
+        }
+    }
+
     glAttachShader(shaderProgram, vert_shader);
     glAttachShader(shaderProgram, frag_shader);
+    if(binarySupported){
+        glProgramParameteri(shaderProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
     
     link();
 
     glDeleteShader(vert_shader);
     glDeleteShader(frag_shader);
 
-    // glUseProgram(shaderProgram);
+    if(binarySupported){
+        storeBinary(key);
+    }
+}
+
+bool OpenglShader::loadBinary(uint64_t key)
+{
+    auto binary = programCache().load(key);
+    if(!binary){
+        return false;
+    }
+    glProgramBinary(shaderProgram, binary->format, binary->data.data(), static_cast<GLsizei>(binary->data.size()));
+
+    GLint status;
+    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &status);
+    if(GL_FALSE == status){
+        // the driver changed the format without changing its strings: link from the sources again
+        SPDLOG_DEBUG("program binary of {} refused", GLSL::getName(shaderType));
+        programCache().erase(key);
+        return false;
+    }
+    SPDLOG_DEBUG("program {} loaded from the binary cache", GLSL::getName(shaderType));
+    cacheHits_++;
+    return true;
+}
+
+void OpenglShader::storeBinary(uint64_t key)
+{
+    GLint status;
+    GLint length = 0;
+    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &status);
+    glGetProgramiv(shaderProgram, GL_PROGRAM_BINARY_LENGTH, &length);
+    if(GL_FALSE == status || length <= 0){
+        return;
+    }
+    std::vector<std::byte> data(static_cast<size_t>(length));
+    GLenum format = 0;
+    glGetProgramBinary(shaderProgram, length, &length, &format, data.data());
+    data.resize(static_cast<size_t>(length));
+    if(!programCache().store(key, format, data)){
+        spdlog::warn("failed to write the program binary of {}", GLSL::getName(shaderType));
+    }
 }
 
 void OpenglShader::link()
@@ -4,10 +4,12 @@
 #include <mytypes.hpp>
 #include <vertex.h>
 #include <glsl_constants.h>
+#include "OpenglLoader.hpp"
 // lib
 #include <GL/glew.h>
 #include <glm/glm.hpp>
 // std
+#include <atomic>
 #include <map>
 
 
@@ -19,8 +21,17 @@ class OpenglShader;
 class OpenglShaderBuilder : public ShaderBuilder{
 private:
     std::unique_ptr<OpenglShader> shader;
+    bool multiDraw;
+    ogl::OpenglLoader *loader;
 
 public:
+    /**
+     * @param multiDraw build from the glsl sources with MULTI_DRAW defined,
+     *        the model matrix is read from the storage buffer at gl_DrawID
+     * @param loader programs and textures are built on its context, in the background
+     */
+    explicit OpenglShaderBuilder(bool multiDraw = false, ogl::OpenglLoader *loader = nullptr)
+        : multiDraw{multiDraw}, loader{loader} {}
 
     ShaderBuilder& Reset() override;
     ShaderBuilder& type(GLSL::ShaderType id)  override;
@@ -43,15 +54,24 @@ public:
     ~OpenglShader();
 
     void buid();  
+    // program and textures can be used, false while the loader builds them
+    bool ready() { return pending.ready(); }
     void bind(GLenum mode);
 
     GLenum getTopology(){return topology;}
+    // programs loaded from the binary cache instead of linked
+    static uint32_t cacheHits() { return cacheHits_.load(); }
     
 
 private:
+    // program and textures, on the loader context when there is one
+    void load();
     void buildShaders();
     void compile(GLuint shader, std::vector<char> &glsl, GLenum  kind);
     void link();
+    // false on a miss or a binary the driver refuses, the program is then linked from the sources
+    bool loadBinary(uint64_t key);
+    void storeBinary(uint64_t key);
     void setVec1(const std::string &name, const float value) const
     { 
         glUniform1f(glGetUniformLocation(shaderProgram, name.c_str()),  value); 
@@ -66,10 +86,17 @@ private:
     }
 
     GLSL::ShaderType shaderType;
+    bool multiDraw = false;
     unsigned int shaderProgram;
     const uint32_t globalUboBinding = 0;
 
     bool prepared = false;
+    static inline std::atomic<uint32_t> cacheHits_{0};
+
+    ogl::OpenglLoader *loader = nullptr;
+    ogl::OpenglLoader::Pending pending{};
+    // images read by load()
+    std::vector<std::pair<uint32_t, std::string>> textures{};
 
     GLenum  polygonMode = GL_FILL; 
     GLenum  topology = GL_TRIANGLES;
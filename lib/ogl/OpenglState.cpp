@@ -0,0 +1,216 @@
+#include "OpenglState.hpp"
+//common lib
+#include <profiler.hpp>
+//std
+#include <array>
+#include <cstdint>
+
+namespace ogl
+{
+namespace
+{
+    // no name is ever this value
+    constexpr GLuint UNKNOWN = ~GLuint{0};
+    constexpr uint32_t MAX_TEXTURE_UNITS = 32;
+    constexpr uint32_t MAX_BUFFER_BINDINGS = 16;
+
+    struct BufferRange{
+        GLuint     buffer{UNKNOWN};
+        GLintptr   offset{0};
+        GLsizeiptr size{0};
+    };
+
+    struct Capability{
+        GLenum  cap;
+        // -1 unknown
+        int8_t  state;
+    };
+
+    // what the context has, as set through OpenglState
+    struct Cache{
+        Cache() { textures.fill(UNKNOWN); }
+
+        GLuint program{UNKNOWN};
+        GLuint vao{UNKNOWN};
+        std::array<GLuint, MAX_TEXTURE_UNITS> textures{};
+        std::array<BufferRange, MAX_BUFFER_BINDINGS> uniformRanges{};
+        std::array<BufferRange, MAX_BUFFER_BINDINGS> storageRanges{};
+        GLuint drawIndirect{UNKNOWN};
+        GLenum polygonMode{UNKNOWN};
+        std::array<Capability, 5> capabilities{{
+            {GL_DEPTH_TEST, -1}, {GL_BLEND, -1}, {GL_CULL_FACE, -1}, {GL_MULTISAMPLE, -1}, {GL_SCISSOR_TEST, -1}
+        }};
+        int8_t depthMask{-1};
+        std::array<GLenum, 2> blendFunc{UNKNOWN, UNKNOWN};
+    };
+
+    // one context, used by the thread owning it
+    Cache cache{};
+
+    BufferRange* range(GLenum target, GLuint index)
+    {
+        if(index >= MAX_BUFFER_BINDINGS){
+            return nullptr;
+        }
+        switch(target){
+            case GL_UNIFORM_BUFFER:        return &cache.uniformRanges[index];
+            case GL_SHADER_STORAGE_BUFFER: return &cache.storageRanges[index];
+            default:                       return nullptr;
+        }
+    }
+
+    GLuint* buffer(GLenum target)
+    {
+        return target == GL_DRAW_INDIRECT_BUFFER ? &cache.drawIndirect : nullptr;
+    }
+}
+
+bool OpenglState::issue(bool changed)
+{
+    ngn::Profiler::countStateCall(changed);
+    return changed;
+}
+
+void OpenglState::useProgram(GLuint program)
+{
+    if(issue(cache.program != program)){
+        cache.program = program;
+        glUseProgram(program);
+        ngn::Profiler::countBinds();
+    }
+}
+
+void OpenglState::bindVertexArray(GLuint vao)
+{
+    if(issue(cache.vao != vao)){
+        cache.vao = vao;
+        glBindVertexArray(vao);
+        ngn::Profiler::countBinds();
+    }
+}
+
+void OpenglState::bindTextureUnit(GLuint unit, GLuint texture)
+{
+    if(unit >= MAX_TEXTURE_UNITS){
+        issue(true);
+        glBindTextureUnit(unit, texture);
+        ngn::Profiler::countBinds();
+        return;
+    }
+    if(issue(cache.textures[unit] != texture)){
+        cache.textures[unit] = texture;
+        glBindTextureUnit(unit, texture);
+        ngn::Profiler::countBinds();
+    }
+}
+
+void OpenglState::bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+{
+    BufferRange *current = range(target, index);
+    const bool changed = !current || current->buffer != buffer || current->offset != offset || current->size != size;
+    if(issue(changed)){
+        if(current){
+            *current = {buffer, offset, size};
+        }
+        glBindBufferRange(target, index, buffer, offset, size);
+        ngn::Profiler::countBinds();
+    }
+}
+
+void OpenglState::bindBuffer(GLenum target, GLuint name)
+{
+    GLuint *current = buffer(target);
+    if(issue(!current || *current != name)){
+        if(current){
+            *current = name;
+        }
+        glBindBuffer(target, name);
+        ngn::Profiler::countBinds();
+    }
+}
+
+void OpenglState::polygonMode(GLenum mode)
+{
+    if(issue(cache.polygonMode != mode)){
+        cache.polygonMode = mode;
+        glPolygonMode(GL_FRONT_AND_BACK, mode);
+    }
+}
+
+void OpenglState::setEnabled(GLenum capability, bool enabled)
+{
+    const int8_t state = enabled ? 1 : 0;
+    Capability *current = nullptr;
+    for(auto &c : cache.capabilities){
+        if(c.cap == capability){
+            current = &c;
+        }
+    }
+    if(issue(!current || current->state != state)){
+        if(current){
+            current->state = state;
+        }
+        enabled ? glEnable(capability) : glDisable(capability);
+    }
+}
+
+void OpenglState::depthMask(bool write)
+{
+    const int8_t state = write ? 1 : 0;
+    if(issue(cache.depthMask != state)){
+        cache.depthMask = state;
+        glDepthMask(write ? GL_TRUE : GL_FALSE);
+    }
+}
+
+void OpenglState::blendFunc(GLenum src, GLenum dst)
+{
+    if(issue(cache.blendFunc[0] != src || cache.blendFunc[1] != dst)){
+        cache.blendFunc = {src, dst};
+        glBlendFunc(src, dst);
+    }
+}
+
+void OpenglState::invalidate()
+{
+    cache = Cache{};
+}
+
+void OpenglState::forgetProgram(GLuint program)
+{
+    if(cache.program == program){
+        cache.program = UNKNOWN;
+    }
+}
+
+void OpenglState::forgetVertexArray(GLuint vao)
+{
+    if(cache.vao == vao){
+        cache.vao = UNKNOWN;
+    }
+}
+
+void OpenglState::forgetTexture(GLuint texture)
+{
+    for(auto &unit : cache.textures){
+        if(unit == texture){
+            unit = UNKNOWN;
+        }
+    }
+}
+
+void OpenglState::forgetBuffer(GLuint name)
+{
+    for(auto *ranges : {&cache.uniformRanges, &cache.storageRanges}){
+        for(auto &r : *ranges){
+            if(r.buffer == name){
+                r = {};
+            }
+        }
+    }
+    if(cache.drawIndirect == name){
+        cache.drawIndirect = UNKNOWN;
+    }
+}
+
+}//namespace ogl
@@ -0,0 +1,41 @@
+#pragma once
+#include <GL/glew.h>
+
+namespace ogl
+{
+/**
+ * @brief Shadow of the context state set by the backend, a call matching the current value is dropped.
+ *        Every bind and state change of lib/ogl goes through here; issued and filtered calls are counted
+ *        per frame for the profiler. Code changing the state behind it (the ui backend) must be followed
+ *        by invalidate(), deleted names must be forgotten before their name is reused
+ */
+struct OpenglState
+{
+    static void useProgram(GLuint program);
+    static void bindVertexArray(GLuint vao);
+    static void bindTextureUnit(GLuint unit, GLuint texture);
+    // GL_UNIFORM_BUFFER or GL_SHADER_STORAGE_BUFFER
+    static void bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+    // GL_DRAW_INDIRECT_BUFFER
+    static void bindBuffer(GLenum target, GLuint buffer);
+    // front and back faces
+    static void polygonMode(GLenum mode);
+    // GL_DEPTH_TEST, GL_BLEND, GL_CULL_FACE, GL_MULTISAMPLE, GL_SCISSOR_TEST
+    static void setEnabled(GLenum capability, bool enabled);
+    static void depthMask(bool write);
+    static void blendFunc(GLenum src, GLenum dst);
+
+    // assume nothing about the current state, the next call of every kind is issued
+    static void invalidate();
+
+    static void forgetProgram(GLuint program);
+    static void forgetVertexArray(GLuint vao);
+    static void forgetTexture(GLuint texture);
+    static void forgetBuffer(GLuint buffer);
+
+private:
+    // count the call and tell if it must reach the driver
+    static bool issue(bool changed);
+};
+
+}//namespace ogl
@@ -17,6 +17,9 @@ void OpenglUIOverlay::init()
 	if(!ImGui_ImplOpenGL3_Init(glsl_version)){
         throw std::runtime_error("failed to initialize ImGui_ImplOpenGL3_Init!");
     }
+    // create the device objects and the font atlas now, 
+    // ImGui::NewFrame may run on a thread without the opengl context
+    ImGui_ImplOpenGL3_NewFrame();
 }
 
 void OpenglUIOverlay::cleanup()
@@ -29,11 +32,11 @@ void OpenglUIOverlay::cleanup()
 void OpenglUIOverlay::newFrame()
 {
     // feed inputs to dear imgui, start new frame
-	ImGui_ImplOpenGL3_NewFrame();
 	ImGui_ImplGlfw_NewFrame();
 }  
 
-void OpenglUIOverlay::draw()
+void OpenglUIOverlay::draw(ImDrawData *drawData)
 {
-	ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+	ImGui_ImplOpenGL3_NewFrame();
+	ImGui_ImplOpenGL3_RenderDrawData(drawData);
 }
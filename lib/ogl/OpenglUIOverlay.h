@@ -1,6 +1,7 @@
 #pragma once
 
 struct GLFWwindow;
+struct ImDrawData;
 
 class OpenglUIOverlay
 {
@@ -8,8 +9,10 @@ public:
 
     void init();
 
+    // platform new frame, main thread
     void newFrame();
-    void draw();
+    // render thread
+    void draw(ImDrawData *drawData);
     void cleanup();
     
     GLFWwindow *windowPtr;
@@ -1,4 +1,5 @@
 #pragma once
+#include "OpenglState.hpp"
 
 // lib
 #include <GL/glew.h>
@@ -21,7 +22,7 @@ public:
     }
 
    void bind(const void *data, GLsizeiptr size) {
-        glBindBufferRange(GL_UNIFORM_BUFFER, binding_point, ubo, offset, size);
+        ogl::OpenglState::bindBufferRange(GL_UNIFORM_BUFFER, binding_point, ubo, offset, size);
         glNamedBufferSubData(ubo, offset, size, data);
     }
 
@@ -1,10 +1,11 @@
 #include "OpenglVertexBuffer.hpp"
 // common
 #include <model.hpp>
+#include <profiler.hpp>
 
 
 ObjectBuilder& OpenglObjectBuilder::Reset(){
-    renderobject = std::make_unique<OpenglVertexBuffer>();
+    renderobject = std::make_unique<OpenglVertexBuffer>(geometry);
     return *this;
 }
 
@@ -12,7 +13,6 @@ std::unique_ptr<RenderObject>
 OpenglObjectBuilder::build(Model &model, std::string shadername)
 {
     renderobject->shader = shadername;
-    renderobject->objNode = model.node;
     renderobject->build(model);
     std::unique_ptr<RenderObject> result = std::move(this->renderobject);
     return result;
@@ -20,26 +20,10 @@ OpenglObjectBuilder::build(Model &model, std::string shadername)
 
 void OpenglVertexBuffer::build(Model &model)
 {
-    _indices_size       = static_cast<GLsizei>(model.indicesSize());
-    _stride             = sizeof(Vertex);
-    auto vertices_size  = model.verticesSize();
-    auto vertices_data  = model.verticesData();
-    auto indices_data   = model.indicesData();
+    mesh = geometry.add(model);
 
-    glCreateBuffers(1, &VBO);
-    glNamedBufferStorage(VBO, vertices_size * sizeof(Vertex), vertices_data, GL_DYNAMIC_STORAGE_BIT);
-    
-    glCreateBuffers(1, &IBO);
-    glNamedBufferStorage(IBO, _indices_size * sizeof(Index), indices_data, GL_DYNAMIC_STORAGE_BIT);
-
-    glCreateVertexArrays(1, &VAO);
-
-    //offset of the first element of the buffer
-    const GLintptr offset = 0;
-    glVertexArrayVertexBuffer(VAO, bindingIndex, VBO, offset, _stride);
-    glVertexArrayElementBuffer(VAO, IBO);
-    
-    setVertexAttribPointer();
+    residentBytes = mesh.vertexCount * sizeof(Vertex) + mesh.indexCount * sizeof(Index);
+    ngn::Profiler::addMeshBytes(static_cast<int64_t>(residentBytes));
 
     prepared = true; 
 }
@@ -47,34 +31,19 @@ void OpenglVertexBuffer::build(Model &model)
 OpenglVertexBuffer::~OpenglVertexBuffer()
 { 
     if (prepared){
-        glDeleteVertexArrays(1, &VAO);
-        glDeleteBuffers(1, &VBO);
-        glDeleteBuffers(1, &IBO);
+        ngn::Profiler::addMeshBytes(-static_cast<int64_t>(residentBytes));
+        geometry.remove(mesh);
     }  
 }
 
 void OpenglVertexBuffer::draw(GLenum mode)
 {
-    if(!prepared){
+    if(!prepared || mesh.empty()){
         return;
     }
-    glBindVertexArray(VAO); 
-    glDrawElements(mode, (GLsizei) _indices_size , GL_UNSIGNED_INT, 0);
-}
+    geometry.bind();
+    const void *firstIndex = reinterpret_cast<const void*>(static_cast<uintptr_t>(mesh.firstIndex) * sizeof(Index));
+    glDrawElementsBaseVertex(mode, static_cast<GLsizei>(mesh.indexCount), GL_UNSIGNED_INT, firstIndex, static_cast<GLint>(mesh.baseVertex));
 
-
-void OpenglVertexBuffer::setVertexAttribPointer(){
-    auto attributes =  OpenglVertexBuffer::getAttributeDescriptions();
-    for( const auto & attribute : attributes){
-        glEnableVertexArrayAttrib(VAO, attribute.location); 
-        glVertexArrayAttribFormat( 
-            VAO,
-            attribute.location, 
-            attribute.size, 
-            attribute.type, 
-            attribute.normalized, 
-            attribute.reloffset 
-        );
-        glVertexArrayAttribBinding(VAO, attribute.location, bindingIndex);
-    }
-}
\ No newline at end of file
+    ngn::Profiler::countDraw();
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include "OpenglGeometry.hpp"
 // common
 #include <baseclass.hpp>
 #include <vertex.h>
@@ -31,7 +32,9 @@ class OpenglVertexBuffer;
 class OpenglObjectBuilder : public ObjectBuilder{
 private:
     std::unique_ptr<OpenglVertexBuffer> renderobject;
+    ogl::OpenglGeometry &geometry;
 public:
+    explicit OpenglObjectBuilder(ogl::OpenglGeometry &geometry) : geometry{geometry} {}
 
     ObjectBuilder& Reset() override;
     virtual std::unique_ptr<RenderObject> build(Model &model, std::string shader) override;
@@ -71,20 +74,22 @@ public:
         return attributeDescriptions;
     }
 
-    OpenglVertexBuffer() = default;
+    explicit OpenglVertexBuffer(ogl::OpenglGeometry &geometry) : geometry{geometry} {}
     ~OpenglVertexBuffer();
 
     void build(Model &model);
     void draw(GLenum mode);
 
+    size_t getIndexSize() { return static_cast<size_t>(mesh.indexCount); }
+    // ranges in the shared geometry, for multi draw commands
+    const ogl::OpenglGeometry::Mesh& getMesh() const { return mesh; }
+
 private:
 
-    void setVertexAttribPointer();
     bool prepared = false;
     
-    GLuint VBO, VAO, IBO;
-    const GLuint bindingIndex = 0;
-    GLsizei _stride;
-    GLsizei _indices_size;
+    ogl::OpenglGeometry &geometry;
+    ogl::OpenglGeometry::Mesh mesh{};
+    size_t residentBytes{0};
 };
 
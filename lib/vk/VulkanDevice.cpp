@@ -1,10 +1,13 @@
 #include "VulkanDevice.hpp"
+#include "VulkanUploader.hpp"
 #include "vk_initializers.h"
 #define VMA_IMPLEMENTATION
 #include "vk_mem_alloc.h"
 //common lib
 #include <Window.hpp>
+#include <display_settings.hpp>
 //std
+#include <algorithm>
 #include <set>
 
 VkResult CreateDebugUtilsMessengerEXT(VkInstance instance, const VkDebugUtilsMessengerCreateInfoEXT* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkDebugUtilsMessengerEXT* pDebugMessenger) {
@@ -51,9 +54,10 @@ void VulkanDevice::init()
     createLogicalDevice();
     createVulkanAllocator();
     createDefaultCommandPool();
+    uploader = std::make_unique<VulkanUploader>(*this);
 
-    // Cap msaa 
-    setMsaaValue(VK_SAMPLE_COUNT_2_BIT);
+    // Cap msaa to the requested samples, changed later by VulkanEngine
+    setMsaaValue(static_cast<VkSampleCountFlagBits>(ngn::Display::get().samples));
     
 }
 
@@ -64,6 +68,7 @@ void VulkanDevice::cleanup()
     //make sure the gpu has stopped doing its things
 	vkDeviceWaitIdle(logicalDevice);
 
+    uploader.reset();
     vkDestroyCommandPool(logicalDevice, defaultcommandPool, nullptr); 
     vmaDestroyAllocator(_allocator);
     vkDestroyDevice(logicalDevice, nullptr);
@@ -121,7 +126,10 @@ void VulkanDevice::createLogicalDevice()
     QueueFamilyIndices indices = findQueueFamilies(physicalDevice);
 
     std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
-    std::set<uint32_t> uniqueQueueFamilies = {indices.graphicsFamily.value(), indices.presentFamily.value()};
+    graphicsFamily = indices.graphicsFamily.value();
+    transferFamily = indices.transferFamily.value_or(graphicsFamily);
+    computeFamily = indices.computeFamily.value_or(graphicsFamily);
+    std::set<uint32_t> uniqueQueueFamilies = {graphicsFamily, indices.presentFamily.value(), transferFamily, computeFamily};
 
     float queuePriority = 1.0f;
     for (uint32_t queueFamily : uniqueQueueFamilies) {
@@ -143,11 +151,25 @@ void VulkanDevice::createLogicalDevice()
     createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
     createInfo.pQueueCreateInfos = queueCreateInfos.data();
     createInfo.pEnabledFeatures = &deviceFeatures; 
-    createInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
-    createInfo.ppEnabledExtensionNames = deviceExtensions.data();
+    // memory budget is optional, used by the performance hud if available
+    std::vector<const char*> extensions(deviceExtensions);
+    _memoryBudgetSupported = checkDeviceExtensionSupport(physicalDevice, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME) 
+                                && _physicalDeviceProperties.apiVersion >= VK_API_VERSION_1_1;
+    if(_memoryBudgetSupported){
+        extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    }
+
+    createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+    createInfo.ppEnabledExtensionNames = extensions.data();
     deviceFeatures.samplerAnisotropy = VK_TRUE;
     deviceFeatures.fillModeNonSolid = VK_TRUE;
 
+    // pipeline statistics queries are optional, used by the gpu profiler if available
+    VkPhysicalDeviceFeatures supportedFeatures;
+    vkGetPhysicalDeviceFeatures(physicalDevice, &supportedFeatures);
+    deviceFeatures.pipelineStatisticsQuery = supportedFeatures.pipelineStatisticsQuery;
+    _enabledFeatures = deviceFeatures;
+
     if (enableValidationLayers) {
         createInfo.enabledLayerCount = static_cast<uint32_t>(validationLayers.size());
         createInfo.ppEnabledLayerNames = validationLayers.data();
@@ -161,6 +183,13 @@ void VulkanDevice::createLogicalDevice()
     // Because we’re only creating a single queue from this family, we’ll simply use index 0.
     vkGetDeviceQueue(logicalDevice, indices.graphicsFamily.value(), 0, &graphicsQueue);
     vkGetDeviceQueue(logicalDevice, indices.presentFamily.value(), 0, &presentQueue);
+    vkGetDeviceQueue(logicalDevice, transferFamily, 0, &transferQueue);
+    vkGetDeviceQueue(logicalDevice, computeFamily, 0, &computeQueue);
+
+    spdlog::info("queue families graphics {} present {} transfer {} compute {}",
+        graphicsFamily, indices.presentFamily.value(), 
+        indices.transferFamily ? std::to_string(transferFamily) : "shared",
+        indices.computeFamily ? std::to_string(computeFamily) : "shared");
 }
 
 void VulkanDevice::createVulkanAllocator()
@@ -170,6 +199,12 @@ void VulkanDevice::createVulkanAllocator()
     allocatorInfo.physicalDevice = physicalDevice;
     allocatorInfo.device = logicalDevice;
     allocatorInfo.instance = instance;
+    if(_memoryBudgetSupported){
+        // vma reads the budget with vkGetPhysicalDeviceMemoryProperties2, core in Vulkan 1.1
+        allocatorInfo.vulkanApiVersion = VK_API_VERSION_1_1;
+        allocatorInfo.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+    }
+    spdlog::info("VK_EXT_memory_budget {}", _memoryBudgetSupported ? "enabled" : "unsupported");
     vmaCreateAllocator(&allocatorInfo, &_allocator);
 }
 
@@ -230,23 +265,30 @@ QueueFamilyIndices VulkanDevice::findQueueFamilies(VkPhysicalDevice device)
 
     // Logic to find queue family indices to populate struct with
     // We need to find at least one queue family that supports both: VK_QUEUE_GRAPHICS_BIT & supporting presentation.
+    // Every family is visited, the dedicated ones usually come after the graphics family
     int i = 0;
     for (const auto& queueFamily : queueFamilies) {
+        const VkQueueFlags flags = queueFamily.queueFlags;
         // looking for drawing commands support
-        if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) {
+        if (!indices.graphicsFamily.has_value() && (flags & VK_QUEUE_GRAPHICS_BIT)) {
             indices.graphicsFamily = i;
         }
         VkBool32 presentSupport = false;
         vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
 
         // looking for presentation support
-        if (presentSupport) {
+        if (!indices.presentFamily.has_value() && presentSupport) {
             indices.presentFamily = i;
         }
 
-        // if found: early exit
-        if (indices.isComplete()) {
-            break;
+        // copy engine: transfer only
+        if (!indices.transferFamily.has_value() && (flags & VK_QUEUE_TRANSFER_BIT) 
+                && !(flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT))) {
+            indices.transferFamily = i;
+        }
+        // async compute: compute without graphics
+        if (!indices.computeFamily.has_value() && (flags & VK_QUEUE_COMPUTE_BIT) && !(flags & VK_QUEUE_GRAPHICS_BIT)) {
+            indices.computeFamily = i;
         }
 
         i++;
@@ -279,6 +321,22 @@ bool VulkanDevice::checkValidationLayerSupport() {
     return true;
 }
 
+bool VulkanDevice::checkDeviceExtensionSupport(VkPhysicalDevice device, const char* extension)
+{
+    uint32_t extensionCount;
+    vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+
+    std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+    vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
+
+    for (const auto& available : availableExtensions) {
+        if (strcmp(extension, available.extensionName) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
 bool VulkanDevice::checkDeviceExtensionSupport(VkPhysicalDevice device)
 {
 
@@ -570,6 +628,22 @@ void VulkanDevice::destroyVmaImage(VkImage &image, VmaAllocation &allocation)
     vmaDestroyImage(_allocator, image, allocation);
 }
 
+void VulkanDevice::allocateVmaMemory(const VkMemoryRequirements &requirements, VmaAllocationCreateInfo &vmaallocInfo, VmaAllocation &allocation)
+{
+    VK_CHECK_RESULT(vmaAllocateMemory(_allocator, &requirements, &vmaallocInfo, &allocation, nullptr) );
+}
+
+void VulkanDevice::bindVmaImageMemory(VmaAllocation &allocation, VkDeviceSize offset, VkImage image)
+{
+    VK_CHECK_RESULT(vmaBindImageMemory2(_allocator, allocation, offset, image, nullptr) );
+}
+
+void VulkanDevice::freeVmaMemory(VmaAllocation &allocation)
+{
+    vmaFreeMemory(_allocator, allocation);
+    allocation = VK_NULL_HANDLE;
+}
+
 VkSampleCountFlagBits VulkanDevice::getMaxUsableSampleCount() 
 {
     VkSampleCountFlags counts = _physicalDeviceProperties.limits.framebufferColorSampleCounts & _physicalDeviceProperties.limits.framebufferDepthSampleCounts;
@@ -583,10 +657,41 @@ VkSampleCountFlagBits VulkanDevice::getMaxUsableSampleCount()
     return VK_SAMPLE_COUNT_1_BIT;
 }
 
-void VulkanDevice::setMsaaValue(VkSampleCountFlagBits value){
-    if(value <= getMaxUsableSampleCount()){
-        _msaaSamples = value;
+/**
+ * @brief Number of meaningful bits written by vkCmdWriteTimestamp on the graphics queue
+ * 
+ * @return uint32_t zero if timestamps are not supported
+ */
+uint32_t VulkanDevice::getTimestampValidBits()
+{
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+    return queueFamilies[getQueueFamiliesIndices().graphicsFamily.value()].timestampValidBits;
+}
+
+uint32_t VulkanDevice::getHeapBudgets(VmaBudget *budgets, VkMemoryHeapFlags *flags)
+{
+    const VkPhysicalDeviceMemoryProperties *memProperties = nullptr;
+    vmaGetMemoryProperties(_allocator, &memProperties);
+
+    vmaGetBudget(_allocator, budgets);
+
+    if(flags){
+        for(uint32_t i = 0; i < memProperties->memoryHeapCount; i++){
+            flags[i] = memProperties->memoryHeaps[i].flags;
+        }
     }
+    return memProperties->memoryHeapCount;
+}
+
+void VulkanDevice::setMsaaValue(VkSampleCountFlagBits value){
+    // single bit flags, the smaller one is the lower count
+    _msaaSamples = std::min(value, getMaxUsableSampleCount());
+    spdlog::info("Vulkan msaa samples = {}", static_cast<uint32_t>(_msaaSamples));
 }
 
 // The function involves recording and executing a command buffer 
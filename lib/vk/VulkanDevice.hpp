@@ -6,6 +6,7 @@
 #include <GLFW/glfw3.h>
 #include "vktypes.h"
 //std
+#include <memory>
 #include <vector>
 #include <optional>
 
@@ -42,6 +43,9 @@ namespace vks
 struct QueueFamilyIndices {
     std::optional<uint32_t> graphicsFamily;
     std::optional<uint32_t> presentFamily; 
+    // families without graphics: copies and compute run beside the graphics queue
+    std::optional<uint32_t> transferFamily;
+    std::optional<uint32_t> computeFamily;
     
     bool isComplete() {
         return graphicsFamily.has_value() && presentFamily.has_value();
@@ -55,6 +59,7 @@ struct SwapChainSupportDetails {
 };
 
 class Window;
+class VulkanUploader;
 
 class VulkanDevice
 {    
@@ -83,14 +88,34 @@ public:
     VkInstance getInstance() {return instance; }
     VkQueue getGraphicsQueue() {return graphicsQueue; }
     VkQueue getPresentQueue() {return presentQueue; } 
+    // the graphics queue and family when the device has no dedicated one
+    VkQueue getTransferQueue() {return transferQueue; }
+    VkQueue getComputeQueue() {return computeQueue; }
+    uint32_t getGraphicsFamily() {return graphicsFamily; }
+    uint32_t getTransferFamily() {return transferFamily; }
+    uint32_t getComputeFamily() {return computeFamily; }
+    VulkanUploader& getUploader() {return *uploader; }
     VkFormat getDepthFormat() {return findDepthFormat(); }
     VkFormat findSupportedFormat(const std::vector<VkFormat>& candidates, VkImageTiling tiling, VkFormatFeatureFlags features);
 
     const VkSampleCountFlagBits getMsaaSamples() { return _msaaSamples; }
+    // clamped to getMaxUsableSampleCount(), the swapchain scene targets and pipelines must be recreated
     void setMsaaValue(VkSampleCountFlagBits value); 
 
     VkCommandPool getDeafaultCommadPool() { return defaultcommandPool; }
     VkPhysicalDeviceProperties getPhysicalDeviceProperties() {return _physicalDeviceProperties;}
+    VkPhysicalDeviceFeatures getEnabledFeatures() {return _enabledFeatures;}
+    uint32_t getTimestampValidBits();
+
+    /**
+     * @brief Current usage and budget of every memory heap,
+     *        estimated by vma when VK_EXT_memory_budget is not available
+     * 
+     * @param budgets array of VK_MAX_MEMORY_HEAPS elements
+     * @param flags   optional array of VK_MAX_MEMORY_HEAPS heap flags
+     * @return uint32_t number of heaps
+     */
+    uint32_t getHeapBudgets(VmaBudget *budgets, VkMemoryHeapFlags *flags = nullptr);
 
     VkResult createBuffer(VkBufferUsageFlags usageFlags, VkMemoryPropertyFlags memoryPropertyFlags, 
             vks::Buffer *buffer, VkDeviceSize size, void *data = nullptr);
@@ -105,6 +130,10 @@ public:
 
     void createVmaImage(VkImageCreateInfo &imageInfo, VmaAllocationCreateInfo &vmaallocInfo, VkImage &dest_image, VmaAllocation &allocation);  
     void destroyVmaImage(VkImage &image, VmaAllocation &allocation);
+    // memory shared by several resources, bound at offsets of the allocation
+    void allocateVmaMemory(const VkMemoryRequirements &requirements, VmaAllocationCreateInfo &vmaallocInfo, VmaAllocation &allocation);
+    void bindVmaImageMemory(VmaAllocation &allocation, VkDeviceSize offset, VkImage image);
+    void freeVmaMemory(VmaAllocation &allocation);
 
     void createCommandPool(VkCommandPool *pool);
     void createImage(uint32_t width, uint32_t height, uint32_t mipLevels,
@@ -142,6 +171,7 @@ private:
 
     bool checkValidationLayerSupport();
     bool checkDeviceExtensionSupport(VkPhysicalDevice device);
+    bool checkDeviceExtensionSupport(VkPhysicalDevice device, const char* extension);
 
     //validation layer helper functions
     void populateDebugMessengerCreateInfo(VkDebugUtilsMessengerCreateInfoEXT& createInfo);
@@ -158,6 +188,8 @@ private:
     VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
     VkDevice logicalDevice;
     VkPhysicalDeviceProperties _physicalDeviceProperties;
+    VkPhysicalDeviceFeatures _enabledFeatures{};
+    bool _memoryBudgetSupported = false;
 
     VkSampleCountFlagBits _msaaSamples;
     
@@ -168,6 +200,13 @@ private:
     
     VkQueue graphicsQueue;
     VkQueue presentQueue;
+    VkQueue transferQueue;
+    VkQueue computeQueue;
+    uint32_t graphicsFamily;
+    uint32_t transferFamily;
+    uint32_t computeFamily;
+
+    std::unique_ptr<VulkanUploader> uploader;
 
     VkDebugUtilsMessengerEXT debugMessenger; 
  
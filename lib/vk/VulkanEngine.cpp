@@ -5,11 +5,16 @@
 #include "VulkanShader.hpp"
 #include "VulkanImage.hpp"
 #include "VulkanUbo.hpp"
+#include "VulkanGpuTimer.hpp"
+#include "VulkanUploader.hpp"
 #include "vk_initializers.h"
 //common lib
 #include <Window.hpp>
 #include "model.hpp"
 //std
+#include <algorithm>
+#include <cstring>
+#include <tuple>
 #include <vector>
 #include <memory>
 
@@ -41,6 +46,7 @@ void alignedFree(void* data)
 VulkanEngine::VulkanEngine(EngineType type) : Engine(type)
 { 
     SPDLOG_DEBUG("constructor");
+    ngn::Profiler::setBackend("vulkan");
     init();
 }
 
@@ -52,10 +58,13 @@ VulkanEngine::~VulkanEngine()
 
 void VulkanEngine::init()
 {
+    // read by the device and the swapchain during their creation
+    display_ = ngn::Display::get();
 
     device_ = std::make_unique<VulkanDevice>(*window_);
     swapchain_ = std::make_unique<VulkanSwapchain>(*device_, *window_);
     image_ =  std::make_unique<VulkanImage>(*device_); 
+    gpuTimer_ = std::make_unique<VulkanGpuTimer>(*device_);
     vulkanUbo_.view = std::make_unique<VulkanUbo>(*device_, sizeof(UniformBufferObject), &uniformBuffer_); 
     canvasUbo = std::make_unique<VulkanUbo>(*device_, sizeof(UniformBufferObject), &uniformBuffer_); 
 
@@ -82,6 +91,7 @@ void VulkanEngine::init()
 
     init_commands();               
 	init_sync_structures();
+    init_frame_graph();
 
     if(ui_Overlay_){
         UIoverlay.windowPtr = window_->getWindowPtr();
@@ -99,6 +109,8 @@ void VulkanEngine::cleanup()
 	}
 
     vkDeviceWaitIdle(device_->getDevice()); 
+    _frameDeletionRing.flush();
+    frameGraph_.reset();
 
     // cleanup_UiOverlay();
     if(ui_Overlay_){
@@ -108,9 +120,10 @@ void VulkanEngine::cleanup()
     _mainDeletionQueue.flush();
 
     // destroy Vulakan resources on Engine
+    // before the shaders, their materials point to them
+    Engine::renderables_.clear();
     Engine::shaders_.clear();
     Engine::fixed_shaders_.clear();
-    Engine::renderables_.clear();
     Engine::fixed_objects_.clear();
 
 
@@ -135,7 +148,8 @@ void VulkanEngine::prepareUniformBuffers()
     if (minUboAlignment > 0) {
         vulkanUbo_.dynamicAlignment = (vulkanUbo_.dynamicAlignment + minUboAlignment - 1) & ~(minUboAlignment - 1);
     }
-    const size_t object_instances = renderables_.size();
+    // at least one slot, objects can all be destroyed and spawned again
+    const size_t object_instances = std::max<size_t>(renderables_.size(), 1);
     size_t bufferSize = object_instances * vulkanUbo_.dynamicAlignment;
 
     uboDataDynamic_.model = (glm::mat4*)alignedAlloc(bufferSize, vulkanUbo_.dynamicAlignment);
@@ -146,6 +160,43 @@ void VulkanEngine::prepareUniformBuffers()
 
     vulkanUbo_.dynamic = std::make_unique<VulkanUbo>(*device_, bufferSize, uboDataDynamic_.model); 
     vulkanUbo_.dynamic->setDescriptorRange(vulkanUbo_.dynamicAlignment);
+    vulkanUbo_.capacity = object_instances;
+}
+
+void VulkanEngine::reserveObjects(size_t count)
+{
+    if(count <= vulkanUbo_.capacity){
+        return;
+    }
+    // doubled, spawning objects one at a time grows the buffer a few times only
+    const size_t capacity = std::max(count, vulkanUbo_.capacity * 2);
+    const size_t bufferSize = capacity * vulkanUbo_.dynamicAlignment;
+    SPDLOG_DEBUG("dynamic ubo grows to {} objects", capacity);
+
+    // the cpu copy is only read by map(), it can go at once.
+    // culled rows are not rewritten before the next upload: they keep their matrices
+    glm::mat4 *model = (glm::mat4*)alignedAlloc(bufferSize, vulkanUbo_.dynamicAlignment);
+    assert(model);
+    std::memcpy(model, uboDataDynamic_.model, vulkanUbo_.capacity * vulkanUbo_.dynamicAlignment);
+    alignedFree(uboDataDynamic_.model);
+    uboDataDynamic_.model = model;
+
+    // buffer and descriptor set can still be used by the frames in flight
+    _frameDeletionRing.push_function(_submittedFrames, [this, oldUbo = std::move(vulkanUbo_.dynamic), oldSet = descriptorSet]() mutable {
+        vkFreeDescriptorSets(device_->getDevice(), descriptorPool, 1, &oldSet);
+        oldUbo.reset();
+    });
+
+    vulkanUbo_.dynamic = std::make_unique<VulkanUbo>(*device_, bufferSize, uboDataDynamic_.model); 
+    vulkanUbo_.dynamic->setDescriptorRange(vulkanUbo_.dynamicAlignment);
+    vulkanUbo_.capacity = capacity;
+    createDescriptorSets();
+}
+
+void VulkanEngine::retire(std::unique_ptr<RenderObject> object)
+{
+    // vertex and index buffers can be read by the frames in flight
+    _frameDeletionRing.push_function(_submittedFrames, [retired = std::move(object)]() mutable { retired.reset(); });
 }
 
 void VulkanEngine::init_sync_structures()
@@ -155,6 +206,7 @@ void VulkanEngine::init_sync_structures()
     _presentSemaphore.resize(MAX_FRAMES_IN_FLIGHT);
     _renderSemaphore.resize(MAX_FRAMES_IN_FLIGHT);
     _renderFence.resize(MAX_FRAMES_IN_FLIGHT);
+    _fenceFrame.assign(MAX_FRAMES_IN_FLIGHT, 0);
 
 	//create syncronization structures
 	//one fence to control when the gpu has finished rendering the frame,
@@ -202,17 +254,108 @@ void VulkanEngine::init_commands()
 }
 
 
+void VulkanEngine::init_frame_graph()
+{
+    using ngn::GraphUsage;
+    frameGraph_ = std::make_unique<VulkanRenderGraph>(*device_);
+    VulkanRenderGraph &graph = *frameGraph_;
+
+    // left as the upscale source by the previous frame, redrawn every frame
+    frameImages_.scene = graph.importImage("scene", VK_IMAGE_ASPECT_COLOR_BIT, GraphUsage::TRANSFER_SRC, GraphUsage::NONE, true);
+    frameImages_.swapchain = graph.importImage("swapchain", VK_IMAGE_ASPECT_COLOR_BIT, GraphUsage::NONE, GraphUsage::PRESENT, true);
+
+    auto scene = graph.addPass("scene", [this](VkCommandBuffer cmd){
+        begin_renderpass(sceneExtent_);
+
+            //initialize the viewport
+            VkViewport viewport = vkinit::viewport(sceneExtent_, 0.0f, 1.0f);
+            VkRect2D scissor = vkinit::rect2D(sceneExtent_, 0, 0);
+            vkCmdSetViewport(cmd, 0, 1, &viewport);
+            vkCmdSetScissor(cmd, 0, 1, &scissor);   
+
+            gpuTimer_->begin(cmd, ngn::GpuPass::OBJECTS);
+                draw_objects(cmd);
+            gpuTimer_->end(cmd, ngn::GpuPass::OBJECTS);
+
+            gpuTimer_->begin(cmd, ngn::GpuPass::FIXED);
+                draw_fixed(cmd);
+            gpuTimer_->end(cmd, ngn::GpuPass::FIXED);
+
+        end_renderpass();
+    });
+    graph.write(scene, frameImages_.scene, GraphUsage::COLOR_ATTACHMENT);
+
+    auto upscale = graph.addPass("upscale", [this](VkCommandBuffer cmd){
+        gpuTimer_->begin(cmd, ngn::GpuPass::UPSCALE);
+            swapchain_->upscale(cmd, swapchainImageIndex_, sceneExtent_);
+        gpuTimer_->end(cmd, ngn::GpuPass::UPSCALE);
+    });
+    graph.read(upscale, frameImages_.scene, GraphUsage::TRANSFER_SRC);
+    graph.write(upscale, frameImages_.swapchain, GraphUsage::TRANSFER_DST);
+
+    // always recorded, the overlay is blended over the upscaled scene
+    auto ui = graph.addPass("ui", [this](VkCommandBuffer cmd){
+        begin_ui_renderpass();
+
+            if(ui_Overlay_ && frame_->ui.get()){
+                updateMemoryBudget();
+                gpuTimer_->begin(cmd, ngn::GpuPass::UIOVERLAY);
+                    UIoverlay.draw(cmd, frame_->ui.get());
+                gpuTimer_->end(cmd, ngn::GpuPass::UIOVERLAY);
+            }
+
+        end_renderpass();
+    });
+    graph.read(ui, frameImages_.swapchain, GraphUsage::COLOR_ATTACHMENT);
+    graph.write(ui, frameImages_.swapchain, GraphUsage::COLOR_ATTACHMENT);
+
+    graph.compile();
+}
+
 void VulkanEngine::resizeFrame()
 {
     swapchain_->recreateSwapChain(); 
 }
 
+void VulkanEngine::applyDisplay()
+{
+    const ngn::DisplayState display = ngn::Display::get();
+    if(display == display_){
+        return;
+    }
+    const bool samplesChanged = display.samples != display_.samples;
+    const bool presentChanged = display.presentMode != display_.presentMode || display.vsync != display_.vsync;
+    display_ = display;
+
+    if(samplesChanged){
+        device_->setMsaaValue(static_cast<VkSampleCountFlagBits>(display_.samples));
+    }
+    // a new swapchain comes with new scene targets
+    if(presentChanged){
+        swapchain_->recreateSwapChain();
+    }else{
+        swapchain_->recreateSceneTargets();
+    }
+    // the ui pass is single sampled whatever the samples, only the scene pipelines follow
+    if(samplesChanged){
+        for(auto *shaders : {&shaders_, &fixed_shaders_}){
+            for(auto &[name, shader] : *shaders){
+                static_cast<VulkanShader&>(*shader).recreatePipelines();
+            }
+        }
+    }
+}
+
 void VulkanEngine::begin_frame()
 {
+    applyDisplay();
 
 	//wait until the gpu has finished rendering the last frame. Timeout of 1 second
 	VK_CHECK_RESULT(vkWaitForFences(device_->getDevice(), 1, &_renderFence[_currentFrame], true, 1000000000) );
 	VK_CHECK_RESULT(vkResetFences(device_->getDevice(), 1, &_renderFence[_currentFrame]) );
+    // every frame up to the one of this fence is complete
+    _frameDeletionRing.flush(_fenceFrame[_currentFrame]);
+    device_->getUploader().collect(_fenceFrame[_currentFrame]);
 
 	//now that we are sure that the commands finished executing, we can safely reset the command buffer to begin recording again.
 	VK_CHECK_RESULT(vkResetCommandBuffer(_mainCommandBuffer[_currentFrame], /*VkCommandBufferResetFlagBits*/ 0));
@@ -229,6 +372,15 @@ void VulkanEngine::begin_frame()
 	VkCommandBufferBeginInfo cmdBeginInfo = vkinit::command_buffer_begin_info(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
 
 	VK_CHECK_RESULT(vkBeginCommandBuffer(_mainCommandBuffer[_currentFrame], &cmdBeginInfo)); 
+
+    // read back old gpu timings and reset the queries outside of the render pass
+    gpuTimer_->reset(_mainCommandBuffer[_currentFrame]);
+
+    // uploads requested since the last frame are copied on the transfer queue,
+    // this frame takes the previous copies over before drawing
+    VulkanUploader &uploader = device_->getUploader();
+    uploader.submit();
+    uploader.acquire(_mainCommandBuffer[_currentFrame], _submittedFrames + 1);
 }
 
 void VulkanEngine::end_frame()
@@ -241,15 +393,23 @@ void VulkanEngine::end_frame()
 	//we will signal the _renderSemaphore, to signal that rendering has finished
 
 	VkSubmitInfo submit = vkinit::submit_info(&_mainCommandBuffer[_currentFrame]);
-	VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-
-	submit.pWaitDstStageMask = &waitStage;
-	submit.pWaitSemaphores = &_presentSemaphore[_currentFrame];
+	// the upscale blit is the first write to the swapchain image
+	_waitSemaphores.assign(1, _presentSemaphore[_currentFrame]);
+	_waitStages.assign(1, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT);
+	// copies taken over by this frame, only its transfer work waits for them
+	VulkanUploader &uploader = device_->getUploader();
+	_waitSemaphores.insert(_waitSemaphores.end(), uploader.getWaitSemaphores().begin(), uploader.getWaitSemaphores().end());
+	_waitStages.insert(_waitStages.end(), uploader.getWaitStages().begin(), uploader.getWaitStages().end());
+
+	submit.waitSemaphoreCount = static_cast<uint32_t>(_waitSemaphores.size());
+	submit.pWaitDstStageMask = _waitStages.data();
+	submit.pWaitSemaphores = _waitSemaphores.data();
 	submit.pSignalSemaphores = &_renderSemaphore[_currentFrame];
 
 	//submit command buffer to the queue and execute it.
 	// _renderFence will now block until the graphic commands finish execution
 	VK_CHECK_RESULT(vkQueueSubmit(device_->getPresentQueue(), 1, &submit, _renderFence[_currentFrame]));
+    _fenceFrame[_currentFrame] = ++_submittedFrames;
 
 	//prepare present
 	// this will put the image we just rendered to into the visible window.
@@ -270,14 +430,14 @@ void VulkanEngine::end_frame()
 	_currentFrame = (_currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;    
 }
 
-void VulkanEngine::begin_renderpass()
+void VulkanEngine::begin_renderpass(VkExtent2D sceneExtent)
 {
-        //start the main renderpass. 
-        //We will use the clear color from above, and the framebuffer of the index the swapchain gave us
+        //start the scene renderpass, only the scaled rect is drawn.
+        //We will use the clear color from above, the scene framebuffer is upscaled to the swapchain image later
         VkRenderPassBeginInfo rpInfo = vkinit::renderpass_begin_info(
                                                 swapchain_->getRenderpass(), 
-                                                swapchain_->getExtent(), 
-                                                swapchain_->getFramebuffer(swapchainImageIndex_)
+                                                sceneExtent, 
+                                                swapchain_->getSceneFramebuffer()
                                                 );
         // set the background color       
         std::array<VkClearValue, 2> clearValues{};
@@ -292,34 +452,45 @@ void VulkanEngine::begin_renderpass()
     vkCmdBeginRenderPass(_mainCommandBuffer[_currentFrame], &rpInfo, VK_SUBPASS_CONTENTS_INLINE);
 }
 
+void VulkanEngine::begin_ui_renderpass()
+{
+    // loads the upscaled scene, nothing to clear
+    VkRenderPassBeginInfo rpInfo = vkinit::renderpass_begin_info(
+                                            swapchain_->getUiRenderpass(), 
+                                            swapchain_->getExtent(), 
+                                            swapchain_->getUiFramebuffer(swapchainImageIndex_)
+                                            );
+    vkCmdBeginRenderPass(_mainCommandBuffer[_currentFrame], &rpInfo, VK_SUBPASS_CONTENTS_INLINE);
+}
+
 void VulkanEngine::end_renderpass()
 {
     //finalize the render pass
     vkCmdEndRenderPass(_mainCommandBuffer[_currentFrame]);
 }
 
+void VulkanEngine::newUiFrame()
+{
+    UIoverlay.newFrame();
+}
+
 void VulkanEngine::draw()
 {
 
     begin_frame();
-    begin_renderpass();
+    // objects spawned since the last frame
+    reserveObjects(renderables_.size());
 
-            //initialize the viewport
-            VkViewport viewport = vkinit::viewport(swapchain_->getExtent(), 0.0f, 1.0f);
-            VkRect2D scissor = vkinit::rect2D(swapchain_->getExtent(), 0, 0);
-            vkCmdSetViewport(_mainCommandBuffer[_currentFrame], 0, 1, &viewport);
-            vkCmdSetScissor(_mainCommandBuffer[_currentFrame], 0, 1, &scissor);   
-
-            draw_objects(_mainCommandBuffer[_currentFrame]);
-            draw_fixed(_mainCommandBuffer[_currentFrame]);
-
-            if(ui_Overlay_){
-                UIoverlay.newFrame();
-                        Engine::draw_UiOverlay();
-                UIoverlay.draw(_mainCommandBuffer[_currentFrame]);
-            }
+    // the scene is drawn at the scale chosen from the latest gpu timings
+    ngn::Profiler::setRenderScale(resolution_.update(ngn::Profiler::getGpuFrameTime()));
+    const VkExtent2D extent = swapchain_->getExtent();
+    std::tie(sceneExtent_.width, sceneExtent_.height) = resolution_.scaled(extent.width, extent.height);
+
+    // both handles change with the swapchain and the scene targets
+    frameGraph_->setImage(frameImages_.scene, swapchain_->getSceneImage());
+    frameGraph_->setImage(frameImages_.swapchain, swapchain_->getSwapchainImage(swapchainImageIndex_));
+    frameGraph_->execute(_mainCommandBuffer[_currentFrame]);
 
-    end_renderpass();
     end_frame();
 
 }
@@ -329,23 +500,26 @@ void VulkanEngine::draw_objects(VkCommandBuffer cmd)
 
     updateUbo(vulkanUbo_.view.get());
     
-    uint32_t index = 0;
-    for(  auto & ro : renderables_){
-
-        VulkanShader &shader                = static_cast<VulkanShader&>(Engine::getShader(shaders_, ro->shader));
-        VulkanVertexBuffer &vertexbuffer    = static_cast<VulkanVertexBuffer&>(*ro);
+    const auto meshes = renderables_.column<MeshComponent>();
+    const auto materials = renderables_.column<MaterialComponent>();
+    // culled by the main thread, every object keeps its own dynamic ubo slot
+    for(uint32_t index : frame_->visible){
+        VulkanShader &shader                = static_cast<VulkanShader&>(*materials[index]);
+        VulkanVertexBuffer &vertexbuffer    = static_cast<VulkanVertexBuffer&>(*meshes[index]);
 
 
         // Aligned offset
         uint32_t dynamicOffset = index * static_cast<uint32_t>(vulkanUbo_.dynamicAlignment);
 		glm::mat4* modelMat = (glm::mat4*)(((uint64_t)uboDataDynamic_.model + dynamicOffset));
-        *modelMat = ro->objNode.getfinal();
-        index++;
+        *modelMat = frame_->transforms[index];
 
         
         shader.bind(cmd, GLSL::TRIANGLES, &descriptorSet, 1, &dynamicOffset);
         vertexbuffer.draw(cmd);
+        ngn::Profiler::countTriangles(vertexbuffer.getIndexSize() / 3);
     }
+    // after the loop: culled rows keep an old matrix, the visible ones must be this frame's
+    vulkanUbo_.dynamic->map(uboDataDynamic_.model);
 }
 
 void VulkanEngine::draw_fixed(VkCommandBuffer cmd)
@@ -355,7 +529,8 @@ void VulkanEngine::draw_fixed(VkCommandBuffer cmd)
     VulkanShader & shader               = static_cast<VulkanShader&>(Engine::getShader(fixed_shaders_, ro.shader));
     VulkanVertexBuffer &vertexbuffer    = static_cast<VulkanVertexBuffer&>(ro);
     
-    auto[x, y] = window_->extents();
+    const float x = static_cast<float>(frame_->width);
+    const float y = static_cast<float>(frame_->height);
     //set new world origin to bottom left + offset
     float offset = 50; 
     float left   = -offset;
@@ -364,7 +539,7 @@ void VulkanEngine::draw_fixed(VkCommandBuffer cmd)
     float top    = -offset;
 
     UniformBufferObject mvp{};
-    mvp.view = ourCamera.GetViewMatrix();
+    mvp.view = frame_->mvp.view;
     mvp.proj = glm::orthoLH_ZO(left, right, bottom, top, -100.0f, 100.0f);
     canvasUbo->map(&mvp);
 
@@ -395,13 +570,13 @@ void VulkanEngine::createDescriptorSetLayout()
 void VulkanEngine::createDescriptorPool() 
 {
     SPDLOG_TRACE("createDescriptorPool");
-    // FIXME how many descriptor per 
-    // uint32_t size =  static_cast<uint32_t>(swapchain_->getSwapchianImageSize());
+    // the set in use and the ones replaced by reserveObjects() while their frames are in flight
+    const uint32_t maxSets = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT) + 1;
     std::vector<VkDescriptorPoolSize> poolSize =
     {
-        vkinit::descriptorPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1),
-        vkinit::descriptorPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1),
-        vkinit::descriptorPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1)
+        vkinit::descriptorPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, maxSets),
+        vkinit::descriptorPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, maxSets),
+        vkinit::descriptorPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, maxSets)
     };
 
 
@@ -409,7 +584,8 @@ void VulkanEngine::createDescriptorPool()
         vkinit::descriptorPoolCreateInfo(
             static_cast<uint32_t>(poolSize.size()),
             poolSize.data(),
-            1);
+            maxSets);
+    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
 
     VK_CHECK_RESULT(vkCreateDescriptorPool(device_->getDevice(), &poolInfo, nullptr, &descriptorPool));
  
@@ -502,10 +678,25 @@ void VulkanEngine::createCanvasDescriptorSets()
 }
 
 
+void VulkanEngine::updateMemoryBudget()
+{
+    std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets{};
+    std::array<VkMemoryHeapFlags, VK_MAX_MEMORY_HEAPS> flags{};
+    uint32_t heapCount = device_->getHeapBudgets(budgets.data(), flags.data());
+
+    std::array<ngn::HeapBudget, VK_MAX_MEMORY_HEAPS> heaps{};
+    for(uint32_t i = 0; i < heapCount; i++){
+        heaps[i].usage = budgets[i].usage;
+        heaps[i].budget = budgets[i].budget;
+        heaps[i].deviceLocal = (flags[i] & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+    }
+    ngn::Profiler::setHeapBudgets(heaps.data(), heapCount);
+}
+
 void VulkanEngine::updateUbo(VulkanUbo *ubo)
 {
     // update 
-    UniformBufferObject mvp = Engine::getMVP(); 
+    const UniformBufferObject &mvp = frame_->mvp; 
 
     uniformBuffer_.view  = mvp.view;
     uniformBuffer_.proj  = mvp.proj;
@@ -515,5 +706,4 @@ void VulkanEngine::updateUbo(VulkanUbo *ubo)
     uniformBuffer_.proj[1][1] *= -1;
 
     ubo->map(&uniformBuffer_);
-    vulkanUbo_.dynamic->map(uboDataDynamic_.model);
 }
\ No newline at end of file
@@ -3,16 +3,25 @@
 #include "../Engine.hpp"
 #include "vktypes.h"
 #include "VulkanUIOverlay.h"
+#include "VulkanRenderGraph.hpp"
 //common lib
 #include <baseclass.hpp>
+#include <inplace_function.hpp>
+#include <display_settings.hpp>
+//std
+#include <cstdint>
 #include <deque>
+#include <vector>
+
+// no allocation per deletor, captures are stored inline
+using Deletor = ngn::InplaceFunction<void()>;
 
 struct DeletionQueue
 {
-    std::deque<std::function<void()>> deletors;
+    std::deque<Deletor> deletors;
 
-    void push_function(std::function<void()>&& function) {
-        deletors.push_back(function);
+    void push_function(Deletor&& function) {
+        deletors.push_back(std::move(function));
     }
 
     void flush() {
@@ -24,11 +33,50 @@ struct DeletionQueue
     }
 };
 
+/**
+ * @brief DeletionQueue for resources still referenced by frames in flight, one list per fence slot.
+ *        A deletor tagged with the last submitted frame F runs once the fence of F has been waited.
+ *        The frames in flight are distinct modulo the slot count, so the list of F
+ *        only holds deletors of frames already complete when it is flushed.
+ *        Lists keep their capacity, nothing is allocated once they are warm
+ */
+class FrameDeletionRing
+{
+public:
+    explicit FrameDeletionRing(size_t framesInFlight) : slots_(framesInFlight) {}
+
+    void push_function(uint64_t frame, Deletor&& function) {
+        slots_[frame % slots_.size()].push_back(std::move(function));
+    }
+
+    // called after waiting the fence of completedFrame
+    void flush(uint64_t completedFrame) {
+        flushSlot(slots_[completedFrame % slots_.size()]);
+    }
+
+    void flush() {
+        for (auto &slot : slots_) {
+            flushSlot(slot);
+        }
+    }
+
+private:
+    static void flushSlot(std::vector<Deletor> &slot) {
+        for (auto it = slot.rbegin(); it != slot.rend(); it++) {
+            (*it)();
+        }
+        slot.clear();
+    }
+
+    std::vector<std::vector<Deletor>> slots_;
+};
+
 class VulkanDevice;
 class VulkanSwapchain;
 class VulkanShader;
 class VulkanImage;
 class VulkanUbo;
+class VulkanGpuTimer;
 class ShaderBuilder;
 
 class VulkanEngine : public Engine
@@ -40,6 +88,8 @@ public:
 protected:
     void draw() override;
     void resizeFrame() override;
+    void newUiFrame() override;
+    void retire(std::unique_ptr<RenderObject> object) override;
 
 private:
 
@@ -47,11 +97,18 @@ private:
     void init();
     void init_commands();
     void init_sync_structures();
+    // scene, upscale and ui passes, their barriers are computed once
+    void init_frame_graph();
     void cleanup();
 
+    // samples and present mode changed by the command line or the ui
+    void applyDisplay();
     void begin_frame();
     void end_frame();
-    void begin_renderpass();
+    // scene pass of the scaled extent
+    void begin_renderpass(VkExtent2D sceneExtent);
+    // ui pass over the upscaled swapchain image
+    void begin_ui_renderpass();
     void end_renderpass();
 
     void draw_objects(VkCommandBuffer cmd);  
@@ -66,8 +123,11 @@ private:
     void createCanvasDescriptorSets();
 
     void prepareUniformBuffers();
+    // grow the dynamic ubo and its descriptor set to hold count objects
+    void reserveObjects(size_t count);
 
     void updateUbo(VulkanUbo *ubo);
+    void updateMemoryBudget();
 
     VkDescriptorSetLayout descriptorSetLayout;
     VkDescriptorPool descriptorPool;
@@ -81,12 +141,24 @@ private:
     std::unique_ptr<VulkanDevice> device_;
     std::unique_ptr<VulkanSwapchain> swapchain_;
     std::unique_ptr<VulkanImage> image_;
+    std::unique_ptr<VulkanGpuTimer> gpuTimer_;
+    std::unique_ptr<VulkanRenderGraph> frameGraph_;
+    struct {
+        VulkanRenderGraph::ResourceId scene;
+        VulkanRenderGraph::ResourceId swapchain;
+    }frameImages_;
+    // drawn part of the scene image this frame
+    VkExtent2D sceneExtent_{};
     VulkanUIOverlay UIoverlay;
+    // settings the swapchain and the pipelines were created with
+    ngn::DisplayState display_{};
 
     struct {
         std::unique_ptr<VulkanUbo> view;
         std::unique_ptr<VulkanUbo> dynamic;
         size_t dynamicAlignment;
+        // objects the dynamic ubo has room for
+        size_t capacity{0};
     }vulkanUbo_;
 
 
@@ -99,13 +171,20 @@ private:
     uint32_t swapchainImageIndex_;
     
     std::vector<VkSemaphore> _presentSemaphore;
+    // waited by the frame submit: acquire and the uploads taken over, kept to reuse their capacity
+    std::vector<VkSemaphore> _waitSemaphores;
+    std::vector<VkPipelineStageFlags> _waitStages;
     std::vector<VkSemaphore> _renderSemaphore;
 	std::vector<VkFence> _renderFence;
+    // number of the last frame submitted with each fence
+    std::vector<uint64_t> _fenceFrame;
+    uint64_t _submittedFrames{0};
     std::vector<VkCommandPool> _commandPool;
 	std::vector<VkCommandBuffer> _mainCommandBuffer;
 
     //------------------------------------
     DeletionQueue _mainDeletionQueue;
+    FrameDeletionRing _frameDeletionRing{static_cast<size_t>(MAX_FRAMES_IN_FLIGHT)};
 
 };
 
@@ -0,0 +1,145 @@
+#include "VulkanDevice.hpp"
+#include "VulkanGpuTimer.hpp"
+
+VulkanGpuTimer::VulkanGpuTimer(VulkanDevice &device) : device{device}
+{
+    SPDLOG_DEBUG("constructor");
+
+    VkPhysicalDeviceProperties properties = device.getPhysicalDeviceProperties();
+    uint32_t validBits = device.getTimestampValidBits();
+
+    timestampSupported = (validBits > 0) && properties.limits.timestampComputeAndGraphics;
+    statisticsSupported = device.getEnabledFeatures().pipelineStatisticsQuery;
+    timestampPeriod = properties.limits.timestampPeriod;
+    if(validBits > 0 && validBits < 64){
+        timestampMask = (1ull << validBits) - 1;
+    }
+
+    spdlog::info("gpu timestamps {} pipeline statistics {}",
+        timestampSupported ? "enabled" : "unsupported",
+        statisticsSupported ? "enabled" : "unsupported");
+
+    for(uint32_t i = 0; i < QUERY_FRAMES; i++){
+        if(timestampSupported){
+            VkQueryPoolCreateInfo info{};
+            info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+            info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+            info.queryCount = TIMESTAMPS;
+            VK_CHECK_RESULT(vkCreateQueryPool(device.getDevice(), &info, nullptr, &timestampPool[i]));
+        }
+        if(statisticsSupported){
+            VkQueryPoolCreateInfo info{};
+            info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+            info.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+            info.queryCount = ngn::GPU_PASS_COUNT;
+            info.pipelineStatistics =
+                VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+                VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+                VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+            VK_CHECK_RESULT(vkCreateQueryPool(device.getDevice(), &info, nullptr, &statisticsPool[i]));
+        }
+    }
+}
+
+VulkanGpuTimer::~VulkanGpuTimer()
+{
+    SPDLOG_DEBUG("destructor");
+
+    for(uint32_t i = 0; i < QUERY_FRAMES; i++){
+        if(timestampSupported){
+            vkDestroyQueryPool(device.getDevice(), timestampPool[i], nullptr);
+        }
+        if(statisticsSupported){
+            vkDestroyQueryPool(device.getDevice(), statisticsPool[i], nullptr);
+        }
+    }
+}
+
+void VulkanGpuTimer::reset(VkCommandBuffer cmd)
+{
+    currentFrame = (currentFrame + 1) % QUERY_FRAMES;
+
+    // the queries of this slot were recorded QUERY_FRAMES ago: read them before reusing the pool
+    if(pending[currentFrame]){
+        readback(currentFrame);
+    }
+
+    if(timestampSupported){
+        vkCmdResetQueryPool(cmd, timestampPool[currentFrame], 0, TIMESTAMPS);
+    }
+    if(statisticsSupported){
+        vkCmdResetQueryPool(cmd, statisticsPool[currentFrame], 0, ngn::GPU_PASS_COUNT);
+    }
+    pending[currentFrame] = timestampSupported || statisticsSupported;
+}
+
+void VulkanGpuTimer::begin(VkCommandBuffer cmd, ngn::GpuPass pass)
+{
+    uint32_t index = static_cast<uint32_t>(pass);
+
+    if(timestampSupported){
+        vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, timestampPool[currentFrame], 2 * index);
+    }
+    if(statisticsSupported){
+        vkCmdBeginQuery(cmd, statisticsPool[currentFrame], index, 0);
+    }
+}
+
+void VulkanGpuTimer::end(VkCommandBuffer cmd, ngn::GpuPass pass)
+{
+    uint32_t index = static_cast<uint32_t>(pass);
+
+    if(statisticsSupported){
+        vkCmdEndQuery(cmd, statisticsPool[currentFrame], index);
+    }
+    if(timestampSupported){
+        vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, timestampPool[currentFrame], 2 * index + 1);
+    }
+}
+
+void VulkanGpuTimer::readback(uint32_t frame)
+{
+    // each result is followed by its availability value, VK_NOT_READY is not an error here:
+    // unavailable passes are simply skipped until the next readback
+    const VkQueryResultFlags flags = VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT;
+
+    std::array<uint64_t, 2 * TIMESTAMPS> timestamps{};
+    std::array<uint64_t, (STATISTICS + 1) * ngn::GPU_PASS_COUNT> statistics{};
+
+    if(timestampSupported){
+        vkGetQueryPoolResults(device.getDevice(), timestampPool[frame], 0, TIMESTAMPS,
+            sizeof(timestamps), timestamps.data(), 2 * sizeof(uint64_t), flags);
+    }
+    if(statisticsSupported){
+        vkGetQueryPoolResults(device.getDevice(), statisticsPool[frame], 0, ngn::GPU_PASS_COUNT,
+            sizeof(statistics), statistics.data(), (STATISTICS + 1) * sizeof(uint64_t), flags);
+    }
+
+    for(uint32_t i = 0; i < ngn::GPU_PASS_COUNT; i++){
+        ngn::GpuPassStats stats{};
+        bool available = false;
+
+        // [value, availability] for begin and end timestamps
+        const uint64_t *begin = &timestamps[4 * i];
+        const uint64_t *end   = &timestamps[4 * i + 2];
+        if(timestampSupported && begin[1] && end[1]){
+            uint64_t ticks = (end[0] - begin[0]) & timestampMask;
+            stats.timeMs = static_cast<float>(ticks * static_cast<double>(timestampPeriod) / 1000000.0);
+            available = true;
+        }
+
+        // [primitives, vertex invocations, fragment invocations, availability]
+        const uint64_t *stat = &statistics[(STATISTICS + 1) * i];
+        if(statisticsSupported && stat[STATISTICS]){
+            stats.primitives = stat[0];
+            stats.vertexInvocations = stat[1];
+            stats.fragmentInvocations = stat[2];
+            available = true;
+        }
+
+        if(available){
+            ngn::Profiler::setGpuPass(static_cast<ngn::GpuPass>(i), stats);
+        }
+    }
+    pending[frame] = false;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include "vktypes.h"
+//common lib
+#include <profiler.hpp>
+//std
+#include <array>
+
+class VulkanDevice;
+
+/**
+ * @brief Timestamp and pipeline statistics queries around the engine render passes
+ *        Results are read back QUERY_FRAMES frames later, never waiting on the gpu
+ */
+class VulkanGpuTimer
+{
+public:
+    VulkanGpuTimer(VulkanDevice &device);
+    ~VulkanGpuTimer();
+
+    VulkanGpuTimer(const VulkanGpuTimer &) = delete;
+    void operator=(const VulkanGpuTimer &) = delete;
+
+    // must be recorded outside of a render pass
+    void reset(VkCommandBuffer cmd);
+    void begin(VkCommandBuffer cmd, ngn::GpuPass pass);
+    void end(VkCommandBuffer cmd, ngn::GpuPass pass);
+
+private:
+    void readback(uint32_t frame);
+
+    static constexpr uint32_t QUERY_FRAMES = 3;
+    static constexpr uint32_t TIMESTAMPS   = 2 * ngn::GPU_PASS_COUNT;
+    // input assembly primitives, vertex invocations, fragment invocations
+    static constexpr uint32_t STATISTICS   = 3;
+
+    VulkanDevice &device;
+
+    std::array<VkQueryPool, QUERY_FRAMES> timestampPool{};
+    std::array<VkQueryPool, QUERY_FRAMES> statisticsPool{};
+    std::array<bool, QUERY_FRAMES> pending{};
+
+    uint32_t currentFrame{0};
+    bool timestampSupported = false;
+    bool statisticsSupported = false;
+    float timestampPeriod = 1.0f;
+    uint64_t timestampMask = ~0ull;
+};
@@ -1,7 +1,10 @@
 #include "VulkanDevice.hpp"
 #include "VulkanImage.hpp"
+#include "VulkanUploader.hpp"
 #include "vk_initializers.h"
 
+// common lib
+#include <profiler.hpp>
 //lib
 #include <stb_image.h>
 
@@ -27,6 +30,7 @@ VulkanImage::~VulkanImage()
 
     device.destroyVmaImage(textureImage._image, textureImage._allocation);   
     SPDLOG_TRACE("vkDestroy textureImageMemory");
+    ngn::Profiler::addTextureBytes(-static_cast<int64_t>(residentBytes));
 }
 
 
@@ -57,24 +61,6 @@ void VulkanImage::createTexture()
         throw std::runtime_error("failed to load texture image!");
     }
     	
-    //create bufferinfo
-	VkBufferCreateInfo bufferInfo = {};
-	bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-	bufferInfo.pNext = nullptr;
-	bufferInfo.size = imageSize;
-    bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-   	
-    VmaAllocationCreateInfo vmaallocInfo = {};
-	vmaallocInfo.usage = VMA_MEMORY_USAGE_CPU_ONLY;
-
-    //allocate temporary buffer for holding texture data to upload
-	AllocatedBuffer stagingBuffer{};
-    device.createVmaBuffer(bufferInfo, vmaallocInfo, stagingBuffer._buffer, stagingBuffer._allocation, pixels, imageSize );
-
-    // Free up the original pixel array now:
-    stbi_image_free(pixels);
-
-
     VkExtent3D imageExtent;
 	imageExtent.width = static_cast<uint32_t>(texWidth);
 	imageExtent.height = static_cast<uint32_t>(texHeight);
@@ -92,27 +78,26 @@ void VulkanImage::createTexture()
 
     device.createVmaImage(img_info, img_allocinfo, textureImage._image, textureImage._allocation );
 
+    // resident size of the full mip chain
+    for(uint32_t i = 0, w = texWidth, h = texHeight; i < mipLevels; i++, w = std::max(w / 2, 1u), h = std::max(h / 2, 1u)){
+        residentBytes += static_cast<size_t>(w) * h * num_channels;
+    }
+    ngn::Profiler::addTextureBytes(static_cast<int64_t>(residentBytes));
+
     // In orger to generate mipmaps
     // we intend to use the texture image as both the source and destination of a transfer
 
-    // steps
-    // 1) Transition the texture image to VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
-    transitionImageLayout(textureImage._image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-    // 2) Execute the buffer to image copy operation
-    copyBufferToImage(stagingBuffer._buffer, textureImage._image, static_cast<uint32_t>(texWidth), static_cast<uint32_t>(texHeight));
-    
-    // transitioned to VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL while generating mipmaps
-    // This will leave each level of the texture image in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL.
-    //  Each level will be transitioned to VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL after the blit command reading from it is finished.
-
-    // If not mipmap are generated,to be able to start sampling from the texture image in the shader, 
-    //   we need one last transition to prepare it for shader access:
-    // transitionImageLayout(textureImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-    // generateMipmaps(textureImage._image, VK_FORMAT_R8G8B8A8_UNORM,  texWidth, texHeight, mipLevels);
-    generateMipmaps(textureImage._image, VK_FORMAT_R8G8B8A8_UNORM,  texWidth, texHeight, mipLevels);
-
-    // cleaning up the staging buffer
-    device.destroyVmaBuffer(stagingBuffer._buffer, stagingBuffer._allocation);
+    // the transfer queue copies mip 0 from a staging buffer, nothing waits for it here.
+    // The first frame after the copy takes the image over and generates the mipmaps: 
+    // each level is transitioned to VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL after the blit command reading from it is finished.
+    const VkFormat format = VK_FORMAT_R8G8B8A8_UNORM;
+    device.getUploader().uploadImage(textureImage._image, imageExtent, mipLevels, pixels, imageSize, 
+        [this, format, texWidth, texHeight](VkCommandBuffer cmd){
+            generateMipmaps(cmd, textureImage._image, format, texWidth, texHeight, mipLevels);
+        });
+
+    // Free up the original pixel array now, the uploader keeps its copy
+    stbi_image_free(pixels);
 }
 
 void VulkanImage::createTextureImageView() 
@@ -159,97 +144,13 @@ void VulkanImage::createTextureSampler()
 
 }
 
-// move image to be in the right layout
-void VulkanImage::transitionImageLayout(VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout) 
-{
-    VkCommandBuffer commandBuffer = device.beginSingleTimeCommands();
-
-    auto barrier = vkinit::imageMemoryBarrier();
-    barrier.oldLayout = oldLayout;
-    barrier.newLayout = newLayout;
-    barrier.image = image;
-    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    barrier.subresourceRange.baseMipLevel = 0;
-    barrier.subresourceRange.levelCount = mipLevels;
-    barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount = 1;
-
-    VkPipelineStageFlags sourceStage;
-    VkPipelineStageFlags destinationStage;
-
-    // There are two transitions we need to handle:
-    // Undefined → transfer destination: transfer writes that don’t need to wait on anything
-    if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) {
-        barrier.srcAccessMask = 0;
-        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-        destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-    }
-     // Transfer destination → shader reading: shader reads should wait on transfer writes, 
-     //  specifically the shader reads in the fragment shader.
-     else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) {
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-        destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-    } else {
-        spdlog::error("unsupported layout transition! file {} line  {}", __FILE__, __LINE__);
-        throw std::invalid_argument("unsupported layout transition!");
-    }
-
-    vkCmdPipelineBarrier(
-        commandBuffer,
-        sourceStage, destinationStage,
-        0,
-        0, nullptr,
-        0, nullptr,
-        1, &barrier
-    );
-
-    device.endSingleTimeCommands(commandBuffer);
-}
-
-void VulkanImage::copyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height) 
-{
-    VkCommandBuffer commandBuffer = device.beginSingleTimeCommands();
-
-    VkBufferImageCopy region{};
-    region.bufferOffset = 0;
-    region.bufferRowLength = 0;
-    region.bufferImageHeight = 0;
-    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    region.imageSubresource.mipLevel = 0;
-    region.imageSubresource.baseArrayLayer = 0;
-    region.imageSubresource.layerCount = 1;
-
-    region.imageOffset = {0, 0, 0};
-    region.imageExtent = {
-        width,
-        height,
-        1
-    };
-
-    vkCmdCopyBufferToImage(
-        commandBuffer,
-        buffer,
-        image,
-        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-        1,
-        &region
-    );
-
-    device.endSingleTimeCommands(commandBuffer);
-}
-
-
-void VulkanImage::generateMipmaps(VkImage image, const VkFormat imageFormat, int32_t texWidth, int32_t texHeight, uint32_t mipLevels) {
+void VulkanImage::generateMipmaps(VkCommandBuffer commandBuffer, VkImage image, const VkFormat imageFormat, int32_t texWidth, int32_t texHeight, uint32_t mipLevels) {
  
     SPDLOG_TRACE("generateMipmaps");
  
     if (!device.findSupportedFormat({imageFormat}, VK_IMAGE_TILING_OPTIMAL, VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)){
         spdlog::error("texture image format does not support linear blitting!");
     }
-    
-    VkCommandBuffer commandBuffer = device.beginSingleTimeCommands();
 
     auto barrier = vkinit::imageMemoryBarrier();
     barrier.image = image;
@@ -347,9 +248,6 @@ void VulkanImage::generateMipmaps(VkImage image, const VkFormat imageFormat, int
         0, nullptr,
         0, nullptr,
         1, &barrier);
-
-
-    device.endSingleTimeCommands(commandBuffer);
 }
 
 void VulkanImage::setupDescriptor()
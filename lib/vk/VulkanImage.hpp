@@ -20,17 +20,16 @@ private:
     void createTextureImageView();
     void createTextureSampler();
 
-    void transitionImageLayout(VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout); 
-    void generateMipmaps(VkImage image,const VkFormat imageFormat,  int32_t texWidth, int32_t texHeight, uint32_t mipLevels);
+    // recorded on the graphics queue once the upload has copied mip 0
+    void generateMipmaps(VkCommandBuffer commandBuffer, VkImage image,const VkFormat imageFormat,  int32_t texWidth, int32_t texHeight, uint32_t mipLevels);
 
-
-    void copyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height);
     void setupDescriptor();
     
     VulkanDevice &device;
     std::string texpath{};  
 
     uint32_t mipLevels;
+    size_t residentBytes{0};
 
     AllocatedImage textureImage;
 
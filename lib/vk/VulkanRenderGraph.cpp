@@ -0,0 +1,225 @@
+#include "VulkanDevice.hpp"
+#include "VulkanRenderGraph.hpp"
+#include "vk_initializers.h"
+//std
+#include <algorithm>
+#include <array>
+#include <map>
+
+namespace
+{
+
+struct UsageInfo
+{
+    VkImageLayout layout;
+    VkPipelineStageFlags stage;
+    VkAccessFlags readAccess;
+    VkAccessFlags writeAccess;
+};
+
+// indexed by ngn::GraphUsage
+constexpr std::array<UsageInfo, static_cast<size_t>(ngn::GraphUsage::COUNT)> usageInfos{{
+    // NONE: the source stage is taken from the destination, chained to the acquire semaphore wait
+    {VK_IMAGE_LAYOUT_UNDEFINED, 0, 0, 0},
+    {VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+        VK_ACCESS_COLOR_ATTACHMENT_READ_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT},
+    {VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT, VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT},
+    {VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+        VK_ACCESS_SHADER_READ_BIT, 0},
+    {VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_ACCESS_TRANSFER_READ_BIT, 0},
+    {VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0, VK_ACCESS_TRANSFER_WRITE_BIT},
+    // the presentation engine waits the render semaphore, no access to make visible
+    {VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0},
+}};
+
+const UsageInfo& info(ngn::GraphUsage usage)
+{
+    return usageInfos[static_cast<size_t>(usage)];
+}
+
+} // namespace
+
+VulkanRenderGraph::VulkanRenderGraph(VulkanDevice &device) : device{device}
+{
+    SPDLOG_DEBUG("constructor");
+}
+
+VulkanRenderGraph::~VulkanRenderGraph()
+{
+    SPDLOG_DEBUG("destructor");
+    destroyTransients();
+}
+
+VulkanRenderGraph::ResourceId VulkanRenderGraph::importImage(std::string name, VkImageAspectFlags aspect, ngn::GraphUsage initial, ngn::GraphUsage final, bool discard)
+{
+    images.push_back({VK_NULL_HANDLE, aspect, {}});
+    return graph.importResource(std::move(name), initial, final, discard);
+}
+
+VulkanRenderGraph::ResourceId VulkanRenderGraph::createImage(std::string name, const VkImageCreateInfo &info, VkImageAspectFlags aspect)
+{
+    images.push_back({VK_NULL_HANDLE, aspect, info});
+    return graph.createTransient(std::move(name));
+}
+
+void VulkanRenderGraph::setImage(ResourceId resource, VkImage image)
+{
+    images.at(resource).image = image;
+}
+
+VulkanRenderGraph::PassId VulkanRenderGraph::addPass(std::string name, Record record, bool sideEffect)
+{
+    records.push_back(std::move(record));
+    return graph.addPass(std::move(name), sideEffect);
+}
+
+void VulkanRenderGraph::compile()
+{
+    graph.compile();
+
+    for(PassId pass = 0; pass < graph.passCount(); pass++){
+        if(graph.culled(pass)){
+            spdlog::info("render graph: pass {} culled", graph.passName(pass));
+        }
+    }
+
+    destroyTransients();
+    createTransients();
+}
+
+void VulkanRenderGraph::createTransients()
+{
+    // images of the same memory types may share an allocation: one heap of the graph each
+    std::map<uint32_t, uint32_t> heaps{};
+    std::vector<uint32_t> heapTypeBits{};
+    std::vector<VkDeviceSize> heapAlignments{};
+    std::vector<ngn::RenderGraph::TransientMemory> transients{};
+    VkDeviceSize transientSize = 0;
+
+    for(const auto &lifetime : graph.lifetimes()){
+        Image &image = images[lifetime.resource];
+        VK_CHECK_RESULT(vkCreateImage(device.getDevice(), &image.info, nullptr, &image.image));
+
+        VkMemoryRequirements requirements;
+        vkGetImageMemoryRequirements(device.getDevice(), image.image, &requirements);
+        auto [found, inserted] = heaps.try_emplace(requirements.memoryTypeBits, static_cast<uint32_t>(heapTypeBits.size()));
+        if(inserted){
+            heapTypeBits.push_back(requirements.memoryTypeBits);
+            heapAlignments.push_back(1);
+        }
+        heapAlignments[found->second] = std::max(heapAlignments[found->second], requirements.alignment);
+        transients.push_back({lifetime.resource, found->second, requirements.size, requirements.alignment});
+        transientSize += requirements.size;
+    }
+
+    // also adds the aliasing transitions to the compiled passes
+    std::vector<uint64_t> offsets{};
+    const std::vector<uint64_t> heapSizes = graph.placeTransients(transients, offsets);
+    VkDeviceSize aliasedSize = 0;
+
+    for(uint32_t heap = 0; heap < heapSizes.size(); heap++){
+        VkMemoryRequirements requirements{};
+        requirements.size = heapSizes[heap];
+        requirements.alignment = heapAlignments[heap];
+        requirements.memoryTypeBits = heapTypeBits[heap];
+        aliasedSize += requirements.size;
+
+        VmaAllocationCreateInfo vmaallocInfo = {};
+        vmaallocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+        vmaallocInfo.requiredFlags = VkMemoryPropertyFlags(VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+        VmaAllocation allocation = VK_NULL_HANDLE;
+        device.allocateVmaMemory(requirements, vmaallocInfo, allocation);
+        memory.push_back(allocation);
+
+        for(size_t i = 0; i < transients.size(); i++){
+            if(transients[i].heap == heap){
+                device.bindVmaImageMemory(allocation, offsets[i], images[transients[i].resource].image);
+            }
+        }
+    }
+
+    if(transientSize > 0){
+        spdlog::info("render graph: transient images {:.2f} MiB aliased in {:.2f} MiB",
+            transientSize / (1024.0 * 1024.0), aliasedSize / (1024.0 * 1024.0));
+    }
+}
+
+void VulkanRenderGraph::destroyTransients()
+{
+    for(ResourceId resource = 0; resource < images.size(); resource++){
+        if(graph.transient(resource) && images[resource].image != VK_NULL_HANDLE){
+            vkDestroyImage(device.getDevice(), images[resource].image, nullptr);
+            images[resource].image = VK_NULL_HANDLE;
+        }
+    }
+    for(auto &allocation : memory){
+        device.freeVmaMemory(allocation);
+    }
+    memory.clear();
+}
+
+void VulkanRenderGraph::execute(VkCommandBuffer cmd)
+{
+    for(const auto &pass : graph.passes()){
+        barrier(cmd, pass.before);
+        records[pass.pass](cmd);
+    }
+    barrier(cmd, graph.finalTransitions());
+}
+
+void VulkanRenderGraph::barrier(VkCommandBuffer cmd, const std::vector<ngn::RenderGraph::Transition> &transitions)
+{
+    if(transitions.empty()){
+        return;
+    }
+    barriers.clear();
+    memoryBarriers.clear();
+    VkPipelineStageFlags srcStage = 0;
+    VkPipelineStageFlags dstStage = 0;
+
+    for(const auto &transition : transitions){
+        const UsageInfo &from = info(transition.from);
+        const UsageInfo &to = info(transition.to);
+
+        // the previous image in the memory keeps its layout, its accesses finish before the new image's transition
+        if(transition.aliasing){
+            VkMemoryBarrier barrier = vkinit::memoryBarrier();
+            barrier.srcAccessMask = transition.fromWrite ? from.writeAccess : 0;
+            barrier.dstAccessMask = to.readAccess | (transition.toWrite ? to.writeAccess : 0);
+            memoryBarriers.push_back(barrier);
+            srcStage |= from.stage;
+            dstStage |= to.stage;
+            continue;
+        }
+
+        VkImageMemoryBarrier barrier = vkinit::imageMemoryBarrier();
+        barrier.image = images[transition.resource].image;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.subresourceRange.aspectMask = images[transition.resource].aspect;
+        barrier.subresourceRange.baseMipLevel = 0;
+        barrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+        // a discarded content skips the layout conversion
+        barrier.oldLayout = transition.discard ? VK_IMAGE_LAYOUT_UNDEFINED : from.layout;
+        barrier.newLayout = to.layout;
+        // only writes must be made available, a read before a write needs the execution dependency
+        barrier.srcAccessMask = transition.fromWrite ? from.writeAccess : 0;
+        barrier.dstAccessMask = to.readAccess | (transition.toWrite ? to.writeAccess : 0);
+        barriers.push_back(barrier);
+
+        srcStage |= transition.from == ngn::GraphUsage::NONE ? to.stage : from.stage;
+        dstStage |= to.stage;
+    }
+
+    vkCmdPipelineBarrier(cmd,
+        srcStage, dstStage, 0,
+        static_cast<uint32_t>(memoryBarriers.size()), memoryBarriers.data(),
+        0, nullptr,
+        static_cast<uint32_t>(barriers.size()), barriers.data());
+}
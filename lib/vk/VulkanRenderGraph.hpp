@@ -0,0 +1,69 @@
+#pragma once
+#include "vktypes.h"
+//common lib
+#include <render_graph.hpp>
+//std
+#include <functional>
+#include <string>
+#include <vector>
+
+class VulkanDevice;
+
+/**
+ * @brief ngn::RenderGraph of Vulkan images: every kept pass is recorded after one batched
+ *        vkCmdPipelineBarrier holding its layout transitions. Transient images of disjoint
+ *        lifetimes are bound to the same vma memory, a memory barrier orders each after the previous user
+ */
+class VulkanRenderGraph
+{
+public:
+    using ResourceId = ngn::RenderGraph::ResourceId;
+    using PassId = ngn::RenderGraph::PassId;
+    // records the pass, outside of any render pass begun by the graph
+    using Record = std::function<void(VkCommandBuffer)>;
+
+    VulkanRenderGraph(VulkanDevice &device);
+    ~VulkanRenderGraph();
+
+    VulkanRenderGraph(const VulkanRenderGraph &) = delete;
+    void operator=(const VulkanRenderGraph &) = delete;
+
+    // owned outside of the graph, the handle may change every frame with setImage()
+    ResourceId importImage(std::string name, VkImageAspectFlags aspect, ngn::GraphUsage initial, ngn::GraphUsage final, bool discard);
+    // created by compile(), the usage flags must cover every usage declared by the passes
+    ResourceId createImage(std::string name, const VkImageCreateInfo &info, VkImageAspectFlags aspect);
+    void setImage(ResourceId resource, VkImage image);
+    VkImage getImage(ResourceId resource) { return images.at(resource).image; }
+
+    PassId addPass(std::string name, Record record, bool sideEffect = false);
+    void read(PassId pass, ResourceId resource, ngn::GraphUsage usage) { graph.read(pass, resource, usage); }
+    void write(PassId pass, ResourceId resource, ngn::GraphUsage usage) { graph.write(pass, resource, usage); }
+
+    // culls the passes, computes the barriers and (re)creates the transient images
+    void compile();
+    void execute(VkCommandBuffer cmd);
+
+private:
+    struct Image
+    {
+        VkImage image = VK_NULL_HANDLE;
+        VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+        // of a transient
+        VkImageCreateInfo info{};
+    };
+
+    void createTransients();
+    void destroyTransients();
+    void barrier(VkCommandBuffer cmd, const std::vector<ngn::RenderGraph::Transition> &transitions);
+
+    VulkanDevice &device;
+    ngn::RenderGraph graph{};
+
+    std::vector<Image> images{};
+    std::vector<Record> records{};
+    // one per memory type of the transients
+    std::vector<VmaAllocation> memory{};
+    // reused by barrier()
+    std::vector<VkImageMemoryBarrier> barriers{};
+    std::vector<VkMemoryBarrier> memoryBarriers{};
+};
@@ -4,6 +4,8 @@
 #include "VulkanImage.hpp"
 #include "VulkanShader.hpp"
 #include "vk_initializers.h"
+// common lib
+#include <profiler.hpp>
 // lib
 // std
 #include <string>
@@ -92,9 +94,19 @@ void VulkanShader::buid()
  {
     vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipeline[mode]);
     vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, descriptorSet, dynamicOffsetCount, pDynamicOffsets);
+    ngn::Profiler::countBinds(2);
  }   
 
 
+void VulkanShader::recreatePipelines()
+{
+    for( auto & pipeline : graphicsPipeline){
+        vkDestroyPipeline(device.getDevice(), pipeline, nullptr);
+    }
+    createPipeline(GLSL::TRIANGLES); 
+    createPipeline(GLSL::LINES); 
+}
+
 void VulkanShader::cleanupPipeline()
 {
     SPDLOG_TRACE("vkDestroyPipeline");
@@ -74,6 +74,8 @@ public:
     ~VulkanShader();
 
     void bind(VkCommandBuffer cmd, GLSL::PolygonMode mode, VkDescriptorSet* descriptorSet, uint32_t dynamicOffsetCount, const uint32_t *pDynamicOffsets);
+    // the scene render pass or its samples changed, layout and modules are kept
+    void recreatePipelines();
 
 private:
 
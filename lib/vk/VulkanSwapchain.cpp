@@ -3,6 +3,7 @@
 #include "vk_initializers.h"
 //common lib
 #include <Window.hpp>
+#include <display_settings.hpp>
 // std
 #include <cstdint> // Necessary for UINT32_MAX
 #include <algorithm> // Necessary for std::min/std::max
@@ -31,9 +32,8 @@ void VulkanSwapchain::createAllSwapchian()
     SPDLOG_TRACE("createAllSwapchian");
     createSwapchain();
     createImageViews();
-    createRenderPass();
-    createColorResources(); // needs only for multisampling
-    createDepthResources();
+    createUiRenderPass();
+    createSceneTargets();
     createFramebuffers();
 
     spdlog::info(" ");
@@ -41,6 +41,8 @@ void VulkanSwapchain::createAllSwapchian()
     spdlog::info("image format    = {}", vks::tools::enumString(swapChainImageFormat) );
     spdlog::info("swapChainImages = {}", swapChainImages.size() );
     spdlog::info("swapChainExtent = {} x {}", swapChainExtent.width, swapChainExtent.height );
+    spdlog::info("present mode    = {}", vks::tools::enumString(presentMode) );
+    spdlog::info("upscale filter  = {}", upscaleFilter == VK_FILTER_LINEAR ? "linear" : "nearest" );
     spdlog::info(" ");
 }
 
@@ -51,14 +53,7 @@ void VulkanSwapchain::cleanupSwapChain()
     }
     SPDLOG_TRACE("vkDestroyFramebuffer");
 
-    vkDestroyImageView(device.getDevice(), colorImageView, nullptr);
-    device.destroyVmaImage(colorImage._image, colorImage._allocation);
-    SPDLOG_TRACE("vkDestroy ColorResources");
- 
-    vkDestroyImageView(device.getDevice(), depthImageView, nullptr);
-	device.destroyVmaImage(depthImage._image, depthImage._allocation);
-    SPDLOG_TRACE("vkDestroy DepthResources");
-
+    cleanupSceneTargets();
 
     for (auto imageView : swapChainImageViews) {
         vkDestroyImageView(device.getDevice(), imageView, nullptr);
@@ -66,7 +61,7 @@ void VulkanSwapchain::cleanupSwapChain()
     SPDLOG_TRACE("vkDestroy swapChainImageViews");
 
 
-    vkDestroyRenderPass(device.getDevice(), renderPass, nullptr);
+    vkDestroyRenderPass(device.getDevice(), uiRenderPass, nullptr);
     SPDLOG_TRACE("vkDestroyRenderPass");
 
     vkDestroySwapchainKHR(device.getDevice(), swapChain, nullptr);
@@ -74,6 +69,44 @@ void VulkanSwapchain::cleanupSwapChain()
 
 }
 
+void VulkanSwapchain::cleanupSceneTargets() 
+{
+    vkDestroyFramebuffer(device.getDevice(), sceneFramebuffer, nullptr);
+
+    vkDestroyImageView(device.getDevice(), sceneImageView, nullptr);
+    device.destroyVmaImage(sceneImage._image, sceneImage._allocation);
+    SPDLOG_TRACE("vkDestroy SceneResources");
+
+    // null without multisampling
+    vkDestroyImageView(device.getDevice(), colorImageView, nullptr);
+    device.destroyVmaImage(colorImage._image, colorImage._allocation);
+    SPDLOG_TRACE("vkDestroy ColorResources");
+ 
+    vkDestroyImageView(device.getDevice(), depthImageView, nullptr);
+	device.destroyVmaImage(depthImage._image, depthImage._allocation);
+    SPDLOG_TRACE("vkDestroy DepthResources");
+
+    vkDestroyRenderPass(device.getDevice(), renderPass, nullptr);
+}
+
+void VulkanSwapchain::createSceneTargets() 
+{
+    createRenderPass();
+    createColorResources(); // needs only for multisampling
+    createDepthResources();
+    createSceneResources();
+    createSceneFramebuffer();
+}
+
+void VulkanSwapchain::recreateSceneTargets() 
+{  
+    SPDLOG_DEBUG("recreateSceneTargets");
+
+    vkDeviceWaitIdle(device.getDevice());
+    cleanupSceneTargets();
+    createSceneTargets();
+}
+
 void VulkanSwapchain::recreateSwapChain() 
 {  
     SPDLOG_DEBUG("recreateSwapChain");
@@ -97,7 +130,7 @@ void VulkanSwapchain::createSwapchain()
     // 1) Surface format (color depth)
     VkSurfaceFormatKHR surfaceFormat = chooseSwapSurfaceFormat(swapChainSupport.formats);
     // 2) Presentation mode (conditions for “swapping” images to the screen)
-    VkPresentModeKHR presentMode = chooseSwapPresentMode(swapChainSupport.presentModes);
+    presentMode = chooseSwapPresentMode(swapChainSupport.presentModes);
     // 3) Swap extent (resolution of images in swap chain)
     VkExtent2D extent = chooseSwapExtent(swapChainSupport.capabilities);
 
@@ -120,7 +153,8 @@ void VulkanSwapchain::createSwapchain()
     createInfo.imageColorSpace = surfaceFormat.colorSpace;
     createInfo.imageExtent = extent;
     createInfo.imageArrayLayers = 1;
-    createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    // the scene is blitted into the image, the ui drawn over it
+    createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
 
     QueueFamilyIndices indices = device.getQueueFamiliesIndices();
     uint32_t queueFamilyIndices[] = {indices.graphicsFamily.value(), indices.presentFamily.value()};
@@ -152,6 +186,11 @@ void VulkanSwapchain::createSwapchain()
 
     swapChainImageFormat = surfaceFormat.format;
     swapChainExtent = extent;
+
+    VkFormatProperties props{};
+    vkGetPhysicalDeviceFormatProperties(device.getPhysicalDevice(), swapChainImageFormat, &props);
+    upscaleFilter = (props.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)
+                  ? VK_FILTER_LINEAR : VK_FILTER_NEAREST;
 }
 
 
@@ -175,11 +214,7 @@ VkPresentModeKHR VulkanSwapchain::chooseSwapPresentMode(const std::vector<VkPres
 {
     // VK_PRESENT_MODE_IMMEDIATE_KHR: 
     //  Images submitted by your application are transferred to the screen right away, which may result in tearing.
-    for (const auto& availablePresentMode : availablePresentModes) {
-        if (availablePresentMode == VK_PRESENT_MODE_IMMEDIATE_KHR) {
-            return availablePresentMode;
-        }
-    }   
+
     // VK_PRESENT_MODE_FIFO_KHR: 
     //  The swap chain is a queue where the display takes an image from the front of the queue when the display is refreshed and the program inserts rendered images at the back of the queue. 
     //  If the queue is full then the program has to wait. This is most similar to vertical sync as found in modern games. 
@@ -195,11 +230,34 @@ VkPresentModeKHR VulkanSwapchain::chooseSwapPresentMode(const std::vector<VkPres
     //  the images that are already queued are simply replaced with the newer ones. 
     //  This mode can be used to render frames as fast as possible while still avoiding tearing, resulting in fewer latency issues than standard vertical sync. 
     //  This is commonly known as “triple buffering”, although the existence of three buffers alone does not necessarily mean that the framerate is unlocked.
-    
-    // loking for VK_PRESENT_MODE_MAILBOX_KHR ,is a very nice trade-off if energy usage is not a concern. 
-    for (const auto& availablePresentMode : availablePresentModes) {
-        if (availablePresentMode == VK_PRESENT_MODE_MAILBOX_KHR) {
-            return availablePresentMode;
+
+    // modes in order of preference, from ngn::Display
+    const ngn::DisplayState display = ngn::Display::get();
+    std::vector<VkPresentModeKHR> preferred{};
+    switch (display.presentMode)
+    {
+    case ngn::PresentMode::IMMEDIATE:
+        preferred = {VK_PRESENT_MODE_IMMEDIATE_KHR};
+        break;
+    case ngn::PresentMode::MAILBOX:
+        preferred = {VK_PRESENT_MODE_MAILBOX_KHR};
+        break;
+    case ngn::PresentMode::FIFO_RELAXED:
+        preferred = {VK_PRESENT_MODE_FIFO_RELAXED_KHR};
+        break;
+    case ngn::PresentMode::FIFO:
+        break;
+    default:
+        // auto: unlocked frame rate unless vsync is asked, mailbox is a very nice trade-off if energy usage is not a concern
+        if(!display.vsync){
+            preferred = {VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_MAILBOX_KHR};
+        }
+        break;
+    }
+
+    for (const auto mode : preferred) {
+        if (std::find(availablePresentModes.begin(), availablePresentModes.end(), mode) != availablePresentModes.end()) {
+            return mode;
         }
     }
 
@@ -207,7 +265,6 @@ VkPresentModeKHR VulkanSwapchain::chooseSwapPresentMode(const std::vector<VkPres
     return VK_PRESENT_MODE_FIFO_KHR;
 }
 
-
 // 3) Swap extent (resolution of images in swap chain)
 VkExtent2D VulkanSwapchain::chooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilities) 
 {    
@@ -249,6 +306,8 @@ void VulkanSwapchain::createRenderPass()
     SPDLOG_TRACE("createRenderPass");
 
     const VkSampleCountFlagBits msaaSamples = device.getMsaaSamples();
+    // single sampled: the scene image is the color attachment, no resolve
+    const bool multisampled = msaaSamples > VK_SAMPLE_COUNT_1_BIT;
 
     // color Attachment description
     VkAttachmentDescription colorAttachment{};
@@ -258,7 +317,8 @@ void VulkanSwapchain::createRenderPass()
     colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
     colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-    colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    // single sampled it is the scene image, moved in and out of the pass by the frame graph
+    colorAttachment.initialLayout = multisampled ? VK_IMAGE_LAYOUT_UNDEFINED : VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 
     //----------------- MSAA ----------------
     // if msaaSamples > VK_SAMPLE_COUNT_1_BIT
@@ -276,8 +336,9 @@ void VulkanSwapchain::createRenderPass()
     colorAttachmentResolve.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
     colorAttachmentResolve.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     colorAttachmentResolve.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-    colorAttachmentResolve.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    colorAttachmentResolve.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    // resolved into the scene image, the frame graph records the barriers around the pass
+    colorAttachmentResolve.initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    colorAttachmentResolve.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 
     // Set the colorAttachmentResolveRef in order 
     // to pass to subpass.pResolveAttachments subpass  member 
@@ -313,7 +374,7 @@ void VulkanSwapchain::createRenderPass()
     subpass.colorAttachmentCount = 1;
     subpass.pColorAttachments = &colorAttachmentRef;
     subpass.pDepthStencilAttachment = &depthAttachmentRef;
-    subpass.pResolveAttachments = &colorAttachmentResolveRef; // MSAA
+    subpass.pResolveAttachments = multisampled ? &colorAttachmentResolveRef : nullptr; // MSAA
 
     //1 dependency, which is from "outside" into the subpass. And we can read or write color
     VkSubpassDependency dependency{};
@@ -333,7 +394,7 @@ void VulkanSwapchain::createRenderPass()
     depth_dependency.dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
     depth_dependency.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
 
-    //array of 2 dependencies, for color and   depth
+    //array of 2 dependencies, for color and depth. The scene image is synchronized by the frame graph
 	std::array<VkSubpassDependency, 2> dependencies = { dependency, depth_dependency };
 
     //array of 3 attachements , for color, depth and colorresolve
@@ -342,7 +403,8 @@ void VulkanSwapchain::createRenderPass()
     // Render pass
     VkRenderPassCreateInfo renderPassInfo{};
     renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-    renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+    // the resolve attachment is last
+    renderPassInfo.attachmentCount = multisampled ? 3 : 2;
     renderPassInfo.pAttachments = attachments.data();
     renderPassInfo.subpassCount = 1;
     renderPassInfo.pSubpasses = &subpass;
@@ -352,23 +414,75 @@ void VulkanSwapchain::createRenderPass()
     VK_CHECK_RESULT(vkCreateRenderPass(device.getDevice(), &renderPassInfo, nullptr, &renderPass) );
 }
 
+void VulkanSwapchain::createUiRenderPass() 
+{
+    SPDLOG_TRACE("createUiRenderPass");
+
+    // swapchain image written by the upscale, the ui is blended over it.
+    // The frame graph moves it in from the blit and out to the present layout
+    VkAttachmentDescription colorAttachment{};
+    colorAttachment.format = swapChainImageFormat;
+    colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    colorAttachment.initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+    VkAttachmentReference colorAttachmentRef{};
+    colorAttachmentRef.attachment = 0;
+    colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+    VkSubpassDescription subpass{};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachmentCount = 1;
+    subpass.pColorAttachments = &colorAttachmentRef;
+
+    VkRenderPassCreateInfo renderPassInfo{};
+    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    renderPassInfo.attachmentCount = 1;
+    renderPassInfo.pAttachments = &colorAttachment;
+    renderPassInfo.subpassCount = 1;
+    renderPassInfo.pSubpasses = &subpass;
+    renderPassInfo.dependencyCount = 0;
+    renderPassInfo.pDependencies = nullptr;
+
+    VK_CHECK_RESULT(vkCreateRenderPass(device.getDevice(), &renderPassInfo, nullptr, &uiRenderPass) );
+}
+
+void VulkanSwapchain::createSceneFramebuffer() 
+{   
+    SPDLOG_TRACE("createSceneFramebuffer");
+
+    // the scene is drawn once per frame whatever the swapchain image
+    VkFramebufferCreateInfo framebufferInfo = vkinit::framebuffer_create_info(renderPass, swapChainExtent);
+    std::array<VkImageView, 3> attachments = {
+            colorImageView,
+            depthImageView,
+            sceneImageView
+    };
+    if (device.getMsaaSamples() == VK_SAMPLE_COUNT_1_BIT) {
+        attachments = {sceneImageView, depthImageView, VK_NULL_HANDLE};
+    }
+
+    framebufferInfo.attachmentCount = device.getMsaaSamples() == VK_SAMPLE_COUNT_1_BIT ? 2 : 3;
+    framebufferInfo.pAttachments = attachments.data();
+
+    VK_CHECK_RESULT(vkCreateFramebuffer(device.getDevice(), &framebufferInfo, nullptr, &sceneFramebuffer) );
+}
+
 void VulkanSwapchain::createFramebuffers() 
 {   
     SPDLOG_TRACE("createFramebuffers");
 
     swapChainFramebuffers.resize(swapChainImageViews.size());
 
-    VkFramebufferCreateInfo framebufferInfo = vkinit::framebuffer_create_info(renderPass, swapChainExtent);
+    VkFramebufferCreateInfo framebufferInfo = vkinit::framebuffer_create_info(uiRenderPass, swapChainExtent);
 
     for (size_t i = 0; i < swapChainImageViews.size(); i++) {
-        std::array<VkImageView, 3> attachments = {
-                colorImageView,
-                depthImageView,
-                swapChainImageViews[i]
-        };
-
-        framebufferInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
-        framebufferInfo.pAttachments = attachments.data();
+        framebufferInfo.attachmentCount = 1;
+        framebufferInfo.pAttachments = &swapChainImageViews[i];
 
         VK_CHECK_RESULT(vkCreateFramebuffer(device.getDevice(), &framebufferInfo, nullptr, &swapChainFramebuffers[i]) );
     }
@@ -381,6 +495,11 @@ void VulkanSwapchain::createColorResources()
 
     VkFormat colorFormat = swapChainImageFormat;
     const VkSampleCountFlagBits msaaSamples = device.getMsaaSamples();
+    if (msaaSamples == VK_SAMPLE_COUNT_1_BIT) {
+        colorImage = {};
+        colorImageView = VK_NULL_HANDLE;
+        return;
+    }
 
     // In case of multisampling ,only one mip level, this is enforced by the Vulkan specification 
     const uint32_t mipmap_one = 1;
@@ -409,6 +528,33 @@ void VulkanSwapchain::createColorResources()
     VK_CHECK_RESULT(vkCreateImageView(device.getDevice(), &viewInfo, nullptr, &colorImageView));   
 }
 
+void VulkanSwapchain::createSceneResources() 
+{
+    SPDLOG_TRACE("createSceneResources");
+
+    // at the swapchain size: a scale change only moves the drawn rect
+    const uint32_t mipmap_one = 1;
+    VkExtent3D extent = {swapChainExtent.width, swapChainExtent.height, 1};
+    VkImageCreateInfo imageInfo = vkinit::image_create_info(
+                swapChainImageFormat,
+                VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, 
+                extent, VK_SAMPLE_COUNT_1_BIT, mipmap_one);
+
+	VmaAllocationCreateInfo allocinfo = {};
+    allocinfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+	allocinfo.requiredFlags = VkMemoryPropertyFlags(VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT); 
+
+    device.createVmaImage(imageInfo, allocinfo, sceneImage._image, sceneImage._allocation );
+
+    VkImageViewCreateInfo viewInfo = vkinit::imageview_create_info(
+        swapChainImageFormat, 
+        sceneImage._image, 
+        VK_IMAGE_ASPECT_COLOR_BIT, 
+        mipmap_one);
+
+    VK_CHECK_RESULT(vkCreateImageView(device.getDevice(), &viewInfo, nullptr, &sceneImageView));   
+}
+
 void VulkanSwapchain::createDepthResources() 
 {
     SPDLOG_TRACE("createDepthResources");
@@ -442,6 +588,27 @@ void VulkanSwapchain::createDepthResources()
 }
 
 
+void VulkanSwapchain::upscale(VkCommandBuffer cmd, uint32_t imageIndex, VkExtent2D sceneExtent)
+{
+    VkImageBlit blit{};
+    blit.srcOffsets[0] = { 0, 0, 0 };
+    blit.srcOffsets[1] = { static_cast<int32_t>(std::min(sceneExtent.width, swapChainExtent.width)),
+                           static_cast<int32_t>(std::min(sceneExtent.height, swapChainExtent.height)), 1 };
+    blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    blit.srcSubresource.mipLevel = 0;
+    blit.srcSubresource.baseArrayLayer = 0;
+    blit.srcSubresource.layerCount = 1;
+    blit.dstOffsets[0] = { 0, 0, 0 };
+    blit.dstOffsets[1] = { static_cast<int32_t>(swapChainExtent.width), static_cast<int32_t>(swapChainExtent.height), 1 };
+    blit.dstSubresource = blit.srcSubresource;
+
+    vkCmdBlitImage(cmd,
+        sceneImage._image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        swapChainImages[imageIndex], VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        1, &blit,
+        upscaleFilter);
+}
+
 VkResult VulkanSwapchain::acquireNextImage(VkSemaphore presentCompleteSemaphore, uint32_t *imageIndex)
 {
 	// By setting timeout to UINT64_MAX we will always wait until the next image has been acquired or an actual error is thrown
@@ -14,22 +14,45 @@ public:
 
     // getters
     VkExtent2D getExtent(){ return swapChainExtent;}
+    // scene pass, drawn at the scaled extent in the top left of the scene image
     VkRenderPass getRenderpass() { return renderPass; }
-    VkFramebuffer getFramebuffer(size_t index) { return swapChainFramebuffers[index];}
+    VkFramebuffer getSceneFramebuffer() { return sceneFramebuffer; }
+    // recreated with the scene targets, set in the frame graph every frame
+    VkImage getSceneImage() { return sceneImage._image; }
+    VkImage getSwapchainImage(size_t index) { return swapChainImages[index]; }
+    // single sampled pass over the upscaled swapchain image, its content is loaded
+    VkRenderPass getUiRenderpass() { return uiRenderPass; }
+    VkFramebuffer getUiFramebuffer(size_t index) { return swapChainFramebuffers[index];}
     size_t getSwapchianImageSize() { return swapChainImages.size(); }
     VkResult acquireNextImage(VkSemaphore presentCompleteSemaphore, uint32_t *imageIndex);
     VkResult queuePresent(VkQueue queue, uint32_t imageIndex, VkSemaphore waitSemaphore);
 
     void recreateSwapChain();
+    // samples changed: scene pass and attachments only, the pipelines must be recreated with the new pass
+    void recreateSceneTargets();
+
+    /**
+     * @brief Stretch the scene rect over the swapchain image. The scene image must be in
+     *        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL and the swapchain image in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+     *        both scene and ui pass leave their attachments in VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
+     *
+     * @param sceneExtent drawn part of the scene image, at most getExtent()
+     */
+    void upscale(VkCommandBuffer cmd, uint32_t imageIndex, VkExtent2D sceneExtent);
 
 private:
     void cleanupSwapChain();
+    void cleanupSceneTargets();
+    void createSceneTargets();
     void createAllSwapchian();
     void createSwapchain();
     void createImageViews();
     void createRenderPass();
+    void createUiRenderPass();
     void createFramebuffers();
+    void createSceneFramebuffer();
     void createColorResources();
+    void createSceneResources();
     void createDepthResources();
 
 
@@ -43,20 +66,29 @@ private:
 
     VkSwapchainKHR swapChain;
     VkExtent2D swapChainExtent;
+    VkPresentModeKHR presentMode;
 
     VkRenderPass renderPass;
+    VkRenderPass uiRenderPass;
 
     std::vector<VkImage> swapChainImages;
     std::vector<VkImageView> swapChainImageViews;
     VkFormat swapChainImageFormat;
 
+    // of the ui pass, one per swapchain image
     std::vector<VkFramebuffer> swapChainFramebuffers;
+    VkFramebuffer sceneFramebuffer;
+    // linear when the format supports filtered blits
+    VkFilter upscaleFilter = VK_FILTER_LINEAR;
 
     VkImageView colorImageView;
     VkImageView depthImageView;    
+    VkImageView sceneImageView;
 
     AllocatedImage colorImage;
     AllocatedImage depthImage;
+    // resolved scene at the swapchain size, source of the upscale
+    AllocatedImage sceneImage;
 };
 
 
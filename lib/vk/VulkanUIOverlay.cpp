@@ -18,8 +18,9 @@ void VulkanUIOverlay::init()
     VkQueue                  g_Queue            = device->getGraphicsQueue();                                 //only grahics Queue
     int                      g_MinImageCount    = device->getSwapChainSupport().capabilities.minImageCount;
     int                      g_ImageCount       = g_MinImageCount + 1;
-    VkRenderPass             g_RenderPass       = swapchain->getRenderpass();
-    VkSampleCountFlagBits    g_MSAASamples      = device->getMsaaSamples();
+    // drawn after the upscale, at full resolution and without multisampling
+    VkRenderPass             g_RenderPass       = swapchain->getUiRenderpass();
+    VkSampleCountFlagBits    g_MSAASamples      = VK_SAMPLE_COUNT_1_BIT;
     auto                     g_CheckVkResultFn  = [](VkResult x){ VK_CHECK_RESULT(x);};            
     VkAllocationCallbacks*   g_Allocator        = NULL;
     VkPipelineCache          g_PipelineCache    = VK_NULL_HANDLE;
@@ -92,12 +93,11 @@ void VulkanUIOverlay::cleanup()
 void VulkanUIOverlay::newFrame()
 {
     // feed inputs to dear imgui, start new frame
-    ImGui_ImplVulkan_NewFrame();
     ImGui_ImplGlfw_NewFrame();
 }
 
-void VulkanUIOverlay::draw(VkCommandBuffer cmd)
+void VulkanUIOverlay::draw(VkCommandBuffer cmd, ImDrawData *drawData)
 {
-    ImDrawData* draw_data = ImGui::GetDrawData();
-    ImGui_ImplVulkan_RenderDrawData(draw_data, cmd);
+    ImGui_ImplVulkan_NewFrame();
+    ImGui_ImplVulkan_RenderDrawData(drawData, cmd);
 }
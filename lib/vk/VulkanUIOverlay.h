@@ -4,6 +4,7 @@
 
 class VulkanSwapchain;
 struct GLFWwindow;
+struct ImDrawData;
 
 class VulkanUIOverlay
 {
@@ -14,8 +15,10 @@ public:
 
     void init();
 
+    // platform new frame, main thread
     void newFrame();
-    void draw(VkCommandBuffer cmd);
+    // render thread
+    void draw(VkCommandBuffer cmd, ImDrawData *drawData);
     void cleanup();
 
 private:
@@ -0,0 +1,206 @@
+#include "VulkanDevice.hpp"
+#include "VulkanUploader.hpp"
+#include "vk_initializers.h"
+//std
+#include <algorithm>
+#include <iterator>
+
+namespace
+{
+
+VkImageMemoryBarrier ownershipBarrier(VkImage image, uint32_t mipLevels, uint32_t srcFamily, uint32_t dstFamily)
+{
+    auto barrier = vkinit::imageMemoryBarrier();
+    barrier.image = image;
+    barrier.srcQueueFamilyIndex = srcFamily;
+    barrier.dstQueueFamilyIndex = dstFamily;
+    // the layout is kept, release and acquire must match
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.baseMipLevel = 0;
+    barrier.subresourceRange.levelCount = mipLevels;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount = 1;
+    return barrier;
+}
+
+} // namespace
+
+VulkanUploader::VulkanUploader(VulkanDevice &device)
+    : device{device}
+    , transferFamily{device.getTransferFamily()}
+    , graphicsFamily{device.getGraphicsFamily()}
+{
+    SPDLOG_DEBUG("constructor");
+
+    VkCommandPoolCreateInfo poolInfo = vkinit::command_pool_create_info(
+        transferFamily, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
+    VK_CHECK_RESULT(vkCreateCommandPool(device.getDevice(), &poolInfo, nullptr, &commandPool));
+
+    spdlog::info("uploads on the {} queue", transferFamily != graphicsFamily ? "dedicated transfer" : "graphics");
+}
+
+VulkanUploader::~VulkanUploader()
+{
+    SPDLOG_DEBUG("destructor");
+
+    // the device is idle, batches never acquired are dropped
+    for(auto &batch : batches){
+        releaseStaging(batch);
+        vkDestroySemaphore(device.getDevice(), batch.semaphore, nullptr);
+    }
+    vkDestroyCommandPool(device.getDevice(), commandPool, nullptr);
+}
+
+VulkanUploader::Batch& VulkanUploader::recordingBatch()
+{
+    for(auto &batch : batches){
+        if(batch.state == State::RECORDING){
+            return batch;
+        }
+    }
+
+    auto found = std::find_if(batches.begin(), batches.end(), [](const Batch &b){ return b.state == State::FREE; });
+    if(found == batches.end()){
+        Batch batch{};
+        VkCommandBufferAllocateInfo allocInfo = vkinit::command_buffer_allocate_info(commandPool, 1);
+        VK_CHECK_RESULT(vkAllocateCommandBuffers(device.getDevice(), &allocInfo, &batch.cmd));
+        VkSemaphoreCreateInfo semaphoreInfo = vkinit::semaphore_create_info();
+        VK_CHECK_RESULT(vkCreateSemaphore(device.getDevice(), &semaphoreInfo, nullptr, &batch.semaphore));
+        batches.push_back(std::move(batch));
+        found = std::prev(batches.end());
+    }
+
+    Batch &batch = *found;
+    VK_CHECK_RESULT(vkResetCommandBuffer(batch.cmd, 0));
+    VkCommandBufferBeginInfo beginInfo = vkinit::command_buffer_begin_info(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    VK_CHECK_RESULT(vkBeginCommandBuffer(batch.cmd, &beginInfo));
+    batch.state = State::RECORDING;
+    return batch;
+}
+
+void VulkanUploader::uploadImage(VkImage image, VkExtent3D extent, uint32_t mipLevels, const void *data, VkDeviceSize size, Finish finish)
+{
+    Batch &batch = recordingBatch();
+
+    VkBufferCreateInfo bufferInfo = vkinit::bufferCreateInfo(VK_BUFFER_USAGE_TRANSFER_SRC_BIT, size);
+    VmaAllocationCreateInfo vmaallocInfo = {};
+    vmaallocInfo.usage = VMA_MEMORY_USAGE_CPU_ONLY;
+
+    AllocatedBuffer stagingBuffer{};
+    device.createVmaBuffer(bufferInfo, vmaallocInfo, stagingBuffer._buffer, stagingBuffer._allocation, data, size);
+    batch.staging.push_back(stagingBuffer);
+
+    // the previous content is discarded, every level is written by the copy or the mipmaps
+    auto barrier = ownershipBarrier(image, mipLevels, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED);
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier(batch.cmd,
+        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+        0, nullptr,
+        0, nullptr,
+        1, &barrier);
+
+    // a whole level satisfies any image transfer granularity of the transfer queue
+    VkBufferImageCopy region{};
+    region.bufferOffset = 0;
+    region.bufferRowLength = 0;
+    region.bufferImageHeight = 0;
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.mipLevel = 0;
+    region.imageSubresource.baseArrayLayer = 0;
+    region.imageSubresource.layerCount = 1;
+    region.imageOffset = {0, 0, 0};
+    region.imageExtent = extent;
+
+    vkCmdCopyBufferToImage(batch.cmd, stagingBuffer._buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+    // release to the graphics family, blits for the mipmaps need a graphics queue
+    if(transferFamily != graphicsFamily){
+        auto release = ownershipBarrier(image, mipLevels, transferFamily, graphicsFamily);
+        release.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        release.dstAccessMask = 0;
+        vkCmdPipelineBarrier(batch.cmd,
+            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0,
+            0, nullptr,
+            0, nullptr,
+            1, &release);
+    }
+
+    batch.images.push_back({image, mipLevels, std::move(finish)});
+}
+
+void VulkanUploader::submit()
+{
+    for(auto &batch : batches){
+        if(batch.state != State::RECORDING){
+            continue;
+        }
+        VK_CHECK_RESULT(vkEndCommandBuffer(batch.cmd));
+
+        VkSubmitInfo submitInfo = vkinit::submit_info(&batch.cmd);
+        submitInfo.waitSemaphoreCount = 0;
+        submitInfo.pSignalSemaphores = &batch.semaphore;
+        VK_CHECK_RESULT(vkQueueSubmit(device.getTransferQueue(), 1, &submitInfo, VK_NULL_HANDLE));
+        batch.state = State::SUBMITTED;
+    }
+}
+
+void VulkanUploader::acquire(VkCommandBuffer cmd, uint64_t frame)
+{
+    waitSemaphores.clear();
+    waitStages.clear();
+
+    for(auto &batch : batches){
+        if(batch.state != State::SUBMITTED){
+            continue;
+        }
+        // the acquire barriers and the mipmap blits wait the copies
+        waitSemaphores.push_back(batch.semaphore);
+        waitStages.push_back(VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+        if(transferFamily != graphicsFamily){
+            barriers.clear();
+            for(const auto &upload : batch.images){
+                auto barrier = ownershipBarrier(upload.image, upload.mipLevels, transferFamily, graphicsFamily);
+                barrier.srcAccessMask = 0;
+                barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+                barriers.push_back(barrier);
+            }
+            // chained to the semaphore wait at the transfer stage
+            vkCmdPipelineBarrier(cmd,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+                0, nullptr,
+                0, nullptr,
+                static_cast<uint32_t>(barriers.size()), barriers.data());
+        }
+
+        for(auto &upload : batch.images){
+            upload.finish(cmd);
+        }
+        batch.images.clear();
+        batch.frame = frame;
+        batch.state = State::ACQUIRED;
+    }
+}
+
+void VulkanUploader::collect(uint64_t completedFrame)
+{
+    // the frame waited the copies, both queues are done with the batch
+    for(auto &batch : batches){
+        if(batch.state == State::ACQUIRED && batch.frame <= completedFrame){
+            releaseStaging(batch);
+            batch.state = State::FREE;
+        }
+    }
+}
+
+void VulkanUploader::releaseStaging(Batch &batch)
+{
+    for(auto &staging : batch.staging){
+        device.destroyVmaBuffer(staging._buffer, staging._allocation);
+    }
+    batch.staging.clear();
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include "vktypes.h"
+//std
+#include <functional>
+#include <vector>
+
+class VulkanDevice;
+
+/**
+ * @brief Texture uploads batched in one command buffer per frame and submitted on the transfer queue.
+ *        The frame taking the images over waits the batch semaphore at the transfer stage and records
+ *        the queue family ownership acquire, nothing waits on the cpu.
+ *        Staging memory is released once that frame is complete
+ */
+class VulkanUploader
+{
+public:
+    // recorded on the graphics queue with mip 0 filled and every level in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+    // must leave the image in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+    using Finish = std::function<void(VkCommandBuffer)>;
+
+    VulkanUploader(VulkanDevice &device);
+    ~VulkanUploader();
+
+    VulkanUploader(const VulkanUploader &) = delete;
+    void operator=(const VulkanUploader &) = delete;
+
+    // data is copied to a staging buffer, the image must stay alive until the copy is taken over
+    void uploadImage(VkImage image, VkExtent3D extent, uint32_t mipLevels, const void *data, VkDeviceSize size, Finish finish);
+
+    // submits the copies recorded since the last call, never waits
+    void submit();
+    // records the graphics side of the submitted batches at the start of frame
+    void acquire(VkCommandBuffer cmd, uint64_t frame);
+    // to be waited by the submit of the frame given to acquire()
+    const std::vector<VkSemaphore>& getWaitSemaphores() { return waitSemaphores; }
+    const std::vector<VkPipelineStageFlags>& getWaitStages() { return waitStages; }
+    // frees the staging buffers of the batches taken over by completedFrame or before
+    void collect(uint64_t completedFrame);
+
+private:
+    enum class State { FREE, RECORDING, SUBMITTED, ACQUIRED };
+
+    struct ImageUpload
+    {
+        VkImage image;
+        uint32_t mipLevels;
+        Finish finish;
+    };
+
+    struct Batch
+    {
+        State state = State::FREE;
+        VkCommandBuffer cmd = VK_NULL_HANDLE;
+        // signaled by the transfer submit, waited by the graphics one
+        VkSemaphore semaphore = VK_NULL_HANDLE;
+        std::vector<AllocatedBuffer> staging{};
+        std::vector<ImageUpload> images{};
+        // frame that acquired the batch
+        uint64_t frame = 0;
+    };
+
+    Batch& recordingBatch();
+    void releaseStaging(Batch &batch);
+
+    VulkanDevice &device;
+    VkCommandPool commandPool;
+    uint32_t transferFamily;
+    uint32_t graphicsFamily;
+
+    std::vector<Batch> batches{};
+    std::vector<VkSemaphore> waitSemaphores{};
+    std::vector<VkPipelineStageFlags> waitStages{};
+    std::vector<VkImageMemoryBarrier> barriers{};
+};
@@ -4,6 +4,7 @@
 //common lib
 #include <vertex.h>
 #include <model.hpp>
+#include <profiler.hpp>
 
 VulkanObjectBuilder::VulkanObjectBuilder(VulkanDevice &device)
 : device{device}
@@ -19,7 +20,6 @@ std::unique_ptr<RenderObject>
 VulkanObjectBuilder::build(Model &model, std::string shadername)
 {
     renderobject->shader = shadername;
-    renderobject->objNode = model.node;
     renderobject->build(model);
     std::unique_ptr<RenderObject> result = std::move(this->renderobject);
     return result;
@@ -34,6 +34,7 @@ void VulkanVertexBuffer::build(Model &model)
 { 
     createIndexBuffer(model);   
     createVertexBuffer(model); 
+    ngn::Profiler::addMeshBytes(static_cast<int64_t>(residentBytes));
 
     prepared = true;  
 }
@@ -42,6 +43,7 @@ VulkanVertexBuffer::~VulkanVertexBuffer()
 {   
     SPDLOG_DEBUG("destructor");
     if(prepared){
+        ngn::Profiler::addMeshBytes(-static_cast<int64_t>(residentBytes));
         device.destroyVmaBuffer(vertexBuffer._buffer, vertexBuffer._allocation);
         SPDLOG_TRACE("Vertex vmaDestroyBuffer");
         device.destroyVmaBuffer(indexBuffer._buffer, indexBuffer._allocation);
@@ -62,6 +64,7 @@ void VulkanVertexBuffer::createVertexBuffer(Model &model)
 
 	//allocate the buffer
 	device.createVmaBuffer(bufferInfo, vmaallocInfo, vertexBuffer._buffer, vertexBuffer._allocation, bufferdata, buffersize);
+    residentBytes += buffersize;
 }
 
 void VulkanVertexBuffer::createIndexBuffer(Model &model)
@@ -79,6 +82,7 @@ void VulkanVertexBuffer::createIndexBuffer(Model &model)
 
 	//allocate the buffer
 	device.createVmaBuffer(bufferInfo, vmaallocInfo, indexBuffer._buffer, indexBuffer._allocation, bufferdata, buffersize);
+    residentBytes += buffersize;
 }
 
 void VulkanVertexBuffer::draw(VkCommandBuffer cmd)
@@ -90,4 +94,7 @@ void VulkanVertexBuffer::draw(VkCommandBuffer cmd)
     vkCmdBindVertexBuffers(cmd, 0, 1, &vertexBuffer._buffer, &offsets);
     vkCmdBindIndexBuffer(cmd, indexBuffer._buffer, 0, VK_INDEX_TYPE_UINT32);       
     vkCmdDrawIndexed(cmd, static_cast<uint32_t>(indices_size), 1, 0, 0, 0);   
+
+    ngn::Profiler::countBinds(2);
+    ngn::Profiler::countDraw();
 }
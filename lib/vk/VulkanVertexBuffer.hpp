@@ -78,6 +78,7 @@ private:
     bool prepared = false;
 
     size_t indices_size;
+    size_t residentBytes{0};
 
     AllocatedBuffer  vertexBuffer;
     AllocatedBuffer  indexBuffer;
@@ -36,6 +36,14 @@ namespace vkinit {
         return imageMemoryBarrier;
     }
 
+    /** @brief Initialize a global memory barrier */
+    inline VkMemoryBarrier memoryBarrier()
+    {
+        VkMemoryBarrier memoryBarrier {};
+        memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        return memoryBarrier;
+    }
+
     // *********** IMAGE  **************//
     // 	
 	inline VkImageCreateInfo image_create_info(
@@ -62,6 +62,21 @@ namespace vks
 				return "UNKNOWN_FORMAT = " + std::to_string(format);
 			}
 		}			
+
+		std::string enumString(VkPresentModeKHR mode)
+		{
+			switch (mode)
+			{
+#define STR(r) case VK_ ##r: return #r
+				STR(PRESENT_MODE_IMMEDIATE_KHR);
+				STR(PRESENT_MODE_MAILBOX_KHR);
+				STR(PRESENT_MODE_FIFO_KHR);
+				STR(PRESENT_MODE_FIFO_RELAXED_KHR);
+#undef STR
+			default:
+				return "UNKNOWN_PRESENT_MODE = " + std::to_string(mode);
+			}
+		}
 	}
 }
 
@@ -35,6 +35,8 @@ namespace vks
 		std::string errorString(VkResult errorCode);
 		/** @brief Returns vkformat enum as a string */
 		std::string enumString(VkFormat format);
+		/** @brief Returns VkPresentModeKHR enum as a string */
+		std::string enumString(VkPresentModeKHR mode);
 	}
 }
 
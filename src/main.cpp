@@ -1,4 +1,12 @@
 #include "main.hpp"
+#include <profiler.hpp>
+#include <program_cache.hpp>
+#include <resolution_scaler.hpp>
+#include <display_settings.hpp>
+#include <utils.hpp>
+#include <scene_file.hpp>
+#include <cstdlib>
+#include <stdexcept>
 #include <string>
 
 
@@ -14,11 +22,82 @@ EngineType parser(int argc, const char** argv)
         eng_type = EngineType::Opengl;
     #endif// OPENGL
 
-    if (argc == 2 && std::string{argv[1]} == "--vulkan"){
-        eng_type = EngineType::Vulkan;
-    }
-    if (argc == 2 && std::string{argv[1]} == "--opengl"){
-        eng_type = EngineType::Opengl;
+    for (int i = 1; i < argc; i++){
+        std::string arg{argv[i]};
+
+        if (arg == "--vulkan"){
+            eng_type = EngineType::Vulkan;
+        }
+        if (arg == "--opengl"){
+            eng_type = EngineType::Opengl;
+        }
+        // --benchmark <file.json> write cpu and gpu frame timings on exit
+        if (arg == "--benchmark" && i + 1 < argc){
+            ngn::Profiler::setBenchmarkOutput(argv[++i]);
+        }
+        // --clear-program-cache start without cached program binaries, with --benchmark the cold startup time
+        if (arg == "--clear-program-cache"){
+            ngn::ProgramCache::clear(ngn::ProgramCache::DIRECTORY);
+        }
+        // --fps-cap <fps> limit the frame rate, 0 unlimited
+        if (arg == "--fps-cap" && i + 1 < argc){
+            const std::string value{argv[++i]};
+            // std::invalid_argument or std::out_of_range, the flag is ignored
+            try{
+                ngn::Time::setFrameLimit(static_cast<uint32_t>(std::stoul(value)));
+            }catch(const std::logic_error &){
+                spdlog::warn("invalid fps cap {}", value);
+            }
+        }
+        // --target-frame-ms <ms> scale the scene resolution to hold the gpu frame time, 0 full resolution
+        if (arg == "--target-frame-ms" && i + 1 < argc){
+            const std::string value{argv[++i]};
+            // std::invalid_argument or std::out_of_range, the flag is ignored
+            try{
+                ngn::ResolutionScaler::setTargetFrameTime(std::stof(value));
+            }catch(const std::logic_error &){
+                spdlog::warn("invalid target frame time {}", value);
+            }
+        }
+        // --msaa <1|2|4|8> samples of the scene target
+        if (arg == "--msaa" && i + 1 < argc){
+            const std::string value{argv[++i]};
+            // std::invalid_argument or std::out_of_range, the flag is ignored
+            try{
+                ngn::Display::setSamples(static_cast<uint32_t>(std::stoul(value)));
+            }catch(const std::logic_error &){
+                spdlog::warn("invalid msaa samples {}", value);
+            }
+        }
+        // --vsync wait for the vertical blank, Opengl swap interval and Vulkan auto present mode
+        if (arg == "--vsync"){
+            ngn::Display::setVsync(true);
+        }
+        // --present-mode <auto|immediate|mailbox|fifo|fifo_relaxed> Vulkan presentation, fifo_relaxed allows Opengl adaptive vsync
+        if (arg == "--present-mode" && i + 1 < argc){
+            const std::string name{argv[++i]};
+            if(auto mode = ngn::Display::parsePresentMode(name)){
+                ngn::Display::setPresentMode(*mode);
+            }else{
+                spdlog::warn("unknown present mode {}", name);
+            }
+        }
+        // --render-thread record and submit the frames on a dedicated thread
+        if (arg == "--render-thread"){
+            Engine::setRenderThread(true);
+        }
+        // --scene <file> load a .json scene or its compiled binary form
+        if (arg == "--scene" && i + 1 < argc){
+            Engine::setScenePath(argv[++i]);
+        }
+        // --compile-scene <in.json> <out> write the binary form and exit
+        if (arg == "--compile-scene" && i + 2 < argc){
+            const std::string input{argv[++i]};
+            const std::string output{argv[++i]};
+            ngn::SceneFile::open(input).save(output);
+            spdlog::info("scene {} compiled to {}", input, output);
+            std::exit(EXIT_SUCCESS);
+        }
     }
 
     return eng_type;
@@ -32,9 +111,8 @@ int main(int argc, char const **argv)
         spdlog::set_level(spdlog::level::info);
     #endif
     
-    EngineType eng_type = parser(argc, argv);
-    
     try {
+        EngineType eng_type = parser(argc, argv);
         auto app = Engine::create(eng_type);
         app->run();
 
@@ -0,0 +1,83 @@
+#include "doctest.h"
+// common lib
+#include <archetype.hpp>
+//std
+#include <memory>
+#include <string>
+
+namespace
+{
+    struct Position
+    {
+        float x{0.0f};
+    };
+
+    using Table = ngn::Archetype<Position, std::string, std::unique_ptr<int>>;
+}
+
+TEST_CASE("Archetype keeps the components of an entity on the same row") {
+  // arrange
+  Table table{};
+
+  // act
+  const ngn::Entity a = table.create({1.0f}, "a", std::make_unique<int>(1));
+  const ngn::Entity b = table.create({2.0f}, "b", std::make_unique<int>(2));
+
+  // assert
+  REQUIRE(table.size() == 2);
+  CHECK(table.alive(a));
+  CHECK(table.alive(b));
+  const uint32_t row = table.row(b);
+  CHECK(table.column<Position>()[row].x == 2.0f);
+  CHECK(table.column<std::string>()[row] == "b");
+  CHECK(*table.column<std::unique_ptr<int>>()[row] == 2);
+  CHECK(table.entity(row).slot == b.slot);
+}
+
+TEST_CASE("Archetype destroy moves the last row into the hole") {
+  // arrange
+  Table table{};
+  const ngn::Entity a = table.create({1.0f}, "a", std::make_unique<int>(1));
+  const ngn::Entity b = table.create({2.0f}, "b", std::make_unique<int>(2));
+  const ngn::Entity c = table.create({3.0f}, "c", std::make_unique<int>(3));
+
+  // act
+  CHECK(table.destroy(a));
+
+  // assert
+  REQUIRE(table.size() == 2);
+  CHECK_FALSE(table.alive(a));
+  CHECK(table.row(a) == Table::NO_ROW);
+  CHECK(table.row(c) == 0);
+  CHECK(table.row(b) == 1);
+  CHECK(table.column<std::string>()[table.row(c)] == "c");
+  CHECK(*table.column<std::unique_ptr<int>>()[table.row(c)] == 3);
+  CHECK(table.column<Position>()[table.row(b)].x == 2.0f);
+  CHECK_FALSE(table.destroy(a));
+}
+
+TEST_CASE("Archetype stale entities don't match a reused slot") {
+  // arrange
+  Table table{};
+  const ngn::Entity a = table.create({1.0f}, "a", nullptr);
+  table.destroy(a);
+
+  // act
+  const ngn::Entity b = table.create({2.0f}, "b", nullptr);
+
+  // assert
+  CHECK(b.slot == a.slot);
+  CHECK(table.alive(b));
+  CHECK_FALSE(table.alive(a));
+  CHECK_FALSE(table.destroy(a));
+  CHECK(table.size() == 1);
+
+  SUBCASE("clear kills every entity"){
+    // act
+    table.clear();
+
+    // assert
+    CHECK(table.empty());
+    CHECK_FALSE(table.alive(b));
+  }
+}
@@ -0,0 +1,178 @@
+#include "doctest.h"
+// common lib
+#include <bvh.hpp>
+//libs
+#include <glm/gtc/matrix_transform.hpp>
+//std
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace
+{
+  std::vector<ngn::Aabb> randomBoxes(size_t count, uint32_t seed = 11)
+  {
+    std::mt19937 rng{seed};
+    std::uniform_real_distribution<float> position{-50.0f, 50.0f};
+    std::uniform_real_distribution<float> size{0.1f, 2.0f};
+
+    std::vector<ngn::Aabb> boxes(count);
+    for(auto &box : boxes){
+      const glm::vec3 p{position(rng), position(rng), position(rng)};
+      box = ngn::Aabb{p, p + glm::vec3(size(rng), size(rng), size(rng))};
+    }
+    return boxes;
+  }
+
+  ngn::Frustum cameraFrustum()
+  {
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 60.0f), glm::vec3(10.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 proj = glm::perspective(glm::radians(45.0f), 1.5f, 1.0f, 80.0f);
+    return ngn::Frustum::fromMatrix(proj * view);
+  }
+
+  std::vector<uint32_t> bruteForce(const ngn::Frustum &frustum, const std::vector<ngn::Aabb> &boxes)
+  {
+    std::vector<uint32_t> items{};
+    for(uint32_t i = 0; i < boxes.size(); i++){
+      if(frustum.intersects(boxes[i])){
+        items.push_back(i);
+      }
+    }
+    return items;
+  }
+
+  // nearest box along the ray by testing all of them
+  ngn::Bvh::Hit bruteForce(const ngn::Ray &ray, const std::vector<ngn::Aabb> &boxes)
+  {
+    ngn::Bvh::Hit hit{};
+    for(uint32_t i = 0; i < boxes.size(); i++){
+      float t = 0.0f;
+      if(ngn::intersect(ray, boxes[i], hit.t, t) && t < hit.t){
+        hit = {i, t};
+      }
+    }
+    return hit;
+  }
+}
+
+TEST_CASE("bvh frustum query matches the linear test") {
+  // arrange
+  auto boxes = randomBoxes(5000);
+  ngn::Bvh bvh{};
+  const ngn::Frustum frustum = cameraFrustum();
+
+  // act
+  bvh.build(boxes.data(), boxes.size());
+  std::vector<uint32_t> items{};
+  bvh.query(frustum, boxes.data(), items);
+  std::sort(items.begin(), items.end());
+
+  // assert
+  CHECK(bvh.size() == boxes.size());
+  CHECK(bvh.root().bounds.valid());
+  auto expected = bruteForce(frustum, boxes);
+  CHECK(!expected.empty());
+  CHECK(items == expected);
+}
+
+TEST_CASE("bvh raycast finds the nearest box") {
+  // arrange
+  auto boxes = randomBoxes(5000);
+  ngn::Bvh bvh{};
+  bvh.build(boxes.data(), boxes.size());
+
+  std::mt19937 rng{5};
+  std::uniform_real_distribution<float> direction{-1.0f, 1.0f};
+  for(int r = 0; r < 64; r++){
+    const ngn::Ray ray{glm::vec3(0.0f, 0.0f, 80.0f), glm::normalize(glm::vec3(direction(rng) * 0.6f, direction(rng) * 0.6f, -1.0f))};
+
+    // act
+    ngn::Bvh::Hit hit = bvh.raycast(ray, 1000.0f, [&](uint32_t item, float tMax){
+      float t = 0.0f;
+      return ngn::intersect(ray, boxes[item], tMax, t) ? t : tMax;
+    });
+
+    // assert
+    ngn::Bvh::Hit expected = bruteForce(ray, boxes);
+    CHECK(hit.item == expected.item);
+    if(hit.item != ngn::Bvh::NO_ITEM){
+      CHECK(hit.t == doctest::Approx(expected.t));
+    }
+  }
+}
+
+TEST_CASE("bvh refit follows moved items") {
+  // arrange
+  auto boxes = randomBoxes(2000);
+  ngn::Bvh bvh{};
+  bvh.build(boxes.data(), boxes.size());
+
+  // move a few items toward the camera
+  std::vector<uint32_t> moved{3, 500, 1999};
+  for(uint32_t item : moved){
+    boxes[item].min += glm::vec3(0.0f, 0.0f, 20.0f);
+    boxes[item].max += glm::vec3(0.0f, 0.0f, 20.0f);
+  }
+
+  // act
+  auto update = bvh.update(boxes.data(), boxes.size(), moved.data(), moved.size());
+
+  // assert
+  CHECK(update == ngn::Bvh::Update::REFIT);
+  std::vector<uint32_t> items{};
+  bvh.query(cameraFrustum(), boxes.data(), items);
+  std::sort(items.begin(), items.end());
+  CHECK(items == bruteForce(cameraFrustum(), boxes));
+}
+
+TEST_CASE("bvh rebuilds when the refitted tree degrades") {
+  // arrange
+  auto boxes = randomBoxes(2000);
+  ngn::Bvh bvh{};
+  bvh.build(boxes.data(), boxes.size());
+  const float built = bvh.cost();
+
+  SUBCASE("shuffled items") {
+    // every item takes the place of another one: the leaves now span the whole scene
+    auto shuffled = boxes;
+    std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937{1});
+    std::vector<uint32_t> moved(boxes.size());
+    for(uint32_t i = 0; i < moved.size(); i++){
+      moved[i] = i;
+    }
+
+    CHECK(bvh.update(shuffled.data(), shuffled.size(), moved.data(), moved.size()) == ngn::Bvh::Update::REBUILD);
+    CHECK(bvh.cost() == doctest::Approx(bvh.buildCost()));
+  }
+  SUBCASE("new item") {
+    boxes.push_back(ngn::Aabb{glm::vec3(0.0f), glm::vec3(1.0f)});
+
+    CHECK(bvh.update(boxes.data(), boxes.size(), nullptr, 0) == ngn::Bvh::Update::REBUILD);
+    CHECK(bvh.size() == boxes.size());
+  }
+  SUBCASE("nothing moved") {
+    CHECK(bvh.update(boxes.data(), boxes.size(), nullptr, 0) == ngn::Bvh::Update::REFIT);
+    CHECK(bvh.cost() == doctest::Approx(built));
+  }
+}
+
+TEST_CASE("ray from the screen center goes along the view direction") {
+  // arrange
+  glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 5.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+  glm::mat4 proj = glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 1.0f, 11.0f);
+
+  // act
+  ngn::Ray center = ngn::Ray::fromScreen({400.0f, 300.0f}, {800.0f, 600.0f}, view, proj);
+  ngn::Ray topLeft = ngn::Ray::fromScreen({0.0f, 0.0f}, {800.0f, 600.0f}, view, proj);
+
+  // assert
+  CHECK(center.origin.z == doctest::Approx(4.0f));
+  CHECK(center.direction.z == doctest::Approx(-1.0f));
+  CHECK(topLeft.direction.x < 0.0f);
+  CHECK(topLeft.direction.y > 0.0f);
+
+  float t = 0.0f;
+  CHECK(ngn::intersect(center, ngn::Aabb{glm::vec3(-0.5f), glm::vec3(0.5f)}, 100.0f, t));
+  CHECK(t == doctest::Approx(3.5f));
+}
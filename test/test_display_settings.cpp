@@ -0,0 +1,54 @@
+#include "doctest.h"
+// common lib
+#include <display_settings.hpp>
+
+TEST_CASE("Display rounds the samples down to a supported count") {
+  // arrange
+  const ngn::DisplayState saved = ngn::Display::get();
+
+  SUBCASE("zero draws single sampled") {
+    // act
+    ngn::Display::setSamples(0);
+    // assert
+    CHECK(ngn::Display::get().samples == 1);
+  }
+  SUBCASE("between two counts") {
+    ngn::Display::setSamples(6);
+    CHECK(ngn::Display::get().samples == 4);
+  }
+  SUBCASE("above the largest count") {
+    ngn::Display::setSamples(64);
+    CHECK(ngn::Display::get().samples == 8);
+  }
+
+  ngn::Display::setSamples(saved.samples);
+}
+
+TEST_CASE("Display present mode names round trip") {
+  for(uint32_t i = 0; i < static_cast<uint32_t>(ngn::PresentMode::COUNT); i++){
+    // arrange
+    auto mode = static_cast<ngn::PresentMode>(i);
+
+    // act
+    auto parsed = ngn::Display::parsePresentMode(ngn::Display::getPresentModeName(mode));
+
+    // assert
+    REQUIRE(parsed.has_value());
+    CHECK(*parsed == mode);
+  }
+  CHECK_FALSE(ngn::Display::parsePresentMode("vsync").has_value());
+}
+
+TEST_CASE("Display state compares the applied settings") {
+  // arrange
+  const ngn::DisplayState saved = ngn::Display::get();
+
+  // act
+  ngn::Display::setVsync(!saved.vsync);
+  const ngn::DisplayState changed = ngn::Display::get();
+  ngn::Display::setVsync(saved.vsync);
+
+  // assert
+  CHECK_FALSE(changed == saved);
+  CHECK(ngn::Display::get() == saved);
+}
@@ -0,0 +1,72 @@
+#include "doctest.h"
+// common lib
+#include <frustum.hpp>
+#include <simd_transform.hpp>
+//libs
+#include <glm/gtc/matrix_transform.hpp>
+//std
+#include <random>
+#include <vector>
+
+namespace
+{
+  // camera at z = 5 looking at the origin, near 1 far 11 as Engine::getMVP
+  ngn::Frustum cameraFrustum()
+  {
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 5.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 proj = glm::perspective(glm::radians(45.0f), 1.0f, 1.0f, 11.0f);
+    return ngn::Frustum::fromMatrix(proj * view);
+  }
+}
+
+TEST_CASE("frustum classifies spheres and boxes") {
+  const ngn::Frustum frustum = cameraFrustum();
+
+  SUBCASE("in front of the camera") {
+    CHECK(frustum.intersects(ngn::Sphere{glm::vec3(0.0f), 0.5f}));
+    CHECK(frustum.intersects(ngn::Aabb{glm::vec3(-0.5f), glm::vec3(0.5f)}));
+  }
+  SUBCASE("behind the camera") {
+    CHECK_FALSE(frustum.intersects(ngn::Sphere{glm::vec3(0.0f, 0.0f, 8.0f), 0.5f}));
+    CHECK_FALSE(frustum.intersects(ngn::Aabb{glm::vec3(-0.5f, -0.5f, 7.5f), glm::vec3(0.5f, 0.5f, 8.5f)}));
+  }
+  SUBCASE("beyond the far plane") {
+    CHECK_FALSE(frustum.intersects(ngn::Sphere{glm::vec3(0.0f, 0.0f, -7.0f), 0.5f}));
+  }
+  SUBCASE("straddling the left plane") {
+    CHECK(frustum.intersects(ngn::Sphere{glm::vec3(-2.2f, 0.0f, 0.0f), 0.5f}));
+    CHECK_FALSE(frustum.intersects(ngn::Sphere{glm::vec3(-4.0f, 0.0f, 0.0f), 0.5f}));
+  }
+}
+
+TEST_CASE("simd cullSpheres matches the scalar test") {
+  // arrange
+  const ngn::Frustum frustum = cameraFrustum();
+  std::mt19937 rng{3};
+  std::uniform_real_distribution<float> position{-8.0f, 8.0f};
+  std::uniform_real_distribution<float> radius{0.05f, 1.0f};
+
+  // not a multiple of the simd width
+  std::vector<ngn::Sphere> spheres(1001);
+  for(auto &sphere : spheres){
+    sphere = ngn::Sphere{glm::vec3(position(rng), position(rng), position(rng)), radius(rng)};
+  }
+  std::vector<uint8_t> visible(spheres.size());
+
+  // act
+  size_t count = ngn::simd::cullSpheres(frustum.planes.data(), spheres.data(), visible.data(), spheres.size());
+
+  // assert
+  size_t expected = 0;
+  size_t wrong = 0;
+  for(size_t i = 0; i < spheres.size(); i++){
+    const bool inside = frustum.intersects(spheres[i]);
+    expected += inside;
+    wrong += inside != (visible[i] != 0);
+  }
+  INFO("isa = ", ngn::simd::isa());
+  CHECK(wrong == 0);
+  CHECK(count == expected);
+  CHECK(count > 0);
+  CHECK(count < spheres.size());
+}
@@ -0,0 +1,71 @@
+#include "doctest.h"
+// common lib
+#include <inplace_function.hpp>
+//std
+#include <memory>
+#include <vector>
+
+namespace
+{
+  // counts the live copies of a capture
+  struct Tracked
+  {
+    int *alive;
+    explicit Tracked(int *counter) : alive{counter} { ++*alive; }
+    Tracked(Tracked &&other) noexcept : alive{other.alive} { ++*alive; }
+    ~Tracked() { --*alive; }
+  };
+}
+
+TEST_CASE("InplaceFunction calls the stored callable") {
+  // arrange
+  int base = 10;
+  ngn::InplaceFunction<int(int)> add = [base](int x){ return base + x; };
+  ngn::InplaceFunction<int(int)> empty{};
+
+  // act
+  int result = add(5);
+
+  // assert
+  CHECK(result == 15);
+  CHECK(static_cast<bool>(add));
+  CHECK_FALSE(static_cast<bool>(empty));
+}
+
+TEST_CASE("InplaceFunction owns move only captures") {
+  // arrange
+  auto value = std::make_unique<int>(7);
+  int *raw = value.get();
+  ngn::InplaceFunction<int()> read = [value = std::move(value)](){ return *value; };
+
+  // act
+  ngn::InplaceFunction<int()> moved = std::move(read);
+
+  // assert
+  CHECK_FALSE(static_cast<bool>(read));
+  CHECK(moved() == 7);
+  CHECK(*raw == 7);
+}
+
+TEST_CASE("InplaceFunction destroys its capture exactly once") {
+  // arrange
+  int alive = 0;
+  {
+    std::vector<ngn::InplaceFunction<void()>> queue{};
+    queue.reserve(1);
+
+    // act
+    queue.emplace_back([tracked = Tracked{&alive}](){});
+    // the vector grows and moves the element
+    queue.emplace_back([](){});
+    CHECK(alive == 1);
+
+    queue.front().reset();
+    CHECK(alive == 0);
+    queue.front() = [tracked = Tracked{&alive}](){};
+    CHECK(alive == 1);
+  }
+
+  // assert
+  CHECK(alive == 0);
+}
@@ -0,0 +1,200 @@
+#include "doctest.h"
+// common lib
+#include <job_system.hpp>
+#include <work_stealing_queue.hpp>
+//std
+#include <atomic>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+TEST_CASE("WorkStealingQueue owner pops LIFO, thieves steal FIFO") {
+  // arrange
+  ngn::WorkStealingQueue<int, 4> queue{};
+  int items[4] = {0, 1, 2, 3};
+
+  // act
+  for(auto &item : items){
+    REQUIRE(queue.push(&item));
+  }
+
+  // assert
+  CHECK(queue.push(&items[0]) == false);
+  CHECK(queue.size() == 4);
+  CHECK(queue.pop() == &items[3]);
+  CHECK(queue.steal() == &items[0]);
+  CHECK(queue.pop() == &items[2]);
+  CHECK(queue.steal() == &items[1]);
+  CHECK(queue.pop() == nullptr);
+  CHECK(queue.steal() == nullptr);
+  CHECK(queue.empty());
+}
+
+TEST_CASE("WorkStealingQueue items are taken exactly once under contention") {
+  // arrange
+  const int COUNT = 100000;
+  const int THIEVES = 3;
+  ngn::WorkStealingQueue<int, 1024> queue{};
+  std::vector<int> items(COUNT);
+  std::vector<std::atomic<int>> taken(COUNT);
+  std::atomic<bool> done{false};
+
+  auto take = [&](int *item){ taken[item - items.data()].fetch_add(1); };
+
+  // act
+  std::vector<std::thread> thieves;
+  for(int i = 0; i < THIEVES; i++){
+    thieves.emplace_back([&]{
+      while(!done.load() || !queue.empty()){
+        if(int *item = queue.steal()){
+          take(item);
+        }
+      }
+    });
+  }
+  for(int i = 0; i < COUNT; i++){
+    while(!queue.push(&items[i])){
+      if(int *item = queue.pop()){
+        take(item);
+      }
+    }
+    if(i % 3 == 0){
+      if(int *item = queue.pop()){
+        take(item);
+      }
+    }
+  }
+  while(int *item = queue.pop()){
+    take(item);
+  }
+  done = true;
+  for(auto &thief : thieves){
+    thief.join();
+  }
+
+  // assert
+  int wrong = 0;
+  for(auto &t : taken){
+    wrong += t.load() != 1;
+  }
+  CHECK(wrong == 0);
+}
+
+TEST_CASE("JobSystem wait returns after every job of the counter has run") {
+  // arrange
+  ngn::JobSystem jobs{3};
+  ngn::JobCounter counter{};
+  std::atomic<int> sum{0};
+
+  // act
+  for(int i = 1; i <= 1000; i++){
+    jobs.run(counter, [&sum, i]{ sum.fetch_add(i); });
+  }
+  jobs.wait(counter);
+
+  // assert
+  CHECK(counter.done());
+  CHECK(sum.load() == 500500);
+}
+
+TEST_CASE("JobSystem without workers runs the jobs on the waiting thread") {
+  // arrange
+  ngn::JobSystem jobs{0};
+  ngn::JobCounter counter{};
+  const auto caller = std::this_thread::get_id();
+  std::atomic<int> foreign{0};
+
+  // act
+  for(int i = 0; i < 100; i++){
+    jobs.run(counter, [&]{ foreign += std::this_thread::get_id() != caller; });
+  }
+  jobs.wait(counter);
+
+  // assert
+  CHECK(jobs.workerCount() == 0);
+  CHECK(foreign.load() == 0);
+}
+
+TEST_CASE("JobSystem jobs can spawn and wait for other jobs") {
+  // arrange
+  ngn::JobSystem jobs{2};
+  ngn::JobCounter outer{};
+  std::atomic<int> leaves{0};
+
+  // act
+  for(int i = 0; i < 16; i++){
+    jobs.run(outer, [&]{
+      ngn::JobCounter inner{};
+      for(int j = 0; j < 16; j++){
+        jobs.run(inner, [&leaves]{ leaves++; });
+      }
+      jobs.wait(inner);
+    });
+  }
+  jobs.wait(outer);
+
+  // assert
+  CHECK(leaves.load() == 256);
+}
+
+TEST_CASE("JobSystem parallel_for visits every index exactly once") {
+  // arrange
+  ngn::JobSystem jobs{3};
+  std::vector<int> visits(100003, 0);
+
+  SUBCASE("explicit grain"){
+    // act
+    jobs.parallel_for(visits.size(), 1000, [&](size_t begin, size_t end){
+      for(size_t i = begin; i < end; i++){
+        visits[i]++;
+      }
+    });
+  }
+  SUBCASE("automatic grain over a span"){
+    // act
+    jobs.parallel_for(std::span<int>(visits), 0, [](std::span<int> chunk){
+      for(auto &v : chunk){
+        v++;
+      }
+    });
+  }
+
+  // assert
+  CHECK(std::accumulate(visits.begin(), visits.end(), 0) == static_cast<int>(visits.size()));
+  CHECK(*std::min_element(visits.begin(), visits.end()) == 1);
+}
+
+TEST_CASE("JobSystem more jobs than the queue capacity still complete") {
+  // arrange
+  ngn::JobSystem jobs{1};
+  ngn::JobCounter counter{};
+  std::atomic<size_t> count{0};
+  const size_t JOBS = 3 * ngn::JobSystem::JOB_CAPACITY;
+
+  // act
+  for(size_t i = 0; i < JOBS; i++){
+    jobs.run(counter, [&count]{ count++; });
+  }
+  jobs.wait(counter);
+
+  // assert
+  CHECK(count.load() == JOBS);
+}
+
+TEST_CASE("JobSystem threads switching between systems keep one queue per system") {
+  // arrange
+  ngn::JobSystem first{0};
+  ngn::JobSystem second{0};
+  int count = 0;
+
+  // act
+  for(size_t i = 0; i < 2 * ngn::JobSystem::MAX_THREADS; i++){
+    ngn::JobSystem &jobs = i % 2 ? second : first;
+    ngn::JobCounter counter{};
+    jobs.run(counter, [&count]{ count++; });
+    jobs.wait(counter);
+  }
+
+  // assert
+  CHECK(count == static_cast<int>(2 * ngn::JobSystem::MAX_THREADS));
+}
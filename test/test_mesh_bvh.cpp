@@ -0,0 +1,91 @@
+#include "doctest.h"
+// common lib
+#include <mesh_bvh.hpp>
+#include <model.hpp>
+//libs
+#include <glm/gtc/matrix_transform.hpp>
+//std
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+namespace
+{
+  // unit sphere made of stacks x slices quads, written as obj and loaded back
+  Model sphereModel(int stacks, int slices)
+  {
+    const auto path = std::filesystem::temp_directory_path() / "ngn_test_mesh_bvh.obj";
+    {
+      std::ofstream obj{path};
+      for(int i = 0; i <= stacks; i++){
+        const float phi = 3.14159265f * i / stacks;
+        for(int j = 0; j < slices; j++){
+          const float theta = 2.0f * 3.14159265f * j / slices;
+          obj << "v " << std::sin(phi) * std::cos(theta) << " " << std::cos(phi) << " " << std::sin(phi) * std::sin(theta) << "\n";
+        }
+      }
+      obj << "vt 0 0\n";
+      for(int i = 0; i < stacks; i++){
+        for(int j = 0; j < slices; j++){
+          const int a = i * slices + j + 1;
+          const int b = i * slices + (j + 1) % slices + 1;
+          obj << "f " << a << "/1 " << b << "/1 " << a + slices << "/1\n";
+          obj << "f " << b << "/1 " << b + slices << "/1 " << a + slices << "/1\n";
+        }
+      }
+    }
+    Model model{path.string().c_str()};
+    std::filesystem::remove(path);
+    return model;
+  }
+}
+
+TEST_CASE("mesh bvh raycast matches the brute force triangle test") {
+  // arrange
+  Model model = sphereModel(32, 48);
+  ngn::MeshBvh mesh{model};
+
+  std::mt19937 rng{9};
+  std::uniform_real_distribution<float> offset{-1.2f, 1.2f};
+
+  size_t hits = 0;
+  for(int r = 0; r < 200; r++){
+    const ngn::Ray ray{glm::vec3(offset(rng), offset(rng), 5.0f), glm::vec3(0.0f, 0.0f, -1.0f)};
+
+    // act
+    ngn::MeshBvh::Hit hit = mesh.raycast(ray, 100.0f);
+
+    // assert
+    float expected = 100.0f;
+    for(size_t i = 0; i + 2 < model.indicesSize(); i += 3){
+      const uint32_t *tri = model.indicesData() + i;
+      float t = 0.0f;
+      if(ngn::intersect(ray, model.verticesData()[tri[0]].pos, model.verticesData()[tri[1]].pos, model.verticesData()[tri[2]].pos, expected, t)){
+        expected = t;
+      }
+    }
+    CHECK(hit.t == doctest::Approx(expected));
+    hits += hit.triangle != ngn::Bvh::NO_ITEM;
+  }
+  CHECK(mesh.triangleCount() == model.indicesSize() / 3);
+  CHECK(hits > 0);
+  CHECK(hits < 200);
+}
+
+TEST_CASE("mesh bvh distances survive the move to model space") {
+  // arrange: the sphere scaled by 2 and moved to x = 3
+  Model model = sphereModel(16, 24);
+  ngn::MeshBvh mesh{model};
+  const glm::mat4 world = glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(3.0f, 0.0f, 0.0f)), glm::vec3(2.0f));
+  const glm::mat4 toModel = glm::inverse(world);
+  const ngn::Ray ray{glm::vec3(3.0f, 0.0f, 10.0f), glm::vec3(0.0f, 0.0f, -1.0f)};
+
+  // act
+  const ngn::Ray local{glm::vec3(toModel * glm::vec4(ray.origin, 1.0f)), glm::vec3(toModel * glm::vec4(ray.direction, 0.0f))};
+  ngn::MeshBvh::Hit hit = mesh.raycast(local, 100.0f);
+
+  // assert: the front of the scaled sphere is at z = 2, the polygon is slightly inside
+  REQUIRE(hit.triangle != ngn::Bvh::NO_ITEM);
+  CHECK(hit.t == doctest::Approx(8.0f).epsilon(0.01));
+}
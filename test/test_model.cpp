@@ -0,0 +1,47 @@
+#include "doctest.h"
+// common lib
+#include <model.hpp>
+//std
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+
+TEST_CASE("model bounds enclose every vertex") {
+  // arrange
+  const auto path = std::filesystem::temp_directory_path() / "ngn_test_bounds.obj";
+  {
+    std::ofstream obj{path};
+    obj << "v -1 0 0\nv 3 0 0\nv 1 2 0\nv 1 0 -4\n"
+        << "vt 0 0\n"
+        << "f 1/1 2/1 3/1\nf 1/1 2/1 4/1\n";
+  }
+
+  // act
+  Model model{path.string().c_str()};
+  std::filesystem::remove(path);
+
+  // assert
+  const ngn::Aabb &box = model.bounds();
+  CHECK(box.min.x == doctest::Approx(-1.0f));
+  CHECK(box.min.z == doctest::Approx(-4.0f));
+  CHECK(box.max.x == doctest::Approx(3.0f));
+  CHECK(box.max.y == doctest::Approx(2.0f));
+
+  const ngn::Sphere &sphere = model.boundingSphere();
+  CHECK(sphere.center.x == doctest::Approx(box.center().x));
+  for(size_t i = 0; i < model.verticesSize(); i++){
+    const glm::vec3 d = model.verticesData()[i].pos - sphere.center;
+    CHECK(std::sqrt(glm::dot(d, d)) <= sphere.radius + 1e-5f);
+  }
+  // tighter than the box half diagonal
+  const glm::vec3 half = box.extent();
+  CHECK(sphere.radius <= std::sqrt(glm::dot(half, half)) + 1e-5f);
+}
+
+TEST_CASE("axis model has bounds") {
+  const Model &axis = Model::axis();
+
+  CHECK(axis.bounds().valid());
+  CHECK(axis.bounds().max.x == doctest::Approx(1.0f));
+  CHECK(axis.boundingSphere().radius > 0.0f);
+}
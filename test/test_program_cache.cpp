@@ -0,0 +1,100 @@
+#include "doctest.h"
+// common lib
+#include <program_cache.hpp>
+//std
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+  const std::string DIRECTORY = (std::filesystem::temp_directory_path() / "test_program_cache").string();
+
+  std::vector<std::byte> binary(size_t size)
+  {
+    std::vector<std::byte> data(size);
+    for(size_t i = 0; i < size; i++){
+      data[i] = static_cast<std::byte>(i * 7);
+    }
+    return data;
+  }
+}
+
+TEST_CASE("ProgramCache loads back a stored binary") {
+  // arrange
+  ngn::ProgramCache cache{DIRECTORY, "vendor renderer 4.6"};
+  std::vector<std::vector<char>> sources{{'v', 'e', 'r', 't'}, {'f', 'r', 'a', 'g'}};
+  const uint64_t key = cache.key(sources);
+  const auto data = binary(1000);
+
+  // act
+  const bool stored = cache.store(key, 42, data);
+  auto loaded = cache.load(key);
+
+  // assert
+  CHECK(stored);
+  REQUIRE(loaded.has_value());
+  CHECK(loaded->format == 42);
+  CHECK(loaded->data == data);
+
+  std::filesystem::remove_all(DIRECTORY);
+}
+
+TEST_CASE("ProgramCache keys change with the sources and the driver") {
+  // arrange
+  ngn::ProgramCache cache{DIRECTORY, "vendor renderer 4.6"};
+  ngn::ProgramCache updated{DIRECTORY, "vendor renderer 4.6.1"};
+  std::vector<std::vector<char>> sources{{'a', 'b'}, {'c'}};
+  std::vector<std::vector<char>> split{{'a'}, {'b', 'c'}};
+
+  // act
+  const uint64_t key = cache.key(sources);
+
+  // assert
+  CHECK(key == cache.key(sources));
+  CHECK(key != cache.key(split));
+  CHECK(key != updated.key(sources));
+
+  std::filesystem::remove_all(DIRECTORY);
+}
+
+TEST_CASE("ProgramCache misses on invalid entries") {
+  // arrange
+  ngn::ProgramCache cache{DIRECTORY, "vendor renderer 4.6"};
+  const uint64_t key = 1234;
+  REQUIRE(cache.store(key, 1, binary(256)));
+
+  SUBCASE("missing entry") {
+    CHECK_FALSE(cache.load(key + 1).has_value());
+  }
+  SUBCASE("another driver") {
+    ngn::ProgramCache updated{DIRECTORY, "vendor renderer 4.7"};
+    CHECK_FALSE(updated.load(key).has_value());
+  }
+  SUBCASE("corrupted binary") {
+    const auto path = std::filesystem::path(DIRECTORY) / "00000000000004d2.bin";
+    REQUIRE(std::filesystem::exists(path));
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(-1, std::ios::end);
+    file.put('x');
+    file.close();
+    CHECK_FALSE(cache.load(key).has_value());
+  }
+  SUBCASE("truncated binary") {
+    const auto path = std::filesystem::path(DIRECTORY) / "00000000000004d2.bin";
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    CHECK_FALSE(cache.load(key).has_value());
+  }
+  SUBCASE("erased entry") {
+    cache.erase(key);
+    CHECK_FALSE(cache.load(key).has_value());
+  }
+  SUBCASE("cleared directory") {
+    ngn::ProgramCache::clear(DIRECTORY);
+    CHECK_FALSE(cache.load(key).has_value());
+    CHECK_FALSE(std::filesystem::exists(DIRECTORY));
+  }
+
+  std::filesystem::remove_all(DIRECTORY);
+}
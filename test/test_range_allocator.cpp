@@ -0,0 +1,59 @@
+#include "doctest.h"
+// common lib
+#include <range_allocator.hpp>
+
+TEST_CASE("RangeAllocator hands out ranges first fit") {
+  // arrange
+  ngn::RangeAllocator ranges{100};
+
+  // act
+  const uint32_t a = ranges.allocate(40);
+  const uint32_t b = ranges.allocate(40);
+  const uint32_t c = ranges.allocate(40);
+
+  // assert
+  CHECK(a == 0);
+  CHECK(b == 40);
+  CHECK(c == ngn::RangeAllocator::NO_RANGE);
+  CHECK(ranges.used() == 80);
+  CHECK(ranges.allocate(0) == ngn::RangeAllocator::NO_RANGE);
+}
+
+TEST_CASE("RangeAllocator merges freed neighbours") {
+  // arrange
+  ngn::RangeAllocator ranges{90};
+  const uint32_t a = ranges.allocate(30);
+  const uint32_t b = ranges.allocate(30);
+  const uint32_t c = ranges.allocate(30);
+
+  // act
+  ranges.free(a, 30);
+  ranges.free(c, 30);
+  ranges.free(b, 30);
+
+  // assert
+  CHECK(ranges.used() == 0);
+  CHECK(ranges.allocate(90) == 0);
+}
+
+TEST_CASE("RangeAllocator grow extends a free tail") {
+  // arrange
+  ngn::RangeAllocator ranges{50};
+  ranges.allocate(30);
+
+  // act
+  ranges.grow(100);
+
+  // assert
+  CHECK(ranges.capacity() == 100);
+  CHECK(ranges.used() == 30);
+  CHECK(ranges.allocate(70) == 30);
+
+  SUBCASE("never shrinks"){
+    // act
+    ranges.grow(10);
+
+    // assert
+    CHECK(ranges.capacity() == 100);
+  }
+}
@@ -0,0 +1,230 @@
+#include "doctest.h"
+// common lib
+#include <render_graph.hpp>
+
+using ngn::GraphUsage;
+using ngn::RenderGraph;
+
+TEST_CASE("RenderGraph culls the passes no output depends on") {
+  // arrange
+  RenderGraph graph{};
+  auto swapchain = graph.importResource("swapchain", GraphUsage::NONE, GraphUsage::PRESENT, true);
+  auto shadow = graph.createTransient("shadow");
+  auto unused = graph.createTransient("unused");
+  auto color = graph.createTransient("color");
+
+  auto shadowPass = graph.addPass("shadow");
+  graph.write(shadowPass, shadow, GraphUsage::DEPTH_ATTACHMENT);
+  auto debugPass = graph.addPass("debug");
+  graph.write(debugPass, unused, GraphUsage::COLOR_ATTACHMENT);
+  // overwritten by the scene pass before anything reads it
+  auto clearPass = graph.addPass("clear");
+  graph.write(clearPass, color, GraphUsage::TRANSFER_DST);
+  auto scenePass = graph.addPass("scene");
+  graph.read(scenePass, shadow, GraphUsage::SAMPLED);
+  graph.write(scenePass, color, GraphUsage::COLOR_ATTACHMENT);
+  auto blitPass = graph.addPass("blit");
+  graph.read(blitPass, color, GraphUsage::TRANSFER_SRC);
+  graph.write(blitPass, swapchain, GraphUsage::TRANSFER_DST);
+  auto markerPass = graph.addPass("marker", true);
+
+  // act
+  graph.compile();
+
+  // assert
+  CHECK_FALSE(graph.culled(shadowPass));
+  CHECK(graph.culled(debugPass));
+  CHECK(graph.culled(clearPass));
+  CHECK_FALSE(graph.culled(scenePass));
+  CHECK_FALSE(graph.culled(blitPass));
+  CHECK_FALSE(graph.culled(markerPass));
+  REQUIRE(graph.passes().size() == 4);
+  CHECK(graph.passes()[1].pass == scenePass);
+
+  // unused was only written by a culled pass
+  REQUIRE(graph.lifetimes().size() == 2);
+  CHECK(graph.lifetimes()[0].resource == shadow);
+  CHECK(graph.lifetimes()[0].first == 0);
+  CHECK(graph.lifetimes()[0].last == 1);
+  CHECK(graph.lifetimes()[1].resource == color);
+  CHECK(graph.lifetimes()[1].first == 1);
+  CHECK(graph.lifetimes()[1].last == 2);
+}
+
+TEST_CASE("RenderGraph emits a transition only on a usage change or a write") {
+  // arrange
+  RenderGraph graph{};
+  auto swapchain = graph.importResource("swapchain", GraphUsage::NONE, GraphUsage::PRESENT, true);
+  auto scene = graph.importResource("scene", GraphUsage::TRANSFER_SRC, GraphUsage::NONE, true);
+
+  auto scenePass = graph.addPass("scene");
+  graph.write(scenePass, scene, GraphUsage::COLOR_ATTACHMENT);
+  auto upscale = graph.addPass("upscale");
+  graph.read(upscale, scene, GraphUsage::TRANSFER_SRC);
+  graph.write(upscale, swapchain, GraphUsage::TRANSFER_DST);
+  // a second reader of the same usage shares the layout, blends into the upscaled image
+  auto copy = graph.addPass("copy");
+  graph.read(copy, scene, GraphUsage::TRANSFER_SRC);
+  graph.read(copy, swapchain, GraphUsage::TRANSFER_DST);
+  graph.write(copy, swapchain, GraphUsage::TRANSFER_DST);
+  auto ui = graph.addPass("ui");
+  graph.read(ui, swapchain, GraphUsage::COLOR_ATTACHMENT);
+  graph.write(ui, swapchain, GraphUsage::COLOR_ATTACHMENT);
+
+  // act
+  graph.compile();
+
+  // assert
+  const auto &passes = graph.passes();
+  REQUIRE(passes.size() == 4);
+
+  REQUIRE(passes[0].before.size() == 1);
+  CHECK(passes[0].before[0].from == GraphUsage::TRANSFER_SRC);
+  CHECK(passes[0].before[0].to == GraphUsage::COLOR_ATTACHMENT);
+  CHECK(passes[0].before[0].discard);
+
+  REQUIRE(passes[1].before.size() == 2);
+  CHECK(passes[1].before[0].fromWrite);
+  CHECK_FALSE(passes[1].before[0].discard);
+  CHECK(passes[1].before[1].from == GraphUsage::NONE);
+
+  // read after read: none for the scene, write after write on the swapchain
+  REQUIRE(passes[2].before.size() == 1);
+  CHECK(passes[2].before[0].resource == swapchain);
+  CHECK(passes[2].before[0].from == GraphUsage::TRANSFER_DST);
+  CHECK(passes[2].before[0].to == GraphUsage::TRANSFER_DST);
+
+  REQUIRE(passes[3].before.size() == 1);
+  CHECK(passes[3].before[0].toWrite);
+
+  REQUIRE(graph.finalTransitions().size() == 1);
+  CHECK(graph.finalTransitions()[0].from == GraphUsage::COLOR_ATTACHMENT);
+  CHECK(graph.finalTransitions()[0].to == GraphUsage::PRESENT);
+}
+
+TEST_CASE("RenderGraph rejects two usages of a resource in one pass") {
+  // arrange
+  RenderGraph graph{};
+  auto color = graph.createTransient("color");
+  auto pass = graph.addPass("pass");
+  graph.read(pass, color, GraphUsage::SAMPLED);
+
+  // act assert
+  CHECK_THROWS(graph.write(pass, color, GraphUsage::COLOR_ATTACHMENT));
+  CHECK_THROWS(graph.read(pass, 42, GraphUsage::SAMPLED));
+}
+
+TEST_CASE("RenderGraph aliases blocks of disjoint lifetimes") {
+  // arrange
+  const std::vector<RenderGraph::AliasBlock> blocks{
+    {0, 1, 1000, 256},
+    // overlaps the first one
+    {1, 2, 500, 256},
+    // after the first one
+    {2, 3, 800, 256},
+    {4, 4, 2000, 1024},
+  };
+  std::vector<uint64_t> offsets{};
+
+  // act
+  const uint64_t total = RenderGraph::alias(blocks, offsets);
+
+  // assert
+  REQUIRE(offsets.size() == blocks.size());
+  CHECK(offsets[3] == 0);
+  CHECK(offsets[0] == 0);
+  CHECK(offsets[2] == 0);
+  CHECK(offsets[1] == 1024);
+  CHECK(total == 2000);
+  for(size_t i = 0; i < offsets.size(); i++){
+    CHECK(offsets[i] % blocks[i].alignment == 0);
+  }
+}
+
+TEST_CASE("RenderGraph orders an aliased transient after the previous user of its memory") {
+  // arrange
+  RenderGraph graph{};
+  auto swapchain = graph.importResource("swapchain", GraphUsage::NONE, GraphUsage::PRESENT, true);
+  auto shadow = graph.createTransient("shadow");
+  auto bloom = graph.createTransient("bloom");
+
+  auto shadowPass = graph.addPass("shadow");
+  graph.write(shadowPass, shadow, GraphUsage::DEPTH_ATTACHMENT);
+  auto scenePass = graph.addPass("scene");
+  graph.read(scenePass, shadow, GraphUsage::SAMPLED);
+  graph.write(scenePass, swapchain, GraphUsage::COLOR_ATTACHMENT);
+  // bloom is first used after the last read of shadow and takes its memory
+  auto bloomPass = graph.addPass("bloom");
+  graph.write(bloomPass, bloom, GraphUsage::TRANSFER_DST);
+  auto compositePass = graph.addPass("composite");
+  graph.read(compositePass, bloom, GraphUsage::TRANSFER_SRC);
+  graph.read(compositePass, swapchain, GraphUsage::TRANSFER_DST);
+  graph.write(compositePass, swapchain, GraphUsage::TRANSFER_DST);
+  graph.compile();
+  const std::vector<RenderGraph::TransientMemory> transients{
+    {shadow, 0, 4096, 256},
+    {bloom, 0, 2048, 256},
+  };
+  std::vector<uint64_t> offsets{};
+
+  // act
+  const auto heapSizes = graph.placeTransients(transients, offsets);
+
+  // assert
+  REQUIRE(heapSizes.size() == 1);
+  CHECK(heapSizes[0] == 4096);
+  CHECK(offsets[0] == 0);
+  CHECK(offsets[1] == 0);
+
+  // the hand off comes before the layout transition of bloom
+  const auto &before = graph.passes()[2].before;
+  REQUIRE(before.size() == 2);
+  CHECK(before[0].aliasing);
+  CHECK(before[0].resource == shadow);
+  CHECK(before[0].from == GraphUsage::SAMPLED);
+  CHECK_FALSE(before[0].fromWrite);
+  CHECK(before[0].to == GraphUsage::TRANSFER_DST);
+  CHECK(before[0].toWrite);
+  CHECK_FALSE(before[1].aliasing);
+  CHECK(before[1].resource == bloom);
+  CHECK(before[1].discard);
+
+  // the first user of the memory waits for nothing
+  for(const auto &transition : graph.passes()[0].before){
+    CHECK_FALSE(transition.aliasing);
+  }
+}
+
+TEST_CASE("RenderGraph transients in different heaps never alias") {
+  // arrange
+  RenderGraph graph{};
+  auto output = graph.importResource("output", GraphUsage::NONE, GraphUsage::PRESENT, true);
+  auto first = graph.createTransient("first");
+  auto second = graph.createTransient("second");
+  auto firstPass = graph.addPass("first");
+  graph.write(firstPass, first, GraphUsage::COLOR_ATTACHMENT);
+  graph.write(firstPass, output, GraphUsage::COLOR_ATTACHMENT);
+  auto secondPass = graph.addPass("second");
+  graph.write(secondPass, second, GraphUsage::COLOR_ATTACHMENT);
+  graph.read(secondPass, output, GraphUsage::COLOR_ATTACHMENT);
+  graph.write(secondPass, output, GraphUsage::COLOR_ATTACHMENT);
+  graph.compile();
+  const std::vector<RenderGraph::TransientMemory> transients{
+    {first, 0, 1024, 256},
+    {second, 1, 1024, 256},
+  };
+  std::vector<uint64_t> offsets{};
+
+  // act
+  const auto heapSizes = graph.placeTransients(transients, offsets);
+
+  // assert
+  REQUIRE(heapSizes.size() == 2);
+  CHECK(heapSizes[0] == 1024);
+  CHECK(heapSizes[1] == 1024);
+  for(const auto &pass : graph.passes()){
+    for(const auto &transition : pass.before){
+      CHECK_FALSE(transition.aliasing);
+    }
+  }
+}
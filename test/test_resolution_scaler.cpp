@@ -0,0 +1,83 @@
+#include "doctest.h"
+// common lib
+#include <resolution_scaler.hpp>
+
+namespace
+{
+  // settle after every step, like a renderer reading the timings of each frame
+  float run(ngn::ResolutionScaler &scaler, float gpuMs, int frames)
+  {
+    float scale = scaler.scale();
+    for(int i = 0; i < frames; i++){
+      scale = scaler.update(gpuMs);
+    }
+    return scale;
+  }
+}
+
+TEST_CASE("ResolutionScaler keeps the full resolution without a target") {
+  // arrange
+  ngn::ResolutionScaler::setTargetFrameTime(0.f);
+  ngn::ResolutionScaler scaler{};
+
+  // act
+  const float scale = run(scaler, 100.f, 100);
+
+  // assert
+  CHECK(scale == doctest::Approx(1.0f));
+  CHECK(scaler.scaled(800, 600) == std::pair<uint32_t, uint32_t>{800, 600});
+}
+
+TEST_CASE("ResolutionScaler lowers the scale of a slow frame down to the minimum") {
+  // arrange
+  ngn::ResolutionScaler::setTargetFrameTime(10.f);
+  ngn::ResolutionScaler scaler{};
+
+  // act
+  const float first = scaler.update(20.f);
+  const float settled = run(scaler, 20.f, 8);
+  const float last = run(scaler, 20.f, 1000);
+
+  // assert
+  CHECK(first == doctest::Approx(0.95f));
+  CHECK(settled == doctest::Approx(0.95f));
+  CHECK(last == doctest::Approx(0.5f));
+  CHECK(scaler.scaled(800, 600) == std::pair<uint32_t, uint32_t>{400, 300});
+
+  ngn::ResolutionScaler::setTargetFrameTime(0.f);
+}
+
+TEST_CASE("ResolutionScaler goes up only when the larger size fits the target") {
+  // arrange
+  ngn::ResolutionScaler::setTargetFrameTime(10.f);
+  ngn::ResolutionScaler::Settings settings{};
+  settings.settleFrames = 0;
+  ngn::ResolutionScaler scaler{settings};
+  run(scaler, 40.f, 100);
+  REQUIRE(scaler.scale() == doctest::Approx(0.5f));
+
+  SUBCASE("time just under the target holds the scale") {
+    // (0.55 / 0.5)^2 = 1.21: 9 ms would become about 10.9 ms
+    CHECK(run(scaler, 9.f, 100) == doctest::Approx(0.5f));
+  }
+  SUBCASE("light frames recover the full resolution") {
+    CHECK(run(scaler, 2.f, 100) == doctest::Approx(1.0f));
+  }
+
+  ngn::ResolutionScaler::setTargetFrameTime(0.f);
+}
+
+TEST_CASE("ResolutionScaler ignores frames without timings") {
+  // arrange
+  ngn::ResolutionScaler::setTargetFrameTime(10.f);
+  ngn::ResolutionScaler scaler{};
+
+  // act
+  const float scale = run(scaler, 0.f, 100);
+
+  // assert
+  CHECK(scale == doctest::Approx(1.0f));
+  CHECK(scaler.scaled(0, 1) == std::pair<uint32_t, uint32_t>{1, 1});
+
+  ngn::ResolutionScaler::setTargetFrameTime(0.f);
+}
@@ -0,0 +1,49 @@
+#include "doctest.h"
+// common lib
+#include <ring_buffer.hpp>
+
+TEST_CASE("RingBuffer starts empty") {
+  // arrange
+  ngn::RingBuffer<float, 4> history{};
+
+  // assert
+  CHECK(history.empty());
+  CHECK(history.size() == 0);
+  CHECK(history.offset() == 0);
+  CHECK(history.capacity() == 4);
+}
+
+TEST_CASE("RingBuffer keeps the chronological order") {
+  // arrange
+  ngn::RingBuffer<float, 4> history{};
+
+  SUBCASE("while not full"){
+    // act
+    history.push(1.0f);
+    history.push(2.0f);
+
+    // assert
+    CHECK(history.size() == 2);
+    CHECK(history[0] == 1.0f);
+    CHECK(history[1] == 2.0f);
+    CHECK(history.latest() == 2.0f);
+    CHECK(history.offset() == 0);
+  }
+
+  SUBCASE("when full push overwrites the oldest value"){
+    // act
+    for(int i = 1; i <= 6; i++){
+      history.push(static_cast<float>(i));
+    }
+
+    // assert
+    REQUIRE(history.full());
+    CHECK(history.size() == 4);
+    CHECK(history[0] == 3.0f);
+    CHECK(history[3] == 6.0f);
+    CHECK(history.latest() == 6.0f);
+    // raw data read from offset wraps around in order
+    CHECK(history.data()[history.offset()] == 3.0f);
+    CHECK(history.data()[(history.offset() + 3) % 4] == 6.0f);
+  }
+}
@@ -0,0 +1,110 @@
+#include "doctest.h"
+// common lib
+#include <scene_file.hpp>
+#include <glsl_constants.h>
+//std
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+  const char *SCENE = R"({
+    "materials": [
+      {"name": "wood", "shader": "texture", "textures": [{"path": "data/textures/viking_room.png", "binding": 1}]},
+      {"name": "plain", "shader": "phong"}
+    ],
+    "nodes": [
+      {"name": "room", "model": "data/models/viking_room.obj", "up": "z", "material": "wood", "rotation": [0, 270, 0]},
+      {"name": "group", "parent": "room", "translation": [1, 2, 3]},
+      {"name": "ball", "model": "data/models/sphere/sphere_scaled.obj", "material": "plain", "parent": "group", "scale": [2, 2, 2]}
+    ]
+  })";
+}
+
+TEST_CASE("SceneFile compiles the json form") {
+  // act
+  ngn::SceneFile scene = ngn::SceneFile::fromJson(SCENE);
+
+  // assert
+  REQUIRE(scene.materials().size() == 2);
+  const ngn::SceneMaterial &wood = scene.materials()[0];
+  CHECK(scene.string(wood.name) == "wood");
+  CHECK(wood.shader == GLSL::TEXTURE);
+  CHECK(wood.polygonMode == GLSL::TRIANGLES);
+  REQUIRE(scene.textures(wood).size() == 1);
+  CHECK(scene.string(scene.textures(wood)[0].path) == "data/textures/viking_room.png");
+  CHECK(scene.textures(wood)[0].binding == 1);
+  CHECK(scene.textures(scene.materials()[1]).empty());
+
+  REQUIRE(scene.nodes().size() == 3);
+  const ngn::SceneNode &room = scene.nodes()[0];
+  const ngn::SceneNode &group = scene.nodes()[1];
+  const ngn::SceneNode &ball = scene.nodes()[2];
+  CHECK(room.parent == ngn::SCENE_NONE);
+  CHECK(room.up == 1);
+  CHECK(ngn::SceneFile::transform(room).R.y == doctest::Approx(270.0f));
+  CHECK(group.material == ngn::SCENE_NONE);
+  CHECK(scene.string(group.model).empty());
+  CHECK(group.parent == 0);
+  CHECK(ngn::SceneFile::transform(group).T.z == doctest::Approx(3.0f));
+  CHECK(ball.parent == 1);
+  CHECK(ball.material == 1);
+  CHECK(ngn::SceneFile::transform(ball).S.x == doctest::Approx(2.0f));
+}
+
+TEST_CASE("SceneFile binary form maps back to the same content") {
+  // arrange
+  ngn::SceneFile compiled = ngn::SceneFile::fromJson(SCENE);
+  const std::string path = (std::filesystem::temp_directory_path() / "test_scene_file.nscene").string();
+  compiled.save(path);
+
+  // act
+  ngn::SceneFile mapped = ngn::SceneFile::open(path);
+
+  // assert
+  CHECK(mapped.bytes().size() == compiled.bytes().size());
+  REQUIRE(mapped.nodes().size() == 3);
+  CHECK(mapped.string(mapped.nodes()[2].name) == "ball");
+  CHECK(mapped.string(mapped.nodes()[2].model) == "data/models/sphere/sphere_scaled.obj");
+  CHECK(mapped.nodes()[2].parent == 1);
+  CHECK(mapped.string(mapped.materials()[0].name) == "wood");
+
+  // unmapped before the file goes away
+  mapped = ngn::SceneFile{};
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("SceneFile rejects invalid scenes") {
+  SUBCASE("syntax error") {
+    CHECK_THROWS_AS(ngn::SceneFile::fromJson(R"({"nodes": [{"name": "a",}]})"), std::runtime_error);
+  }
+  SUBCASE("wrong type") {
+    CHECK_THROWS_AS(ngn::SceneFile::fromJson(R"({"nodes": [{"name": 1}]})"), std::runtime_error);
+  }
+  SUBCASE("texture binding not a non-negative integer") {
+    for(const char *binding : {"-1", "1.5", "4294967296", "\"1\""}){
+      const std::string json = std::string(R"({"materials": [{"name": "m", "shader": "texture", "textures": [{"path": "a.png", "binding": )") +
+                               binding + "}]}], \"nodes\": []}";
+      CHECK_THROWS_AS(ngn::SceneFile::fromJson(json), std::runtime_error);
+    }
+  }
+  SUBCASE("parent after the child") {
+    CHECK_THROWS_AS(ngn::SceneFile::fromJson(R"({"nodes": [{"name": "a", "parent": "b"}, {"name": "b"}]})"), std::runtime_error);
+  }
+  SUBCASE("unknown material") {
+    CHECK_THROWS_AS(ngn::SceneFile::fromJson(R"({"nodes": [{"name": "a", "model": "a.obj", "material": "none"}]})"), std::runtime_error);
+  }
+  SUBCASE("unknown shader") {
+    CHECK_THROWS_AS(ngn::SceneFile::fromJson(R"({"materials": [{"name": "m", "shader": "pbr"}], "nodes": []})"), std::runtime_error);
+  }
+  SUBCASE("truncated binary") {
+    ngn::SceneFile scene = ngn::SceneFile::fromJson(SCENE);
+    std::vector<std::byte> blob(scene.bytes().begin(), scene.bytes().end() - 1);
+    CHECK_THROWS_AS(ngn::SceneFile::fromBinary(std::move(blob)), std::runtime_error);
+  }
+  SUBCASE("not a scene") {
+    std::vector<std::byte> blob(64, std::byte{0});
+    CHECK_THROWS_AS(ngn::SceneFile::fromBinary(std::move(blob)), std::runtime_error);
+  }
+}
@@ -0,0 +1,120 @@
+#include "doctest.h"
+// common lib
+#include <scene_graph.hpp>
+//libs
+#include <glm/gtc/epsilon.hpp>
+#include <glm/ext/matrix_transform.hpp>
+
+namespace
+{
+  bool equal(const glm::mat4 &a, const glm::mat4 &b)
+  {
+    for(int c = 0; c < 4; c++){
+      if(!glm::all(glm::epsilonEqual(a[c], b[c], 1e-5f))){
+        return false;
+      }
+    }
+    return true;
+  }
+
+  Transformations moved(float x)
+  {
+    Transformations tra{};
+    tra.T = {x, 0.0f, 0.0f};
+    return tra;
+  }
+}
+
+TEST_CASE("SceneGraph world matrix is parent world times local") {
+  // arrange
+  ngn::SceneGraph scene{};
+  Transformations rotated{};
+  rotated.R = {0.0f, 90.0f, 0.0f};
+
+  ngn::NodeId root  = scene.create(ngn::NO_PARENT, rotated);
+  ngn::NodeId child = scene.create(root, moved(2.0f));
+  glm::mat4 up = glm::rotate(glm::mat4(1.0f), glm::radians(-90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+  ngn::NodeId mesh  = scene.createFixed(child, up);
+
+  // act
+  size_t updated = scene.update();
+
+  // assert
+  CHECK(updated == 3);
+  CHECK(equal(scene.world(root), ngn::SceneGraph::compose(rotated)));
+  CHECK(equal(scene.world(child), ngn::SceneGraph::compose(rotated) * ngn::SceneGraph::compose(moved(2.0f))));
+  CHECK(equal(scene.world(mesh), scene.world(child) * up));
+}
+
+TEST_CASE("SceneGraph update recomputes only the changed subtree") {
+  // arrange
+  ngn::SceneGraph scene{};
+  ngn::NodeId a  = scene.create(ngn::NO_PARENT, moved(1.0f));
+  ngn::NodeId a1 = scene.create(a, moved(1.0f));
+  ngn::NodeId b  = scene.create(ngn::NO_PARENT, moved(-1.0f));
+  ngn::NodeId b1 = scene.create(b, moved(-1.0f));
+  scene.update();
+
+  SUBCASE("nothing changed"){
+    // act
+    size_t updated = scene.update();
+
+    // assert
+    CHECK(updated == 0);
+    CHECK_FALSE(scene.changed(a));
+    CHECK_FALSE(scene.changed(b1));
+  }
+
+  SUBCASE("a parent changed"){
+    // act
+    scene.setTransform(a, moved(5.0f));
+    size_t updated = scene.update();
+
+    // assert
+    CHECK(updated == 2);
+    CHECK(scene.changed(a));
+    CHECK(scene.changed(a1));
+    CHECK_FALSE(scene.changed(b));
+    CHECK_FALSE(scene.changed(b1));
+    CHECK(scene.world(a1)[3].x == doctest::Approx(6.0f));
+  }
+
+  SUBCASE("a leaf changed"){
+    // act
+    scene.setTransform(b1, moved(-3.0f));
+    size_t updated = scene.update();
+
+    // assert
+    CHECK(updated == 1);
+    CHECK(scene.world(b1)[3].x == doctest::Approx(-4.0f));
+    CHECK(scene.getTransform(b1).T.x == doctest::Approx(-3.0f));
+  }
+}
+
+TEST_CASE("SceneGraph reuses released nodes after their parent") {
+  // arrange
+  ngn::SceneGraph scene{};
+  ngn::NodeId a  = scene.create(ngn::NO_PARENT, moved(1.0f));
+  ngn::NodeId a1 = scene.create(a, moved(1.0f));
+  ngn::NodeId b  = scene.create(ngn::NO_PARENT, moved(-1.0f));
+  ngn::NodeId b1 = scene.create(b, moved(-1.0f));
+  scene.update();
+
+  // act
+  scene.release(a1);
+  scene.release(a);
+  ngn::NodeId c  = scene.create(b1, moved(3.0f));
+  ngn::NodeId d  = scene.create(ngn::NO_PARENT, moved(2.0f));
+  ngn::NodeId d1 = scene.create(d, moved(2.0f));
+  size_t updated = scene.update();
+
+  // assert
+  // released slots before b1 can't hold its child
+  CHECK(c == 4);
+  CHECK(d == a);
+  CHECK(d1 == a1);
+  CHECK(scene.size() == 5);
+  CHECK(updated == 3);
+  CHECK(scene.world(c)[3].x == doctest::Approx(1.0f));
+  CHECK(scene.world(d1)[3].x == doctest::Approx(4.0f));
+}
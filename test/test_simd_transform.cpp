@@ -0,0 +1,157 @@
+#include "doctest.h"
+// common lib
+#include <scene_graph.hpp>
+#include <simd_transform.hpp>
+//libs
+#include <glm/gtc/epsilon.hpp>
+//std
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace
+{
+  bool equal(const glm::mat4 &a, const glm::mat4 &b, float eps = 1e-5f)
+  {
+    for(int c = 0; c < 4; c++){
+      if(!glm::all(glm::epsilonEqual(a[c], b[c], eps))){
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool equal(const glm::vec3 &a, const glm::vec3 &b, float eps = 1e-4f)
+  {
+    return glm::all(glm::epsilonEqual(glm::vec4(a, 0.0f), glm::vec4(b, 0.0f), eps));
+  }
+
+  // random nodes, count not a multiple of the simd width to cover the tail
+  std::vector<Transformations> randomNodes(size_t count)
+  {
+    std::mt19937 rng{7};
+    std::uniform_real_distribution<float> position{-10.0f, 10.0f};
+    std::uniform_real_distribution<float> angle{-720.0f, 720.0f};
+    std::uniform_real_distribution<float> scale{0.1f, 3.0f};
+
+    std::vector<Transformations> nodes(count);
+    for(auto &t : nodes){
+      t.T = {position(rng), position(rng), position(rng)};
+      t.R = {angle(rng), angle(rng), angle(rng)};
+      t.S = {scale(rng), scale(rng), scale(rng)};
+    }
+    return nodes;
+  }
+}
+
+TEST_CASE("simd composeTRS matches the scalar glm composition") {
+  // arrange
+  const size_t COUNT = 1003;
+  auto nodes = randomNodes(COUNT);
+
+  std::vector<float> channels[9];
+  for(auto &t : nodes){
+    const float values[9] = {t.T.x, t.T.y, t.T.z, t.R.x, t.R.y, t.R.z, t.S.x, t.S.y, t.S.z};
+    for(int c = 0; c < 9; c++){
+      channels[c].push_back(values[c]);
+    }
+  }
+  const ngn::simd::TrsArrays trs{
+    channels[0].data(), channels[1].data(), channels[2].data(),
+    channels[3].data(), channels[4].data(), channels[5].data(),
+    channels[6].data(), channels[7].data(), channels[8].data(),
+  };
+  std::vector<glm::mat4> matrices(COUNT);
+
+  // act
+  ngn::simd::composeTRS(trs, matrices.data(), COUNT);
+
+  // assert
+  INFO("isa = ", ngn::simd::isa());
+  size_t wrong = 0;
+  for(size_t i = 0; i < COUNT; i++){
+    wrong += !equal(matrices[i], ngn::SceneGraph::compose(nodes[i]), 1e-4f);
+  }
+  CHECK(wrong == 0);
+}
+
+TEST_CASE("simd multiply matches glm") {
+  // arrange
+  auto nodes = randomNodes(64);
+  std::vector<glm::mat4> a, b;
+  for(size_t i = 0; i + 1 < nodes.size(); i += 2){
+    a.push_back(ngn::SceneGraph::compose(nodes[i]));
+    b.push_back(ngn::SceneGraph::compose(nodes[i + 1]));
+  }
+  std::vector<glm::mat4> out(a.size());
+
+  // act
+  ngn::simd::multiply(a.data(), b.data(), out.data(), a.size());
+
+  // assert
+  for(size_t i = 0; i < a.size(); i++){
+    CHECK(equal(out[i], a[i] * b[i], 1e-3f));
+    CHECK(equal(ngn::simd::multiply(a[i], b[i]), a[i] * b[i], 1e-3f));
+  }
+}
+
+TEST_CASE("simd multiplyParents chains the hierarchy") {
+  // arrange
+  auto nodes = randomNodes(3);
+  const uint32_t parents[3] = {ngn::NO_PARENT, 0, 1};
+  std::vector<glm::mat4> locals{};
+  for(auto &t : nodes){
+    locals.push_back(ngn::SceneGraph::compose(t));
+  }
+  std::vector<glm::mat4> worlds(3);
+
+  // act
+  ngn::simd::multiplyParents(parents, locals.data(), worlds.data(), 3);
+
+  // assert
+  CHECK(equal(worlds[0], locals[0]));
+  CHECK(equal(worlds[2], locals[0] * locals[1] * locals[2], 1e-2f));
+}
+
+TEST_CASE("simd bounds kernels match the scalar transform") {
+  // arrange
+  auto nodes = randomNodes(17);
+  std::vector<glm::mat4> matrices{};
+  std::vector<ngn::Sphere> spheres{};
+  std::vector<ngn::Aabb> boxes{};
+  for(auto &t : nodes){
+    matrices.push_back(ngn::SceneGraph::compose(t));
+    spheres.push_back(ngn::Sphere{t.T * 0.1f, 0.5f});
+    boxes.push_back(ngn::Aabb{t.T * 0.1f - glm::vec3(0.5f), t.T * 0.1f + glm::vec3(1.0f)});
+  }
+  std::vector<ngn::Sphere> worldSpheres(nodes.size());
+  std::vector<ngn::Aabb> worldBoxes(nodes.size());
+
+  // act
+  ngn::simd::transformSpheres(matrices.data(), spheres.data(), worldSpheres.data(), nodes.size());
+  ngn::simd::transformAabbs(matrices.data(), boxes.data(), worldBoxes.data(), nodes.size());
+
+  // assert
+  for(size_t i = 0; i < nodes.size(); i++){
+    const glm::mat4 &m = matrices[i];
+    const float maxScale = std::max({nodes[i].S.x, nodes[i].S.y, nodes[i].S.z});
+    CHECK(equal(worldSpheres[i].center, glm::vec3(m * glm::vec4(spheres[i].center, 1.0f))));
+    CHECK(worldSpheres[i].radius == doctest::Approx(spheres[i].radius * maxScale).epsilon(1e-4));
+
+    // every corner of the box is inside the world box
+    for(int corner = 0; corner < 8; corner++){
+      glm::vec3 p{
+        corner & 1 ? boxes[i].max.x : boxes[i].min.x,
+        corner & 2 ? boxes[i].max.y : boxes[i].min.y,
+        corner & 4 ? boxes[i].max.z : boxes[i].min.z,
+      };
+      glm::vec3 w = glm::vec3(m * glm::vec4(p, 1.0f));
+      CHECK(w.x >= worldBoxes[i].min.x - 1e-3f);
+      CHECK(w.y >= worldBoxes[i].min.y - 1e-3f);
+      CHECK(w.z >= worldBoxes[i].min.z - 1e-3f);
+      CHECK(w.x <= worldBoxes[i].max.x + 1e-3f);
+      CHECK(w.y <= worldBoxes[i].max.y + 1e-3f);
+      CHECK(w.z <= worldBoxes[i].max.z + 1e-3f);
+    }
+  }
+}
@@ -0,0 +1,81 @@
+#include "doctest.h"
+// common lib
+#include <triple_buffer.hpp>
+//std
+#include <thread>
+
+TEST_CASE("TripleBuffer acquire without publish returns false") {
+  // arrange
+  ngn::TripleBuffer<int> buffer{};
+
+  // assert
+  CHECK(buffer.acquire() == false);
+}
+
+TEST_CASE("TripleBuffer reader gets the latest published value") {
+  // arrange
+  ngn::TripleBuffer<int> buffer{};
+
+  SUBCASE("single publish"){
+    // act
+    buffer.writeBuffer() = 1;
+    buffer.publish();
+
+    // assert
+    REQUIRE(buffer.acquire());
+    CHECK(buffer.readBuffer() == 1);
+    CHECK(buffer.acquire() == false);
+    CHECK(buffer.readBuffer() == 1);
+  }
+
+  SUBCASE("unread values are overwritten"){
+    // act
+    buffer.writeBuffer() = 1;
+    buffer.publish();
+    buffer.writeBuffer() = 2;
+    buffer.publish();
+
+    // assert
+    REQUIRE(buffer.acquire());
+    CHECK(buffer.readBuffer() == 2);
+  }
+
+  SUBCASE("writer never gets the buffer being read"){
+    // act
+    buffer.writeBuffer() = 1;
+    buffer.publish();
+    REQUIRE(buffer.acquire());
+    buffer.writeBuffer() = 2;
+    buffer.publish();
+    buffer.writeBuffer() = 3;
+
+    // assert
+    CHECK(buffer.readBuffer() == 1);
+  }
+}
+
+TEST_CASE("TripleBuffer values arrive in order across threads") {
+  // arrange
+  ngn::TripleBuffer<int> buffer{};
+  const int count = 10000;
+  bool ordered = true;
+
+  // act
+  std::thread reader([&]{
+    int last = 0;
+    while(last != count){
+      if(buffer.acquire()){
+        ordered = ordered && (buffer.readBuffer() > last);
+        last = buffer.readBuffer();
+      }
+    }
+  });
+  for(int i = 1; i <= count; i++){
+    buffer.writeBuffer() = i;
+    buffer.publish();
+  }
+  reader.join();
+
+  // assert
+  CHECK(ordered);
+}